@@ -0,0 +1,542 @@
+#include "animation.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Taxa usada quando o arquivo não informa os ticks por segundo da animação.
+ */
+static const double DEFAULT_TICKS_PER_SECOND = 25.0;
+
+/**
+ * @brief Maior componente de um quaternion unitário que não é a maior em módulo (1/√2).
+ */
+static const float SMALLEST_THREE_RANGE = 0.70710678f;
+
+/**
+ * @brief Valor máximo de cada componente de 15 bits do formato "smallest three".
+ */
+static const float SMALLEST_THREE_MAX = 32767.0f;
+
+size_t AnimationClip::memoryBytes() const
+{
+    return tracks.size() * sizeof(AnimationTrack) +
+           (positionTimes.size() + rotationTimes.size() + scaleTimes.size()) * sizeof(float) +
+           (positionKeys.size() + scaleKeys.size()) * sizeof(aiVector3D) + rotationKeys.size() * sizeof(aiQuaternion);
+}
+
+size_t CompressedAnimationClip::memoryBytes() const
+{
+    return tracks.size() * sizeof(CompressedAnimationTrack) +
+           (positionTimes.size() + rotationTimes.size() + scaleTimes.size()) * sizeof(float) +
+           (positionKeys.size() + rotationKeys.size() + scaleKeys.size()) * sizeof(uint16_t);
+}
+
+void AnimationCursor::reset(size_t trackCount)
+{
+    time = 0.0f;
+    keys.assign(trackCount * 3, 0);
+}
+
+bool advanceAnimation(AnimationPlayback &playback, float duration, float deltaTime)
+{
+    float time = playback.time + deltaTime;
+    if (time > duration)
+        time = playback.loop && duration > 0.0f ? std::fmod(time, duration) : duration;
+    if (time == playback.time)
+        return false;
+    playback.time = time;
+    return true;
+}
+
+/**
+ * @brief Copia as chaves de um canal do Assimp para os arrays do clip, convertendo ticks para segundos.
+ */
+template <typename Key, typename Value>
+static KeyRange appendKeys(const Key *source, unsigned int count, double secondsPerTick, std::vector<float> &times,
+                           std::vector<Value> &values)
+{
+    KeyRange range;
+    range.offset = static_cast<uint32_t>(times.size());
+    range.count = 0;
+    for (unsigned int k = 0; k < count; k++)
+    {
+        float time = static_cast<float>(source[k].mTime * secondsPerTick);
+
+        // Chaves fora de ordem ou repetidas quebrariam o avanço do cursor; mantém só a última de cada instante
+        if (range.count > 0 && time <= times.back())
+        {
+            if (time < times.back())
+                continue;
+            values.back() = source[k].mValue;
+            continue;
+        }
+        times.push_back(time);
+        values.push_back(source[k].mValue);
+        range.count++;
+    }
+    return range;
+}
+
+size_t importAnimationClip(const aiAnimation *animation, const BoneNameTable &boneNames, AnimationClip &clip)
+{
+    double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : DEFAULT_TICKS_PER_SECOND;
+    double secondsPerTick = 1.0 / ticksPerSecond;
+
+    clip = AnimationClip();
+    clip.name.assign(animation->mName.C_Str(), animation->mName.length);
+    clip.duration = static_cast<float>(animation->mDuration * secondsPerTick);
+
+    // Ordena os canais pelo índice do bone, de forma que a amostragem grave os bones em ordem crescente
+    std::vector<std::pair<int, const aiNodeAnim *>> channels;
+    size_t skipped = 0;
+    for (unsigned int c = 0; c < animation->mNumChannels; c++)
+    {
+        const aiNodeAnim *channel = animation->mChannels[c];
+        int bone = boneNames.find(std::string_view(channel->mNodeName.C_Str(), channel->mNodeName.length));
+        if (bone < 0)
+            skipped++;
+        else
+            channels.emplace_back(bone, channel);
+    }
+    std::stable_sort(channels.begin(), channels.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    for (const auto &entry : channels)
+    {
+        // Um bone com dois canais (nós duplicados) fica apenas com o primeiro
+        if (!clip.tracks.empty() && clip.tracks.back().bone == entry.first)
+        {
+            skipped++;
+            continue;
+        }
+
+        const aiNodeAnim *channel = entry.second;
+        AnimationTrack track;
+        track.bone = entry.first;
+        track.position = appendKeys(channel->mPositionKeys, channel->mNumPositionKeys, secondsPerTick,
+                                    clip.positionTimes, clip.positionKeys);
+        track.rotation = appendKeys(channel->mRotationKeys, channel->mNumRotationKeys, secondsPerTick,
+                                    clip.rotationTimes, clip.rotationKeys);
+        track.scale = appendKeys(channel->mScalingKeys, channel->mNumScalingKeys, secondsPerTick, clip.scaleTimes,
+                                 clip.scaleKeys);
+        clip.tracks.push_back(track);
+    }
+    return skipped;
+}
+
+/**
+ * @brief Avança a chave corrente de um canal até o intervalo que contém o tempo.
+ * @param times Tempos das chaves do canal.
+ * @param count Quantidade de chaves.
+ * @param key Chave corrente, atualizada para a última chave com tempo menor ou igual a time.
+ * @param time Tempo amostrado.
+ * @return Fator de interpolação entre key e key + 1.
+ */
+static inline float advanceKey(const float *times, uint32_t count, uint32_t &key, float time)
+{
+    uint32_t k = key;
+    while (k + 1 < count && times[k + 1] <= time)
+        k++;
+    key = k;
+    if (k + 1 >= count)
+        return 0.0f;
+
+    float span = times[k + 1] - times[k];
+    float t = (time - times[k]) / span;
+    return t < 0.0f ? 0.0f : t;
+}
+
+static inline aiVector3D lerp(const aiVector3D &a, const aiVector3D &b, float t)
+{
+    return aiVector3D(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t);
+}
+
+/**
+ * @brief Interpolação linear normalizada pelo menor arco.
+ */
+static inline aiQuaternion nlerp(const aiQuaternion &a, const aiQuaternion &b, float t)
+{
+    float dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+    float s = dot < 0.0f ? -t : t;
+    float r = 1.0f - t;
+    aiQuaternion q(r * a.w + s * b.w, r * a.x + s * b.x, r * a.y + s * b.y, r * a.z + s * b.z);
+    float length = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    if (length > 0.0f)
+    {
+        float inv = 1.0f / length;
+        q.w *= inv;
+        q.x *= inv;
+        q.y *= inv;
+        q.z *= inv;
+    }
+    return q;
+}
+
+void sampleAnimationClip(const AnimationClip &clip, float time, AnimationCursor &cursor, LocalPose &pose)
+{
+    // Voltar no tempo (loop ou cursor novo) reinicia todos os canais; nos demais casos eles só avançam
+    if (cursor.keys.size() != clip.tracks.size() * 3 || time < cursor.time)
+        cursor.reset(clip.tracks.size());
+    cursor.time = time;
+
+    uint32_t *keys = cursor.keys.data();
+    for (const AnimationTrack &track : clip.tracks)
+    {
+        size_t bone = track.bone;
+        if (track.position.count > 0)
+        {
+            const float *times = clip.positionTimes.data() + track.position.offset;
+            const aiVector3D *values = clip.positionKeys.data() + track.position.offset;
+            float t = advanceKey(times, track.position.count, keys[0], time);
+            aiVector3D position = t > 0.0f ? lerp(values[keys[0]], values[keys[0] + 1], t) : values[keys[0]];
+            pose.tx[bone] = position.x;
+            pose.ty[bone] = position.y;
+            pose.tz[bone] = position.z;
+        }
+
+        if (track.rotation.count > 0)
+        {
+            const float *times = clip.rotationTimes.data() + track.rotation.offset;
+            const aiQuaternion *values = clip.rotationKeys.data() + track.rotation.offset;
+            float t = advanceKey(times, track.rotation.count, keys[1], time);
+            pose.setRotation(bone, t > 0.0f ? nlerp(values[keys[1]], values[keys[1] + 1], t) : values[keys[1]]);
+        }
+
+        if (track.scale.count > 0)
+        {
+            const float *times = clip.scaleTimes.data() + track.scale.offset;
+            const aiVector3D *values = clip.scaleKeys.data() + track.scale.offset;
+            float t = advanceKey(times, track.scale.count, keys[2], time);
+            aiVector3D scale = t > 0.0f ? lerp(values[keys[2]], values[keys[2] + 1], t) : values[keys[2]];
+            pose.sx[bone] = scale.x;
+            pose.sy[bone] = scale.y;
+            pose.sz[bone] = scale.z;
+        }
+        keys += 3;
+    }
+}
+
+/**
+ * @brief Quantiza um valor em 16 bits dentro de [offset, offset + 65535 * scale].
+ */
+static inline uint16_t quantizeUnorm16(float value, float offset, float scale)
+{
+    if (scale <= 0.0f)
+        return 0;
+    float q = std::round((value - offset) / scale);
+    return static_cast<uint16_t>(std::min(65535.0f, std::max(0.0f, q)));
+}
+
+static inline aiVector3D decodeVector(const uint16_t *q, const float *offset, const float *scale)
+{
+    return aiVector3D(offset[0] + q[0] * scale[0], offset[1] + q[1] * scale[1], offset[2] + q[2] * scale[2]);
+}
+
+/**
+ * @brief Calcula o intervalo de quantização das chaves de um canal vetorial.
+ */
+static void vectorRange(const aiVector3D *values, uint32_t count, float *offset, float *scale)
+{
+    for (int c = 0; c < 3; c++)
+    {
+        float low = count > 0 ? (&values[0].x)[c] : 0.0f;
+        float high = low;
+        for (uint32_t k = 1; k < count; k++)
+        {
+            low = std::min(low, (&values[k].x)[c]);
+            high = std::max(high, (&values[k].x)[c]);
+        }
+        offset[c] = low;
+        scale[c] = (high - low) / 65535.0f;
+    }
+}
+
+static inline void encodeVector(const aiVector3D &value, const float *offset, const float *scale, uint16_t *q)
+{
+    q[0] = quantizeUnorm16(value.x, offset[0], scale[0]);
+    q[1] = quantizeUnorm16(value.y, offset[1], scale[1]);
+    q[2] = quantizeUnorm16(value.z, offset[2], scale[2]);
+}
+
+static inline aiQuaternion normalized(const aiQuaternion &q)
+{
+    float length = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    float inv = length > 0.0f ? 1.0f / length : 0.0f;
+    return length > 0.0f ? aiQuaternion(q.w * inv, q.x * inv, q.y * inv, q.z * inv) : aiQuaternion();
+}
+
+/**
+ * @brief Codifica um quaternion em 48 bits: as três menores componentes com 15 bits cada e o índice da
+ * maior nos bits altos das duas primeiras palavras.
+ *
+ * O quaternion é invertido quando a maior componente é negativa (q e -q representam a mesma rotação),
+ * de forma que a componente omitida é sempre positiva.
+ */
+static void encodeQuaternion(const aiQuaternion &rotation, uint16_t *q)
+{
+    aiQuaternion unit = normalized(rotation);
+    float components[4] = {unit.w, unit.x, unit.y, unit.z};
+    int largest = 0;
+    for (int c = 1; c < 4; c++)
+    {
+        if (std::fabs(components[c]) > std::fabs(components[largest]))
+            largest = c;
+    }
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint16_t packed[3];
+    for (int c = 0, n = 0; c < 4; c++)
+    {
+        if (c == largest)
+            continue;
+        float value = sign * components[c] / SMALLEST_THREE_RANGE * 0.5f + 0.5f;
+        packed[n++] = static_cast<uint16_t>(std::round(std::min(1.0f, std::max(0.0f, value)) * SMALLEST_THREE_MAX));
+    }
+    q[0] = packed[0] | static_cast<uint16_t>((largest >> 1) << 15);
+    q[1] = packed[1] | static_cast<uint16_t>((largest & 1) << 15);
+    q[2] = packed[2];
+}
+
+static inline aiQuaternion decodeQuaternion(const uint16_t *q)
+{
+    int largest = ((q[0] >> 15) << 1) | (q[1] >> 15);
+    float small[3];
+    for (int n = 0; n < 3; n++)
+        small[n] = ((q[n] & 0x7fff) / SMALLEST_THREE_MAX * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+
+    float components[4];
+    float sum = small[0] * small[0] + small[1] * small[1] + small[2] * small[2];
+    for (int c = 0, n = 0; c < 4; c++)
+        components[c] = c == largest ? std::sqrt(std::max(0.0f, 1.0f - sum)) : small[n++];
+    return aiQuaternion(components[0], components[1], components[2], components[3]);
+}
+
+static inline float vectorDistance(const aiVector3D &a, const aiVector3D &b)
+{
+    float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+static inline float vectorMaxDifference(const aiVector3D &a, const aiVector3D &b)
+{
+    return std::max(std::fabs(a.x - b.x), std::max(std::fabs(a.y - b.y), std::fabs(a.z - b.z)));
+}
+
+/**
+ * @brief Ângulo, em radianos, da rotação entre dois quaternions unitários.
+ */
+static inline float quaternionAngle(const aiQuaternion &a, const aiQuaternion &b)
+{
+    float dot = std::fabs(a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z);
+    return 2.0f * std::acos(std::min(1.0f, dot));
+}
+
+/**
+ * @brief Escolhe as chaves de um canal que precisam ser mantidas.
+ *
+ * A partir da última chave mantida, o segmento é estendido enquanto a interpolação entre suas
+ * extremidades (com os valores decodificados) reproduz todas as chaves intermediárias dentro da
+ * tolerância.
+ *
+ * @param times Tempos das chaves.
+ * @param values Valores originais.
+ * @param decoded Valores após a quantização.
+ * @param count Quantidade de chaves.
+ * @param tolerance Erro máximo aceito.
+ * @param interpolate Interpolação usada na amostragem.
+ * @param error Medida do erro entre dois valores.
+ * @param kept Índices das chaves mantidas, em ordem.
+ */
+template <typename T, typename Interpolate, typename Error>
+static void reduceKeys(const float *times, const T *values, const T *decoded, uint32_t count, float tolerance,
+                       Interpolate interpolate, Error error, std::vector<uint32_t> &kept)
+{
+    kept.clear();
+    if (count == 0)
+        return;
+
+    // Canal constante: uma única chave vale para o clip inteiro
+    bool constant = true;
+    for (uint32_t k = 1; k < count && constant; k++)
+        constant = error(decoded[0], values[k]) <= tolerance;
+    kept.push_back(0);
+    if (constant)
+        return;
+
+    uint32_t start = 0;
+    for (uint32_t end = start + 2; end < count; end++)
+    {
+        bool reproduced = true;
+        for (uint32_t k = start + 1; k < end && reproduced; k++)
+        {
+            float t = (times[k] - times[start]) / (times[end] - times[start]);
+            reproduced = error(interpolate(decoded[start], decoded[end], t), values[k]) <= tolerance;
+        }
+        if (!reproduced)
+        {
+            start = end - 1;
+            kept.push_back(start);
+        }
+    }
+    kept.push_back(count - 1);
+}
+
+void compressAnimationClip(const AnimationClip &clip, const AnimationCompressionSettings &settings,
+                           CompressedAnimationClip &compressed)
+{
+    compressed = CompressedAnimationClip();
+    compressed.name = clip.name;
+    compressed.duration = clip.duration;
+
+    std::vector<aiVector3D> decodedVectors;
+    std::vector<aiQuaternion> rotations, decodedRotations;
+    std::vector<uint16_t> encoded;
+    std::vector<uint32_t> kept;
+    auto keepKeys = [&](const float *times, const uint16_t *keys, KeyRange &range, std::vector<float> &outTimes,
+                        std::vector<uint16_t> &outKeys)
+    {
+        range.offset = static_cast<uint32_t>(outTimes.size());
+        range.count = static_cast<uint32_t>(kept.size());
+        for (uint32_t k : kept)
+        {
+            outTimes.push_back(times[k]);
+            outKeys.insert(outKeys.end(), keys + k * 3, keys + k * 3 + 3);
+        }
+    };
+
+    for (const AnimationTrack &track : clip.tracks)
+    {
+        CompressedAnimationTrack out;
+        out.bone = track.bone;
+
+        // Posições: quantizadas no intervalo do canal, erro pela distância
+        const float *times = clip.positionTimes.data() + track.position.offset;
+        const aiVector3D *positions = clip.positionKeys.data() + track.position.offset;
+        vectorRange(positions, track.position.count, out.positionOffset, out.positionScale);
+        encoded.resize(track.position.count * 3);
+        decodedVectors.resize(track.position.count);
+        for (uint32_t k = 0; k < track.position.count; k++)
+        {
+            encodeVector(positions[k], out.positionOffset, out.positionScale, &encoded[k * 3]);
+            decodedVectors[k] = decodeVector(&encoded[k * 3], out.positionOffset, out.positionScale);
+        }
+        reduceKeys(times, positions, decodedVectors.data(), track.position.count, settings.positionTolerance, lerp,
+                   vectorDistance, kept);
+        keepKeys(times, encoded.data(), out.position, compressed.positionTimes, compressed.positionKeys);
+
+        // Rotações: "smallest three", erro pelo ângulo entre os quaternions
+        times = clip.rotationTimes.data() + track.rotation.offset;
+        rotations.resize(track.rotation.count);
+        encoded.resize(track.rotation.count * 3);
+        decodedRotations.resize(track.rotation.count);
+        for (uint32_t k = 0; k < track.rotation.count; k++)
+        {
+            rotations[k] = normalized(clip.rotationKeys[track.rotation.offset + k]);
+            encodeQuaternion(rotations[k], &encoded[k * 3]);
+            decodedRotations[k] = decodeQuaternion(&encoded[k * 3]);
+        }
+        reduceKeys(times, rotations.data(), decodedRotations.data(), track.rotation.count, settings.rotationTolerance,
+                   nlerp, quaternionAngle, kept);
+        keepKeys(times, encoded.data(), out.rotation, compressed.rotationTimes, compressed.rotationKeys);
+
+        // Escalas: como as posições, com o erro medido em cada eixo
+        times = clip.scaleTimes.data() + track.scale.offset;
+        const aiVector3D *scales = clip.scaleKeys.data() + track.scale.offset;
+        vectorRange(scales, track.scale.count, out.scaleOffset, out.scaleScale);
+        encoded.resize(track.scale.count * 3);
+        decodedVectors.resize(track.scale.count);
+        for (uint32_t k = 0; k < track.scale.count; k++)
+        {
+            encodeVector(scales[k], out.scaleOffset, out.scaleScale, &encoded[k * 3]);
+            decodedVectors[k] = decodeVector(&encoded[k * 3], out.scaleOffset, out.scaleScale);
+        }
+        reduceKeys(times, scales, decodedVectors.data(), track.scale.count, settings.scaleTolerance, lerp,
+                   vectorMaxDifference, kept);
+        keepKeys(times, encoded.data(), out.scale, compressed.scaleTimes, compressed.scaleKeys);
+
+        compressed.tracks.push_back(out);
+    }
+}
+
+void decompressAnimationClip(const CompressedAnimationClip &compressed, AnimationClip &clip)
+{
+    clip = AnimationClip();
+    clip.name = compressed.name;
+    clip.duration = compressed.duration;
+    clip.positionTimes = compressed.positionTimes;
+    clip.rotationTimes = compressed.rotationTimes;
+    clip.scaleTimes = compressed.scaleTimes;
+    clip.positionKeys.resize(compressed.positionTimes.size());
+    clip.rotationKeys.resize(compressed.rotationTimes.size());
+    clip.scaleKeys.resize(compressed.scaleTimes.size());
+
+    for (const CompressedAnimationTrack &track : compressed.tracks)
+    {
+        clip.tracks.push_back({track.bone, track.position, track.rotation, track.scale});
+        for (uint32_t k = track.position.offset; k < track.position.offset + track.position.count; k++)
+        {
+            clip.positionKeys[k] = decodeVector(&compressed.positionKeys[k * 3], track.positionOffset,
+                                                track.positionScale);
+        }
+        for (uint32_t k = track.rotation.offset; k < track.rotation.offset + track.rotation.count; k++)
+            clip.rotationKeys[k] = decodeQuaternion(&compressed.rotationKeys[k * 3]);
+        for (uint32_t k = track.scale.offset; k < track.scale.offset + track.scale.count; k++)
+            clip.scaleKeys[k] = decodeVector(&compressed.scaleKeys[k * 3], track.scaleOffset, track.scaleScale);
+    }
+}
+
+void sampleAnimationClip(const CompressedAnimationClip &clip, float time, AnimationCursor &cursor, LocalPose &pose)
+{
+    if (cursor.keys.size() != clip.tracks.size() * 3 || time < cursor.time)
+        cursor.reset(clip.tracks.size());
+    cursor.time = time;
+
+    uint32_t *keys = cursor.keys.data();
+    for (const CompressedAnimationTrack &track : clip.tracks)
+    {
+        size_t bone = track.bone;
+        if (track.position.count > 0)
+        {
+            const float *times = clip.positionTimes.data() + track.position.offset;
+            const uint16_t *values = clip.positionKeys.data() + track.position.offset * 3;
+            float t = advanceKey(times, track.position.count, keys[0], time);
+            aiVector3D position = decodeVector(values + keys[0] * 3, track.positionOffset, track.positionScale);
+            if (t > 0.0f)
+            {
+                aiVector3D next = decodeVector(values + keys[0] * 3 + 3, track.positionOffset, track.positionScale);
+                position = lerp(position, next, t);
+            }
+            pose.tx[bone] = position.x;
+            pose.ty[bone] = position.y;
+            pose.tz[bone] = position.z;
+        }
+
+        if (track.rotation.count > 0)
+        {
+            const float *times = clip.rotationTimes.data() + track.rotation.offset;
+            const uint16_t *values = clip.rotationKeys.data() + track.rotation.offset * 3;
+            float t = advanceKey(times, track.rotation.count, keys[1], time);
+            aiQuaternion rotation = decodeQuaternion(values + keys[1] * 3);
+            if (t > 0.0f)
+                rotation = nlerp(rotation, decodeQuaternion(values + keys[1] * 3 + 3), t);
+            pose.setRotation(bone, rotation);
+        }
+
+        if (track.scale.count > 0)
+        {
+            const float *times = clip.scaleTimes.data() + track.scale.offset;
+            const uint16_t *values = clip.scaleKeys.data() + track.scale.offset * 3;
+            float t = advanceKey(times, track.scale.count, keys[2], time);
+            aiVector3D scale = decodeVector(values + keys[2] * 3, track.scaleOffset, track.scaleScale);
+            if (t > 0.0f)
+            {
+                aiVector3D next = decodeVector(values + keys[2] * 3 + 3, track.scaleOffset, track.scaleScale);
+                scale = lerp(scale, next, t);
+            }
+            pose.sx[bone] = scale.x;
+            pose.sy[bone] = scale.y;
+            pose.sz[bone] = scale.z;
+        }
+        keys += 3;
+    }
+}
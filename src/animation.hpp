@@ -0,0 +1,206 @@
+#ifndef ANIMATION_HPP
+#define ANIMATION_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <assimp/scene.h>
+#include "bonenametable.hpp"
+#include "localpose.hpp"
+
+/**
+ * @brief Intervalo das chaves de um canal nos arrays do clip.
+ */
+struct KeyRange
+{
+    uint32_t offset; ///< Primeira chave do canal.
+    uint32_t count;  ///< Quantidade de chaves (0 mantém o valor da bind pose).
+};
+
+/**
+ * @brief Canais de posição, rotação e escala de um bone em um clip.
+ */
+struct AnimationTrack
+{
+    int32_t bone;      ///< Índice do bone animado.
+    KeyRange position; ///< Chaves em AnimationClip::positionTimes/positionKeys.
+    KeyRange rotation; ///< Chaves em AnimationClip::rotationTimes/rotationKeys.
+    KeyRange scale;    ///< Chaves em AnimationClip::scaleTimes/scaleKeys.
+};
+
+/**
+ * @brief Clip de animação com as chaves de todos os bones em arrays contíguos por tipo de canal.
+ *
+ * Os tempos ficam separados dos valores, de forma que o avanço do cursor percorre apenas floats.
+ */
+struct AnimationClip
+{
+    std::string name;                       ///< Nome do clip no modelo.
+    float duration;                         ///< Duração em segundos.
+    std::vector<AnimationTrack> tracks;     ///< Canais dos bones animados, ordenados pelo índice do bone.
+    std::vector<float> positionTimes;       ///< Tempo, em segundos, de cada chave de posição.
+    std::vector<aiVector3D> positionKeys;   ///< Valor de cada chave de posição.
+    std::vector<float> rotationTimes;       ///< Tempo, em segundos, de cada chave de rotação.
+    std::vector<aiQuaternion> rotationKeys; ///< Valor de cada chave de rotação.
+    std::vector<float> scaleTimes;          ///< Tempo, em segundos, de cada chave de escala.
+    std::vector<aiVector3D> scaleKeys;      ///< Valor de cada chave de escala.
+
+    /**
+     * @brief Bytes ocupados pelos canais e chaves.
+     */
+    size_t memoryBytes() const;
+};
+
+/**
+ * @brief Canais de um bone em um clip compactado, com os intervalos de quantização de posição e escala.
+ *
+ * Cada coordenada é decodificada como offset + q * scale, com q de 16 bits.
+ */
+struct CompressedAnimationTrack
+{
+    int32_t bone;            ///< Índice do bone animado.
+    KeyRange position;       ///< Chaves em CompressedAnimationClip::positionTimes/positionKeys.
+    KeyRange rotation;       ///< Chaves em CompressedAnimationClip::rotationTimes/rotationKeys.
+    KeyRange scale;          ///< Chaves em CompressedAnimationClip::scaleTimes/scaleKeys.
+    float positionOffset[3]; ///< Menor posição das chaves do canal.
+    float positionScale[3];  ///< Amplitude das posições do canal dividida por 65535.
+    float scaleOffset[3];    ///< Menor escala das chaves do canal.
+    float scaleScale[3];     ///< Amplitude das escalas do canal dividida por 65535.
+};
+
+/**
+ * @brief Clip com as chaves reduzidas dentro de uma tolerância e os valores quantizados.
+ *
+ * Cada chave ocupa 3 uint16 (48 bits): posições e escalas relativas aos intervalos do canal e
+ * rotações no formato "smallest three", em que a maior componente do quaternion é omitida e
+ * reconstruída pela norma unitária.
+ */
+struct CompressedAnimationClip
+{
+    std::string name;                             ///< Nome do clip no modelo.
+    float duration;                               ///< Duração em segundos.
+    std::vector<CompressedAnimationTrack> tracks; ///< Canais dos bones animados, ordenados pelo índice do bone.
+    std::vector<float> positionTimes;             ///< Tempo, em segundos, de cada chave de posição mantida.
+    std::vector<uint16_t> positionKeys;           ///< Posições quantizadas (3 por chave).
+    std::vector<float> rotationTimes;             ///< Tempo, em segundos, de cada chave de rotação mantida.
+    std::vector<uint16_t> rotationKeys;           ///< Rotações em "smallest three" (3 por chave).
+    std::vector<float> scaleTimes;                ///< Tempo, em segundos, de cada chave de escala mantida.
+    std::vector<uint16_t> scaleKeys;              ///< Escalas quantizadas (3 por chave).
+
+    /**
+     * @brief Bytes ocupados pelos canais e chaves.
+     */
+    size_t memoryBytes() const;
+};
+
+/**
+ * @brief Erro máximo aceito pelo compressor em cada tipo de canal.
+ */
+struct AnimationCompressionSettings
+{
+    float positionTolerance; ///< Distância máxima, em unidades do modelo.
+    float rotationTolerance; ///< Ângulo máximo, em radianos.
+    float scaleTolerance;    ///< Diferença máxima em cada eixo da escala.
+};
+
+/**
+ * @brief Tolerâncias usadas na importação dos modelos.
+ */
+const AnimationCompressionSettings DEFAULT_ANIMATION_COMPRESSION = {0.001f, 0.001f, 0.001f};
+
+/**
+ * @brief Estado de reprodução de um clip: a chave corrente de cada canal e o último tempo amostrado.
+ *
+ * Enquanto o tempo avança, cada canal só anda para a frente a partir da chave anterior, sem busca
+ * binária. Um tempo menor que o anterior (volta do loop) reinicia os canais na primeira chave.
+ */
+struct AnimationCursor
+{
+    float time;                 ///< Último tempo amostrado.
+    std::vector<uint32_t> keys; ///< Chave corrente de posição, rotação e escala de cada canal (3 por canal).
+
+    /**
+     * @brief Posiciona o cursor no início de um clip.
+     * @param trackCount Quantidade de canais do clip.
+     */
+    void reset(size_t trackCount);
+};
+
+/**
+ * @brief Reprodução de um clip: índice, tempo atual e cursor.
+ */
+struct AnimationPlayback
+{
+    int clip;               ///< Índice do clip, ou -1 se nenhum.
+    float time;             ///< Tempo atual do clip em segundos.
+    bool loop;              ///< Recomeça o clip ao chegar ao fim; caso contrário, mantém a última pose.
+    AnimationCursor cursor; ///< Chaves correntes dos canais do clip.
+};
+
+/**
+ * @brief Avança o tempo de uma reprodução, respeitando o loop.
+ * @param playback Reprodução atualizada.
+ * @param duration Duração do clip reproduzido, em segundos.
+ * @param deltaTime Tempo decorrido, em segundos.
+ * @return true se o tempo mudou, false se o clip sem loop já estava no fim.
+ */
+bool advanceAnimation(AnimationPlayback &playback, float duration, float deltaTime);
+
+/**
+ * @brief Converte uma animação do Assimp em um clip, associando os canais aos bones pelo nome.
+ * @param animation Animação importada.
+ * @param boneNames Índice de cada bone pelo nome.
+ * @param clip Clip resultante.
+ * @return Quantidade de canais ignorados por animarem nós que não são bones.
+ */
+size_t importAnimationClip(const aiAnimation *animation, const BoneNameTable &boneNames, AnimationClip &clip);
+
+/**
+ * @brief Amostra um clip e grava a pose local dos bones animados.
+ *
+ * Posições e escalas são interpoladas linearmente e rotações com interpolação linear normalizada.
+ * Bones sem canal no clip, e canais sem chaves, mantêm os valores que já estavam na pose (em geral a
+ * bind pose).
+ *
+ * @param clip Clip amostrado.
+ * @param time Tempo em segundos, entre 0 e clip.duration.
+ * @param cursor Cursor do clip, atualizado.
+ * @param pose Pose local que recebe os bones animados.
+ */
+void sampleAnimationClip(const AnimationClip &clip, float time, AnimationCursor &cursor, LocalPose &pose);
+
+/**
+ * @brief Compacta um clip, removendo as chaves que a interpolação reproduz dentro das tolerâncias.
+ *
+ * O erro de cada chave removida é medido sobre os valores já quantizados das chaves mantidas, de
+ * forma que a tolerância inclui também o erro da quantização. Um canal cujas chaves ficam todas
+ * dentro da tolerância da primeira é reduzido a uma única chave.
+ *
+ * @param clip Clip importado.
+ * @param settings Tolerâncias de cada tipo de canal.
+ * @param compressed Clip compactado.
+ */
+void compressAnimationClip(const AnimationClip &clip, const AnimationCompressionSettings &settings,
+                           CompressedAnimationClip &compressed);
+
+/**
+ * @brief Decodifica as chaves mantidas de um clip compactado para o formato em float.
+ * @param compressed Clip compactado.
+ * @param clip Clip resultante, com as mesmas chaves e canais.
+ */
+void decompressAnimationClip(const CompressedAnimationClip &compressed, AnimationClip &clip);
+
+/**
+ * @brief Amostra um clip compactado, decodificando apenas as duas chaves vizinhas de cada canal.
+ *
+ * Mesmo comportamento de sampleAnimationClip() para clips em float.
+ *
+ * @param clip Clip amostrado.
+ * @param time Tempo em segundos, entre 0 e clip.duration.
+ * @param cursor Cursor do clip, atualizado.
+ * @param pose Pose local que recebe os bones animados.
+ */
+void sampleAnimationClip(const CompressedAnimationClip &clip, float time, AnimationCursor &cursor, LocalPose &pose);
+
+#endif
@@ -1,56 +1,71 @@
-#include <iostream>
-#include <stb_image.h>
 #include "background.hpp"
+#include "renderstats.hpp"
 
-Background::Background(){}
+// Plano do fundo: u, v, x, y, z por vértice
+static const GLfloat backgroundVertices[] = {
+    0, 0, -10, 2, 10,   // Inferior esquerdo
+    1, 0, 20, 2, 10,    // Inferior direito
+    1, 1, 20, 2, 20,    // Superior direito
+    0, 1, -10, 2, 20,   // Superior esquerdo
+};
+
+Background::Background() : textureID(0), vertexArray(0), vertexBuffer(0) {}
 
 Background::~Background()
 {
     glDeleteTextures(1, &textureID);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteVertexArrays(1, &vertexArray);
 }
 
-bool Background::loadTexture(const char *caminho)
+void Background::loadTexture(const char *caminho, TextureLoader &textureLoader)
 {
-    int largura, altura, canais;
+    // A imagem é decodificada invertida, com a origem no canto inferior esquerdo
+    textureID = textureLoader.request(caminho, true);
+    createBuffers();
+}
 
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(caminho, &largura, &altura, &canais, 4);
-    
-    if(!data) 
-    {
-        std::cerr << "Erro ao carregar fundo: " <<  caminho  << "\n";
-        return false;
-    }
+void Background::createBuffers()
+{
+    const GLsizei stride = 5 * sizeof(GLfloat);
 
-    glGenTextures(1, &textureID);
-    
-    glBindTexture(GL_TEXTURE_2D, textureID);    // Bind
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, largura, altura, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    
-    glBindTexture(GL_TEXTURE_2D, 0);    // Unbind
+    glGenVertexArrays(1, &vertexArray);
+    glBindVertexArray(vertexArray);
 
-    stbi_image_free(data);
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(backgroundVertices), backgroundVertices, GL_STATIC_DRAW);
+    glTexCoordPointer(2, GL_FLOAT, stride, reinterpret_cast<const void *>(0));
+    glVertexPointer(3, GL_FLOAT, stride, reinterpret_cast<const void *>(2 * sizeof(GLfloat)));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
 
-    std::cout << "Fundo carregado: " << caminho << "\n";
-    return true;
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool Background::isLoaded(const TextureLoader &textureLoader) const
+{
+    return textureLoader.isLoaded(textureID);
 }
 
 void Background::draw() {
     glBindTexture(GL_TEXTURE_2D, textureID);
     
-    // Adiciona a textura em um plano
-    glBegin(GL_QUADS);
-        glTexCoord2f(0, 0); glVertex3f(-10, 2, 10);  // Inferior esquerdo
-        glTexCoord2f(1, 0); glVertex3f(20, 2, 10);   // Inferior direito
-        glTexCoord2f(1, 1); glVertex3f(20, 2, 20);    // Superior direito
-        glTexCoord2f(0, 1); glVertex3f(-10, 2, 20);   // Superior esquerdo
-    glEnd();
+    // Desenha o plano texturizado a partir do VBO estático
+    glBindVertexArray(vertexArray);
+    glDrawArrays(GL_QUADS, 0, 4);
+    glBindVertexArray(0);
 
     glBindTexture(GL_TEXTURE_2D, 0);
-}
\ No newline at end of file
+
+    renderStats.glCalls += 5;
+    renderStats.drawCalls++;
+    renderStats.triangles += 2;
+}
+
+void Background::getCorners(glm::vec3 corners[4]) const
+{
+    for (int i = 0; i < 4; i++)
+        corners[i] = glm::vec3(backgroundVertices[i * 5 + 2], backgroundVertices[i * 5 + 3], backgroundVertices[i * 5 + 4]);
+}
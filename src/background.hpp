@@ -2,11 +2,20 @@
 #define BACKGROUND_HPP
 
 #include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "textureloader.hpp"
 
 class Background
 {
 private:
     GLuint textureID;
+    GLuint vertexArray;
+    GLuint vertexBuffer;
+
+    /**
+     * @brief Cria o VAO e envia o plano do fundo para um VBO estático
+     */
+    void createBuffers();
 public:
     /**
      * @brief Construtor
@@ -19,16 +28,29 @@ public:
     ~Background();
 
     /**
-     * @brief Carrega a textura para o fundo
+     * @brief Agenda o carregamento da textura do fundo
      * @param caminho O caminho da textura do fundo
-     * @return True se concluiu com sucesso, false para caso contrário
+     * @param textureLoader O carregador que decodifica a textura em paralelo
      */
-    bool loadTexture(const char *caminho);
+    void loadTexture(const char *caminho, TextureLoader &textureLoader);
+
+    /**
+     * @brief Verifica se a textura do fundo foi carregada
+     * @param textureLoader O carregador usado em loadTexture(), após TextureLoader::finish()
+     * @return True se a textura foi carregada, false para caso contrário
+     */
+    bool isLoaded(const TextureLoader &textureLoader) const;
 
     /**
      * @brief Desenha o background
      */
     void draw();
+
+    /**
+     * @brief Retorna os cantos do plano do fundo no mundo, na ordem do desenho
+     * @param corners Os 4 cantos (inferior esquerdo, inferior direito, superior direito, superior esquerdo)
+     */
+    void getCorners(glm::vec3 corners[4]) const;
 };
 
 #endif
\ No newline at end of file
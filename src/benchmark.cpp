@@ -0,0 +1,1572 @@
+#include "benchmark.hpp"
+#include "animation.hpp"
+#include "bounds.hpp"
+#include "crowd.hpp"
+#include "impostor.hpp"
+#include "localpose.hpp"
+#include "skinning.hpp"
+#include "skeleton.hpp"
+#include "meshprocessing.hpp"
+#include "threadpool.hpp"
+#include "renderstats.hpp"
+#include <assimp/Importer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+
+/**
+ * @brief Mede o tempo médio de uma função, em milissegundos por execução.
+ * @param iterations Quantidade de execuções medidas (após uma execução de aquecimento).
+ * @param fn Função a ser medida.
+ */
+static double measureMs(int iterations, const std::function<void()> &fn)
+{
+    fn();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        fn();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+/**
+ * @brief Skinning original de draw(): um Vertex por vez, copiando a aiMatrix4x4 e desviando em cada peso.
+ */
+static void referenceSkinning(const SubMesh &sub, const std::vector<BoneInfo> &boneInfo, float *out)
+{
+    for (const auto &vert : sub.vertices)
+    {
+        aiVector3D pos(vert.x, vert.y, vert.z);
+        aiVector3D finalPos(0, 0, 0);
+        float totalWeight = 0.0f;
+
+        for (int i = 0; i < 4; i++)
+        {
+            if (vert.weights[i] > 0.0f)
+            {
+                int boneIndex = vert.boneIDs[i];
+                aiMatrix4x4 transform = boneInfo[boneIndex].finalTransformation;
+                aiVector3D transformed;
+                transformed.x = transform.a1 * pos.x + transform.a2 * pos.y + transform.a3 * pos.z + transform.a4;
+                transformed.y = transform.b1 * pos.x + transform.b2 * pos.y + transform.b3 * pos.z + transform.b4;
+                transformed.z = transform.c1 * pos.x + transform.c2 * pos.y + transform.c3 * pos.z + transform.c4;
+
+                finalPos.x += vert.weights[i] * transformed.x;
+                finalPos.y += vert.weights[i] * transformed.y;
+                finalPos.z += vert.weights[i] * transformed.z;
+                totalWeight += vert.weights[i];
+            }
+        }
+
+        if (totalWeight == 0.0f)
+            finalPos = pos;
+
+        *out++ = finalPos.x;
+        *out++ = finalPos.y;
+        *out++ = finalPos.z;
+    }
+}
+
+/**
+ * @brief Aplica uma pose não trivial ao personagem para que as matrizes da paleta não sejam identidades.
+ */
+static void poseCharacter(CharacterInstance &character)
+{
+    glm::quat rotation = glm::angleAxis(glm::radians(30.0f), glm::normalize(glm::vec3(-1.0f, 0.0f, 1.0f)));
+    character.rotateBone(character.findBone("Head"), rotation);
+    character.update();
+}
+
+static int benchmarkSkinning(const BenchmarkContext &context)
+{
+    const int iterations = 200;
+    CharacterInstance &character = *context.character;
+    poseCharacter(character);
+
+    const std::vector<SubMesh> &submeshes = character.getAsset()->getSubmeshes();
+    const std::vector<BoneInfo> &bones = character.getBoneInfo();
+
+    size_t vertexCount = 0;
+    for (const auto &sub : submeshes)
+        vertexCount += sub.vertices.size();
+    std::vector<float> palette;
+    buildSkinningPalette(bones.data(), bones.size(), palette);
+
+    std::vector<float> expected(vertexCount * 3), output(vertexCount * 3);
+    double referenceMs = measureMs(iterations, [&]
+    {
+        float *out = expected.data();
+        for (const auto &sub : submeshes)
+        {
+            referenceSkinning(sub, bones, out);
+            out += sub.vertices.size() * 3;
+        }
+    });
+
+    // Bytes lidos por vértice no skinning: posição e influências (o Vertex também carrega as UVs)
+    std::cout << "Skinning: " << vertexCount << " vértices, " << bones.size() << " bones, " << iterations
+              << " iterações" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  original (Vertex, " << sizeof(Vertex) << " B/vértice)  " << referenceMs << " ms/quadro" << std::endl;
+
+    const InfluenceFormat formats[] = {InfluenceFormat::Unorm8, InfluenceFormat::Unorm16};
+    for (InfluenceFormat format : formats)
+    {
+        if (format == InfluenceFormat::Unorm8 && selectInfluenceFormat(bones.size()) != format)
+            continue;
+
+        // Prepara os streams da mesma forma que o SkinnedMeshAsset
+        std::vector<SkinningStreams> streams(submeshes.size());
+        for (size_t i = 0; i < submeshes.size(); i++)
+            buildSkinningStreams(submeshes[i].vertices.data(), submeshes[i].vertices.size(), bones.size(), format,
+                                 VertexFormat::Float, streams[i]);
+        size_t streamBytes = 3 * sizeof(float) + (streams.empty() ? 0 : streams[0].influenceStride());
+        std::cout << "  SoA " << (format == InfluenceFormat::Unorm8 ? "unorm8" : "unorm16") << " (" << streamBytes
+                  << " B/vértice, " << static_cast<double>(sizeof(Vertex)) / streamBytes << "x menor)" << std::endl;
+
+        const SkinningKernel kernels[] = {SkinningKernel::Scalar, SkinningKernel::SSE2, SkinningKernel::AVX2};
+        for (SkinningKernel kernel : kernels)
+        {
+            if (static_cast<int>(kernel) > static_cast<int>(detectSkinningKernel()))
+            {
+                std::cout << "    " << skinningKernelName(kernel) << ": não suportado nesta CPU" << std::endl;
+                continue;
+            }
+
+            double kernelMs = measureMs(iterations, [&]
+            {
+                float *out = output.data();
+                for (size_t i = 0; i < streams.size(); i++)
+                {
+                    skinPositions(streams[i], palette.data(), 0, streams[i].size(), out, kernel);
+                    out += streams[i].size() * 3;
+                }
+            });
+
+            // Confere o resultado contra o caminho original (a diferença vem da quantização dos pesos)
+            float maxError = 0.0f;
+            for (size_t i = 0; i < output.size(); i++)
+                maxError = std::max(maxError, std::fabs(output[i] - expected[i]));
+
+            std::cout << "    " << std::left << std::setw(15) << skinningKernelName(kernel) << std::right << kernelMs
+                      << " ms/quadro  (" << referenceMs / kernelMs << "x, erro máx. " << maxError << ")" << std::endl;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Mede o skinning paralelo de um conjunto de streams variando o número de threads de 1 a maxThreads.
+ */
+static void measureScaling(const char *label, const std::vector<SkinningStreams> &streams,
+                           const std::vector<float> &palette, unsigned int maxThreads, SkinningKernel kernel)
+{
+    size_t vertexCount = 0;
+    for (const auto &stream : streams)
+        vertexCount += stream.size();
+    std::vector<float> output(vertexCount * 3);
+
+    // Mantém o número de vértices processados por medição aproximadamente constante
+    int iterations = std::max<size_t>(10, 20000000 / std::max<size_t>(vertexCount, 1));
+
+    std::cout << label << ": " << vertexCount << " vértices, kernel " << skinningKernelName(kernel) << std::endl;
+    double singleMs = 0.0;
+    for (unsigned int threads = 1; threads <= maxThreads; threads++)
+    {
+        ThreadPool pool(threads);
+        double ms = measureMs(iterations, [&]
+        {
+            skinAll(&pool, streams, palette.data(), output.data(), kernel);
+        });
+        if (threads == 1)
+            singleMs = ms;
+
+        double speedup = singleMs / ms;
+        std::cout << "  " << std::setw(2) << threads << " thread(s)  " << std::setw(8) << ms << " ms/quadro  "
+                  << std::setw(6) << speedup << "x  eficiência " << std::setw(5) << 100.0 * speedup / threads << "%"
+                  << std::endl;
+    }
+}
+
+static int benchmarkScaling(const BenchmarkContext &context)
+{
+    CharacterInstance &character = *context.character;
+    poseCharacter(character);
+
+    const std::vector<SubMesh> &submeshes = character.getAsset()->getSubmeshes();
+    const std::vector<BoneInfo> &bones = character.getBoneInfo();
+    unsigned int maxThreads = std::max(context.threadPool->size(), std::thread::hardware_concurrency());
+
+    std::vector<SkinningStreams> streams(submeshes.size());
+    size_t vertexCount = 0;
+    for (size_t i = 0; i < submeshes.size(); i++)
+    {
+        buildSkinningStreams(submeshes[i].vertices.data(), submeshes[i].vertices.size(), bones.size(),
+                             selectInfluenceFormat(bones.size()), VertexFormat::Float, streams[i]);
+        vertexCount += submeshes[i].vertices.size();
+    }
+    std::vector<float> palette;
+    buildSkinningPalette(bones.data(), bones.size(), palette);
+
+    std::cout << std::fixed << std::setprecision(3);
+    measureScaling("Mita", streams, palette, maxThreads, character.getSkinningKernel());
+
+    // Modelo sintético: replica os submeshes da Mita até ultrapassar 2 milhões de vértices
+    const size_t syntheticTarget = 2000000;
+    std::vector<SkinningStreams> synthetic;
+    for (size_t total = 0; vertexCount > 0 && total < syntheticTarget; total += vertexCount)
+        synthetic.insert(synthetic.end(), streams.begin(), streams.end());
+    measureScaling("Sintético", synthetic, palette, maxThreads, character.getSkinningKernel());
+    return 0;
+}
+
+static int benchmarkRender(const BenchmarkContext &context)
+{
+    const int frames = 300;
+    CharacterInstance &character = *context.character;
+    BoneHandle head = character.findBone("Head");
+
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+
+    // Sem vsync, para medir o custo real de cada quadro
+    glfwSwapInterval(0);
+    renderStats.reset();
+    double frameMs = measureMs(frames, [&]
+    {
+        // A cabeça gira a cada quadro para que o skinning seja sempre refeito
+        static int frame = 0;
+        float angle = glm::radians(30.0f) * std::sin(frame++ * 0.05f);
+        character.rotateBone(head, glm::angleAxis(angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        context.camera->applyCamera();
+        context.background->draw();
+        character.update();
+        character.draw();
+        glfwSwapBuffers(context.window);
+        glFinish();
+    });
+
+    // O primeiro quadro de measureMs é aquecimento e também é contado
+    double perFrame = 1.0 / (frames + 1);
+
+    // Estimativa do modo imediato anterior: glBegin/glEnd/glBindTexture por submesh e
+    // glTexCoord2f + glVertex3f por canto de triângulo, mais 12 chamadas do fundo
+    unsigned long immediateCalls = 12;
+    size_t vertexCount = 0;
+    for (const auto &sub : character.getAsset()->getSubmeshes())
+    {
+        immediateCalls += 3 + 2 * sub.lodIndexCount(0);
+        vertexCount += sub.vertices.size();
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Render: " << frames << " quadros" << std::endl;
+    std::cout << "  tempo de quadro       " << frameMs << " ms (" << 1000.0 / frameMs << " FPS)" << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "  chamadas OpenGL       " << renderStats.glCalls * perFrame << " por quadro (modo imediato: "
+              << immediateCalls << ")" << std::endl;
+    std::cout << "  comandos de desenho   " << renderStats.drawCalls * perFrame << " por quadro" << std::endl;
+    std::cout << "  triângulos            " << renderStats.triangles * perFrame << " por quadro" << std::endl;
+    std::cout << "  vértices no skinning  " << renderStats.skinnedVertices * perFrame << " por quadro (de "
+              << vertexCount << ")" << std::endl;
+    std::cout << "  esperas por fence     " << renderStats.fenceWaits << std::endl;
+
+    // Pose parada (personagem ocioso): as posições do quadro anterior são reaproveitadas
+    renderStats.reset();
+    double idleMs = measureMs(frames, [&]
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        context.camera->applyCamera();
+        context.background->draw();
+        character.update();
+        character.draw();
+        glfwSwapBuffers(context.window);
+        glFinish();
+    });
+    std::cout << std::setprecision(3);
+    std::cout << "  pose parada           " << idleMs << " ms (" << 1000.0 / idleMs << " FPS), ";
+    std::cout << std::setprecision(1) << renderStats.glCalls * perFrame << " chamadas OpenGL por quadro" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Desenha um quadro completo da cena e retorna os pixels RGBA do back buffer.
+ */
+static std::vector<unsigned char> renderFrame(const BenchmarkContext &context)
+{
+    int width, height;
+    glfwGetFramebufferSize(context.window, &width, &height);
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    context.camera->applyCamera();
+    context.background->draw();
+    context.character->update();
+    context.character->draw();
+
+    std::vector<unsigned char> pixels(size_t(width) * height * 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glfwSwapBuffers(context.window);
+    return pixels;
+}
+
+static int benchmarkGpuSkinning(const BenchmarkContext &context)
+{
+    const int frames = 300;
+    CharacterInstance &character = *context.character;
+    SkinningMode previousMode = character.getSkinningMode();
+    if (!character.setSkinningMode(SkinningMode::GPU))
+    {
+        std::cerr << "Skinning na GPU não suportado neste contexto OpenGL" << std::endl;
+        return -1;
+    }
+
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+    glfwSwapInterval(0);
+    BoneHandle head = character.findBone("Head");
+    glm::quat rotation = glm::angleAxis(glm::radians(30.0f), glm::normalize(glm::vec3(-1.0f, 0.0f, 1.0f)));
+    character.rotateBone(head, rotation);
+
+    // Mesma pose nos dois caminhos: as imagens devem diferir apenas por arredondamento
+    character.setSkinningMode(SkinningMode::CPU);
+    std::vector<unsigned char> cpuImage = renderFrame(context);
+    character.setSkinningMode(SkinningMode::GPU);
+    std::vector<unsigned char> gpuImage = renderFrame(context);
+
+    size_t differentPixels = 0;
+    int maxDifference = 0;
+    for (size_t i = 0; i < cpuImage.size(); i += 4)
+    {
+        int pixelDifference = 0;
+        for (int c = 0; c < 3; c++)
+            pixelDifference = std::max(pixelDifference, std::abs(cpuImage[i + c] - gpuImage[i + c]));
+        if (pixelDifference > 0)
+            differentPixels++;
+        maxDifference = std::max(maxDifference, pixelDifference);
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Skinning CPU x GPU: " << differentPixels << " de " << cpuImage.size() / 4
+              << " pixels diferentes (diferença máx. " << maxDifference << "/255)" << std::endl;
+
+    const SkinningMode modes[] = {SkinningMode::CPU, SkinningMode::GPU};
+    for (SkinningMode mode : modes)
+    {
+        character.setSkinningMode(mode);
+        double frameMs = measureMs(frames, [&]
+        {
+            static int frame = 0;
+            float angle = glm::radians(30.0f) * std::sin(frame++ * 0.05f);
+            character.rotateBone(head, glm::angleAxis(angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            context.camera->applyCamera();
+            context.background->draw();
+            character.update();
+            character.draw();
+            glfwSwapBuffers(context.window);
+            glFinish();
+        });
+        std::cout << "  " << (mode == SkinningMode::CPU ? "CPU" : "GPU") << "  " << frameMs << " ms/quadro ("
+                  << 1000.0 / frameMs << " FPS)" << std::endl;
+    }
+
+    character.setSkinningMode(previousMode);
+    return 0;
+}
+
+/**
+ * @brief Transformação global recursiva original: sobe até a raiz para cada bone.
+ */
+static aiMatrix4x4 referenceGlobalTransform(const std::vector<BoneInfo> &bones, int boneIndex)
+{
+    const BoneInfo &bone = bones[boneIndex];
+    if (bone.parentIndex == -1)
+        return bone.localTransform;
+    return referenceGlobalTransform(bones, bone.parentIndex) * bone.localTransform;
+}
+
+/**
+ * @brief Cria um esqueleto sintético com transformações locais aleatórias (rotação pequena e translação).
+ * @param parents Pai de cada bone, já em ordem topológica.
+ */
+static std::vector<BoneInfo> syntheticSkeleton(const std::vector<int> &parents)
+{
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<BoneInfo> bones(parents.size());
+    for (size_t i = 0; i < bones.size(); i++)
+    {
+        float x = 0.05f * unit(random), y = 0.05f * unit(random), z = 0.05f * unit(random);
+        float w = std::sqrt(1.0f - x * x - y * y - z * z);
+        bones[i].defaultLocalTransform = aiMatrix4x4(aiVector3D(1.0f, 1.0f, 1.0f), aiQuaternion(w, x, y, z),
+                                                     aiVector3D(unit(random), 1.0f, unit(random)));
+        bones[i].localTransform = bones[i].defaultLocalTransform;
+        bones[i].parentIndex = parents[i];
+    }
+    return bones;
+}
+
+/**
+ * @brief Compara a atualização recursiva original com a passada linear em um esqueleto.
+ */
+static void measureSkeleton(const char *label, std::vector<BoneInfo> bones)
+{
+    int depth = 0;
+    std::vector<int> depths(bones.size(), 0);
+    for (size_t i = 0; i < bones.size(); i++)
+    {
+        depths[i] = bones[i].parentIndex < 0 ? 1 : depths[bones[i].parentIndex] + 1;
+        depth = std::max(depth, depths[i]);
+    }
+
+    // Mantém o número de bones processados por medição aproximadamente constante
+    int iterations = std::max<size_t>(5, 2000000 / std::max<size_t>(bones.size() * depth, 1));
+    std::vector<BoneInfo> reference = bones;
+    double recursiveMs = measureMs(iterations, [&]
+    {
+        for (size_t i = 0; i < reference.size(); i++)
+            reference[i].finalTransformation = referenceGlobalTransform(reference, i) * reference[i].offsetMatrix;
+    });
+
+    std::vector<aiMatrix4x4> globals(bones.size());
+    double linearMs = measureMs(iterations, [&]
+    {
+        updateSkeleton(bones.data(), bones.size(), globals.data());
+    });
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < bones.size(); i++)
+    {
+        for (unsigned int r = 0; r < 4; r++)
+            for (unsigned int c = 0; c < 4; c++)
+                maxError = std::max(maxError, std::fabs(bones[i].finalTransformation[r][c] - reference[i].finalTransformation[r][c]));
+    }
+
+    std::cout << "  " << std::left << std::setw(22) << label << std::right << std::setw(5) << bones.size()
+              << " bones, profundidade " << std::setw(4) << depth << ": recursivo " << std::setw(9) << recursiveMs
+              << " ms, linear " << std::setw(7) << linearMs << " ms (" << recursiveMs / linearMs << "x, erro máx. "
+              << maxError << ")" << std::endl;
+}
+
+static int benchmarkSkeleton(const BenchmarkContext &context)
+{
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Esqueleto: atualização das transformações globais" << std::endl;
+    measureSkeleton("Mita", context.character->getBoneInfo());
+
+    // Cadeia única: o pior caso do algoritmo recursivo (O(n²) multiplicações)
+    const int chainLength = 512;
+    std::vector<int> chain(chainLength);
+    for (int i = 0; i < chainLength; i++)
+        chain[i] = i - 1;
+    measureSkeleton("cadeia", syntheticSkeleton(chain));
+
+    // Árvore binária completa com 12 níveis
+    std::vector<int> tree((1 << 12) - 1);
+    for (size_t i = 0; i < tree.size(); i++)
+        tree[i] = i == 0 ? -1 : (i - 1) / 2;
+    measureSkeleton("árvore binária", syntheticSkeleton(tree));
+
+    // Multidão de 64 esqueletos com 64 bones em cadeia (ex.: dedos, cabelo, caudas)
+    std::vector<int> crowd;
+    for (int c = 0; c < 64; c++)
+    {
+        for (int i = 0; i < 64; i++)
+            crowd.push_back(i == 0 ? -1 : static_cast<int>(crowd.size()) - 1);
+    }
+    measureSkeleton("64 cadeias de 64", syntheticSkeleton(crowd));
+    return 0;
+}
+
+static int benchmarkBones(const BenchmarkContext &context)
+{
+    const int iterations = 2000;
+    CharacterInstance &character = *context.character;
+    const BoneNameTable &names = character.getAsset()->getBoneNames();
+
+    // Mesma rotação em todos os bones, a cada iteração, por nome e por handle
+    std::vector<std::string> boneNames;
+    std::vector<BoneHandle> handles;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        boneNames.push_back(names.name(i));
+        handles.push_back(character.findBone(names.name(i)));
+    }
+    if (boneNames.empty())
+    {
+        std::cerr << "O modelo não possui bones" << std::endl;
+        return -1;
+    }
+
+    // A referência reproduz a busca anterior, em um std::map de nome para índice
+    std::map<std::string, int> mapping;
+    for (size_t i = 0; i < boneNames.size(); i++)
+        mapping[boneNames[i]] = i;
+
+    int found = 0;
+    double mapMs = measureMs(iterations, [&]
+    {
+        for (const auto &name : boneNames)
+            found += mapping.find(name)->second;
+    });
+    double tableMs = measureMs(iterations, [&]
+    {
+        for (const auto &name : boneNames)
+            found += names.find(name);
+    });
+
+    glm::quat rotation = glm::angleAxis(glm::radians(10.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    double byNameMs = measureMs(iterations, [&]
+    {
+        for (const auto &name : boneNames)
+            character.rotateBone(name, rotation);
+    });
+    double byHandleMs = measureMs(iterations, [&]
+    {
+        for (BoneHandle handle : handles)
+            character.rotateBone(handle, rotation);
+    });
+
+    double perBone = 1e6 / boneNames.size();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Bones: " << boneNames.size() << " bones, " << iterations << " iterações (" << found % 2 << ")"
+              << std::endl;
+    std::cout << "  busca std::map           " << mapMs * perBone << " ns/bone" << std::endl;
+    std::cout << "  busca tabela plana       " << tableMs * perBone << " ns/bone" << std::endl;
+    std::cout << "  rotateBone(nome)         " << byNameMs * perBone << " ns/bone" << std::endl;
+    std::cout << "  rotateBone(BoneHandle)   " << byHandleMs * perBone << " ns/bone" << std::endl;
+    return 0;
+}
+
+static int benchmarkVertexFormat(const BenchmarkContext &context)
+{
+    const int iterations = 200;
+    CharacterInstance &character = *context.character;
+    poseCharacter(character);
+
+    const std::vector<SubMesh> &submeshes = character.getAsset()->getSubmeshes();
+    const std::vector<BoneInfo> &bones = character.getBoneInfo();
+    std::vector<float> palette;
+    buildSkinningPalette(bones.data(), bones.size(), palette);
+    InfluenceFormat influenceFormat = selectInfluenceFormat(bones.size());
+    SkinningKernel kernel = detectSkinningKernel();
+
+    // Os mesmos submeshes nos dois formatos, como o SkinnedMeshAsset os prepara em load()
+    const VertexFormat formats[] = {VertexFormat::Float, VertexFormat::Quantized};
+    std::vector<SkinningStreams> streams[2];
+    for (int f = 0; f < 2; f++)
+    {
+        streams[f].resize(submeshes.size());
+        for (size_t i = 0; i < submeshes.size(); i++)
+            buildSkinningStreams(submeshes[i].vertices.data(), submeshes[i].vertices.size(), bones.size(),
+                                 influenceFormat, formats[f], streams[f][i]);
+    }
+
+    // Memória estática por submesh: posições, influências e UVs (8 bytes em float, 4 em half float)
+    std::cout << "Formato de vértices: " << submeshes.size() << " submeshes, kernel " << skinningKernelName(kernel)
+              << ", " << iterations << " iterações" << std::endl;
+    size_t totalBytes[2] = {0, 0};
+    for (size_t i = 0; i < submeshes.size(); i++)
+    {
+        size_t bytes[2];
+        for (int f = 0; f < 2; f++)
+        {
+            bytes[f] = streams[f][i].size() * (streams[f][i].vertexBytes() + (f == 0 ? 8 : 4));
+            totalBytes[f] += bytes[f];
+        }
+        std::cout << "  submesh " << std::setw(3) << i << std::setw(8) << streams[0][i].size() << " vértices  "
+                  << std::setw(9) << bytes[0] << " B float  " << std::setw(9) << bytes[1] << " B quantizado"
+                  << std::endl;
+    }
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  total  float " << totalBytes[0] << " B, quantizado " << totalBytes[1] << " B ("
+              << static_cast<double>(totalBytes[0]) / std::max<size_t>(totalBytes[1], 1) << "x menor)" << std::endl;
+
+    size_t vertexCount = 0;
+    for (const auto &stream : streams[0])
+        vertexCount += stream.size();
+    std::vector<float> output[2];
+    double kernelMs[2];
+    for (int f = 0; f < 2; f++)
+    {
+        output[f].resize(vertexCount * 3);
+        kernelMs[f] = measureMs(iterations, [&]
+        {
+            float *out = output[f].data();
+            for (const auto &stream : streams[f])
+            {
+                skinPositions(stream, palette.data(), 0, stream.size(), out, kernel);
+                out += stream.size() * 3;
+            }
+        });
+    }
+
+    // A diferença entre os formatos vem apenas da quantização das posições na AABB de cada submesh
+    float maxError = 0.0f;
+    for (size_t i = 0; i < output[0].size(); i++)
+        maxError = std::max(maxError, std::fabs(output[0][i] - output[1][i]));
+    std::cout << "  skinning float       " << kernelMs[0] << " ms/quadro" << std::endl;
+    std::cout << "  skinning quantizado  " << kernelMs[1] << " ms/quadro (" << kernelMs[0] / kernelMs[1]
+              << "x, erro máx. " << maxError << ")" << std::endl;
+    return 0;
+}
+
+static int benchmarkLod(const BenchmarkContext &context)
+{
+    const int frames = 300;
+    CharacterInstance &character = *context.character;
+
+    // Regera a cadeia a partir do LOD 0 de cada submesh, já que ela normalmente vem do cache
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "LODs: até " << MAX_LOD_COUNT << " níveis por submesh" << std::endl;
+    double totalMs = 0.0;
+    const std::vector<SubMesh> &submeshes = character.getAsset()->getSubmeshes();
+    for (size_t i = 0; i < submeshes.size(); i++)
+    {
+        SubMesh sub = submeshes[i];
+        std::vector<uint32_t> indices = sub.getIndices();
+        indices.resize(sub.lodIndexCount(0));
+        sub.lodOffsets.clear();
+        sub.setIndices(indices);
+
+        auto start = std::chrono::steady_clock::now();
+        buildLodChain(sub, MAX_LOD_COUNT);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        totalMs += elapsed.count();
+
+        std::cout << "  submesh " << std::setw(3) << i << std::setw(9) << elapsed.count() << " ms  triângulos";
+        for (size_t lod = 0; lod < sub.lodCount(); lod++)
+            std::cout << (lod == 0 ? " " : " / ") << sub.lodIndexCount(lod) / 3;
+        std::cout << std::endl;
+    }
+    std::cout << "  geração total " << totalMs << " ms" << std::endl;
+
+    // Custo de quadro de cada nível, com a pose animada para incluir o skinning
+    glfwSwapInterval(0);
+    BoneHandle head = character.findBone("Head");
+    double perFrame = 1.0 / (frames + 1);
+    std::cout << std::setprecision(3);
+    for (int lod = 0; lod < character.getAsset()->getLodCount(); lod++)
+    {
+        character.setForcedLod(lod);
+        renderStats.reset();
+        double frameMs = measureMs(frames, [&]
+        {
+            static int frame = 0;
+            float angle = glm::radians(30.0f) * std::sin(frame++ * 0.05f);
+            character.rotateBone(head, glm::angleAxis(angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            context.camera->applyCamera();
+            context.background->draw();
+            character.update();
+            character.draw();
+            glfwSwapBuffers(context.window);
+            glFinish();
+        });
+        std::cout << "  LOD " << lod << "  " << frameMs << " ms/quadro, " << std::setprecision(0)
+                  << renderStats.triangles * perFrame << " triângulos por quadro" << std::setprecision(3) << std::endl;
+    }
+
+    // Escolha automática para a câmera atual
+    character.setForcedLod(-1);
+    renderFrame(context);
+    std::cout << "  LOD escolhido pela câmera: " << character.getCurrentLod() << std::endl;
+    return 0;
+}
+
+static int benchmarkMeshlets(const BenchmarkContext &context)
+{
+    const int frames = 300;
+    CharacterInstance &character = *context.character;
+    SkinningMode previousMode = character.getSkinningMode();
+    character.setSkinningMode(SkinningMode::CPU);
+
+    size_t begin, end, vertexCount = 0, triangleCount = 0;
+    character.getAsset()->getLodMeshlets(0, begin, end);
+    const std::vector<Meshlet> &meshlets = character.getAsset()->getMeshlets();
+    for (size_t m = begin; m < end; m++)
+    {
+        vertexCount += meshlets[m].vertexCount;
+        triangleCount += meshlets[m].triangleCount;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Meshlets: " << end - begin << " no LOD 0, média de " << double(vertexCount) / (end - begin)
+              << " vértices e " << double(triangleCount) / (end - begin) << " triângulos (máx. " << MESHLET_MAX_VERTICES
+              << "/" << MESHLET_MAX_TRIANGLES << ")" << std::endl;
+
+    // Mesma animação com o descarte desligado (sem câmera), só pelo frustum e também pelos cones de normais.
+    // O LOD fica fixo para que só o descarte mude entre as configurações
+    glfwSwapInterval(0);
+    character.setForcedLod(0);
+    BoneHandle head = character.findBone("Head");
+    double perFrame = 1.0 / (frames + 1);
+    bool previousBackfaceCulling = character.getBackfaceCulling();
+    const char *labels[] = {"sem descarte      ", "frustum           ", "frustum + costas  "};
+    for (int config = 0; config < 3; config++)
+    {
+        character.setCamera(config == 0 ? nullptr : context.camera);
+        character.setBackfaceCulling(config == 2);
+        renderStats.reset();
+        double frameMs = measureMs(frames, [&]
+        {
+            static int frame = 0;
+            float angle = glm::radians(30.0f) * std::sin(frame++ * 0.05f);
+            character.rotateBone(head, glm::angleAxis(angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            context.camera->applyCamera();
+            context.background->draw();
+            character.update();
+            character.draw();
+            glfwSwapBuffers(context.window);
+            glFinish();
+        });
+        std::cout << std::setprecision(3) << "  " << labels[config] << frameMs << " ms/quadro, " << std::setprecision(0)
+                  << renderStats.triangles * perFrame << " triângulos e " << renderStats.culledMeshlets * perFrame
+                  << " meshlets descartados por quadro" << std::endl;
+    }
+
+    character.setCamera(context.camera);
+    character.setBackfaceCulling(previousBackfaceCulling);
+    character.setForcedLod(-1);
+    character.setSkinningMode(previousMode);
+    return 0;
+}
+
+/**
+ * @brief Cria um clip sintético que anima todos os bones, com chaves em intervalos irregulares.
+ * @param boneCount Quantidade de bones.
+ * @param duration Duração em segundos.
+ * @param keysPerSecond Frequência média das chaves de cada canal.
+ * @param random Gerador usado nos tempos e valores.
+ */
+static AnimationClip syntheticClip(size_t boneCount, float duration, float keysPerSecond, std::mt19937 &random)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    AnimationClip clip;
+    clip.name = "sintético";
+    clip.duration = duration;
+
+    // Cada canal recebe seus próprios tempos, como nos clips exportados com redução de chaves
+    auto appendTimes = [&](std::vector<float> &times)
+    {
+        KeyRange range = {static_cast<uint32_t>(times.size()), 0};
+        float step = 1.0f / keysPerSecond;
+        for (float t = 0.0f; t < duration; t += step * (1.0f + 0.5f * unit(random)))
+        {
+            times.push_back(t);
+            range.count++;
+        }
+        times.push_back(duration);
+        range.count++;
+        return range;
+    };
+    for (size_t b = 0; b < boneCount; b++)
+    {
+        AnimationTrack track;
+        track.bone = b;
+        track.position = appendTimes(clip.positionTimes);
+        track.rotation = appendTimes(clip.rotationTimes);
+        track.scale = appendTimes(clip.scaleTimes);
+        clip.tracks.push_back(track);
+    }
+    for (size_t k = 0; k < clip.positionTimes.size(); k++)
+        clip.positionKeys.emplace_back(unit(random), 1.0f + 0.1f * unit(random), unit(random));
+    for (size_t k = 0; k < clip.rotationTimes.size(); k++)
+    {
+        float x = 0.3f * unit(random), y = 0.3f * unit(random), z = 0.3f * unit(random);
+        clip.rotationKeys.emplace_back(std::sqrt(1.0f - x * x - y * y - z * z), x, y, z);
+    }
+    for (size_t k = 0; k < clip.scaleTimes.size(); k++)
+        clip.scaleKeys.emplace_back(1.0f, 1.0f, 1.0f);
+    return clip;
+}
+
+/**
+ * @brief Localiza o intervalo de um canal por busca binária, como em uma amostragem sem cursor.
+ * @return Fator de interpolação entre key e key + 1.
+ */
+static float referenceKey(const float *times, uint32_t count, float time, uint32_t &key)
+{
+    key = std::upper_bound(times, times + count, time) - times;
+    key = key > 0 ? key - 1 : 0;
+    if (key + 1 >= count)
+        return 0.0f;
+    return std::max(0.0f, (time - times[key]) / (times[key + 1] - times[key]));
+}
+
+/**
+ * @brief Amostragem de referência: busca binária em cada canal e a mesma interpolação de sampleAnimationClip().
+ */
+static void referenceSampleClip(const AnimationClip &clip, float time, LocalPose &pose)
+{
+    auto lerp = [](const aiVector3D &a, const aiVector3D &b, float t) { return a + (b - a) * t; };
+    for (const AnimationTrack &track : clip.tracks)
+    {
+        uint32_t key;
+        const float *times = clip.positionTimes.data() + track.position.offset;
+        const aiVector3D *positions = clip.positionKeys.data() + track.position.offset;
+        float t = referenceKey(times, track.position.count, time, key);
+        aiVector3D position = t > 0.0f ? lerp(positions[key], positions[key + 1], t) : positions[key];
+
+        times = clip.rotationTimes.data() + track.rotation.offset;
+        const aiQuaternion *rotations = clip.rotationKeys.data() + track.rotation.offset;
+        t = referenceKey(times, track.rotation.count, time, key);
+        aiQuaternion rotation = rotations[key];
+        if (t > 0.0f)
+        {
+            const aiQuaternion &a = rotations[key], &b = rotations[key + 1];
+            float s = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z < 0.0f ? -t : t;
+            rotation = aiQuaternion((1.0f - t) * a.w + s * b.w, (1.0f - t) * a.x + s * b.x,
+                                    (1.0f - t) * a.y + s * b.y, (1.0f - t) * a.z + s * b.z);
+            rotation.Normalize();
+        }
+
+        times = clip.scaleTimes.data() + track.scale.offset;
+        const aiVector3D *scales = clip.scaleKeys.data() + track.scale.offset;
+        t = referenceKey(times, track.scale.count, time, key);
+        aiVector3D scale = t > 0.0f ? lerp(scales[key], scales[key + 1], t) : scales[key];
+
+        pose.set(track.bone, position, rotation, scale);
+    }
+}
+
+/**
+ * @brief Reproduz clips a 60 Hz com o cursor e com a busca binária, medindo o custo por bone avaliado.
+ */
+static void measureAnimation(const char *label, const std::vector<AnimationClip> &clips, const LocalPose &bindPose)
+{
+    const float step = 1.0f / 60.0f;
+    size_t evaluated = 0;
+    for (const auto &clip : clips)
+        evaluated += clip.tracks.size() * (static_cast<size_t>(clip.duration / step) + 1);
+    if (evaluated == 0)
+        return;
+
+    LocalPose pose = bindPose, reference = bindPose;
+    AnimationCursor cursor;
+    double cursorMs = measureMs(5, [&]
+    {
+        for (const auto &clip : clips)
+        {
+            for (float time = 0.0f; time <= clip.duration; time += step)
+                sampleAnimationClip(clip, time, cursor, pose);
+        }
+    });
+    double searchMs = measureMs(5, [&]
+    {
+        for (const auto &clip : clips)
+        {
+            for (float time = 0.0f; time <= clip.duration; time += step)
+                referenceSampleClip(clip, time, reference);
+        }
+    });
+
+    // Compara a última pose dos dois caminhos
+    float maxError = 0.0f;
+    const std::vector<float> LocalPose::*channels[] = {&LocalPose::tx, &LocalPose::ty, &LocalPose::tz, &LocalPose::qw,
+                                                       &LocalPose::qx, &LocalPose::qy, &LocalPose::qz, &LocalPose::sx,
+                                                       &LocalPose::sy, &LocalPose::sz};
+    for (auto channel : channels)
+    {
+        for (size_t i = 0; i < pose.size(); i++)
+            maxError = std::max(maxError, std::fabs((pose.*channel)[i] - (reference.*channel)[i]));
+    }
+
+    std::cout << std::setprecision(1) << "  " << std::left << std::setw(24) << label << std::right << std::setw(9)
+              << evaluated << " bones avaliados: cursor " << std::setw(6) << cursorMs * 1e6 / evaluated
+              << " ns/bone, busca binária " << std::setw(6) << searchMs * 1e6 / evaluated << " ns/bone"
+              << std::setprecision(6) << " (erro máx. " << maxError << ")" << std::endl;
+}
+
+static int benchmarkAnimation(const BenchmarkContext &context)
+{
+    std::cout << std::fixed;
+    std::cout << "Animação: amostragem dos clips a 60 Hz" << std::endl;
+    CharacterInstance &character = *context.character;
+    std::vector<AnimationClip> clips(character.getAnimationCount());
+    for (size_t i = 0; i < clips.size(); i++)
+        decompressAnimationClip(character.getAsset()->getAnimation(i), clips[i]);
+    LocalPose pose;
+    bindLocalPose(character.getBoneInfo().data(), character.getBoneInfo().size(), pose);
+    if (clips.empty())
+        std::cout << "  O modelo não possui animações" << std::endl;
+    else
+        measureAnimation("Mita", clips, pose);
+
+    // Esqueletos sintéticos com vários clips, de chaves esparsas (30 por segundo) e densas (120 por segundo)
+    std::mt19937 random(1234);
+    const size_t boneCounts[] = {64, 256, 1024};
+    for (size_t boneCount : boneCounts)
+    {
+        std::vector<int> parents(boneCount);
+        for (size_t i = 0; i < boneCount; i++)
+            parents[i] = i == 0 ? -1 : (i - 1) / 4;
+        std::vector<BoneInfo> bones = syntheticSkeleton(parents);
+        bindLocalPose(bones.data(), bones.size(), pose);
+        for (float keysPerSecond : {30.0f, 120.0f})
+        {
+            clips.clear();
+            for (int c = 0; c < 8; c++)
+                clips.push_back(syntheticClip(boneCount, 2.0f, keysPerSecond, random));
+            std::string label = std::to_string(boneCount) + " bones, " +
+                                std::to_string(static_cast<int>(keysPerSecond)) + " chaves/s";
+            measureAnimation(label.c_str(), clips, pose);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Cria um clip sintético com curvas suaves (senoides) amostradas em intervalos regulares, como em um
+ * clip exportado sem redução de chaves.
+ */
+static AnimationClip smoothSyntheticClip(size_t boneCount, float duration, float keysPerSecond, std::mt19937 &random)
+{
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    AnimationClip clip;
+    clip.name = "sintético suave";
+    clip.duration = duration;
+    uint32_t keyCount = static_cast<uint32_t>(duration * keysPerSecond) + 1;
+    for (size_t b = 0; b < boneCount; b++)
+    {
+        AnimationTrack track;
+        track.bone = b;
+        track.position = {static_cast<uint32_t>(clip.positionTimes.size()), keyCount};
+        track.rotation = {static_cast<uint32_t>(clip.rotationTimes.size()), keyCount};
+        track.scale = {static_cast<uint32_t>(clip.scaleTimes.size()), keyCount};
+        clip.tracks.push_back(track);
+
+        // Só a raiz se desloca; os demais bones giram em torno de um eixo fixo com frequência própria
+        float frequency = 1.0f + 4.0f * unit(random), phase = 6.28f * unit(random), amplitude = unit(random);
+        aiVector3D axis = aiVector3D(unit(random), unit(random), unit(random)).Normalize();
+        for (uint32_t k = 0; k < keyCount; k++)
+        {
+            float t = k / keysPerSecond;
+            float angle = amplitude * std::sin(frequency * t + phase);
+            clip.positionTimes.push_back(t);
+            clip.rotationTimes.push_back(t);
+            clip.scaleTimes.push_back(t);
+            clip.positionKeys.push_back(b == 0 ? aiVector3D(std::sin(t), 0.1f * std::sin(4.0f * t), t) : axis);
+            clip.rotationKeys.emplace_back(std::cos(0.5f * angle), axis.x * std::sin(0.5f * angle),
+                                           axis.y * std::sin(0.5f * angle), axis.z * std::sin(0.5f * angle));
+            clip.scaleKeys.emplace_back(1.0f, 1.0f, 1.0f);
+        }
+    }
+    return clip;
+}
+
+/**
+ * @brief Compacta um clip e imprime a taxa de compressão, o erro em relação ao clip original amostrado a
+ * 60 Hz e o custo por bone da amostragem dos dois formatos.
+ */
+static void measureCompression(const std::string &label, const AnimationClip &clip,
+                               const AnimationCompressionSettings &settings, const LocalPose &bindPose)
+{
+    const float step = 1.0f / 60.0f;
+    size_t frameCount = static_cast<size_t>(clip.duration / step) + 1;
+    size_t evaluated = clip.tracks.size() * frameCount;
+    if (evaluated == 0)
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    CompressedAnimationClip compressed;
+    compressAnimationClip(clip, settings, compressed);
+    std::chrono::duration<double, std::milli> compressMs = std::chrono::steady_clock::now() - start;
+
+    LocalPose original = bindPose, decoded = bindPose;
+    AnimationCursor originalCursor, decodedCursor;
+    double rawMs = measureMs(5, [&]
+    {
+        for (size_t f = 0; f < frameCount; f++)
+            sampleAnimationClip(clip, f * step, originalCursor, original);
+    });
+    double compressedMs = measureMs(5, [&]
+    {
+        for (size_t f = 0; f < frameCount; f++)
+            sampleAnimationClip(compressed, f * step, decodedCursor, decoded);
+    });
+
+    // Erro de posição e de rotação da pose local de cada bone animado, quadro a quadro
+    float positionError = 0.0f, rotationError = 0.0f;
+    for (size_t f = 0; f < frameCount; f++)
+    {
+        sampleAnimationClip(clip, f * step, originalCursor, original);
+        sampleAnimationClip(compressed, f * step, decodedCursor, decoded);
+        for (const AnimationTrack &track : clip.tracks)
+        {
+            size_t b = track.bone;
+            float dx = original.tx[b] - decoded.tx[b], dy = original.ty[b] - decoded.ty[b];
+            float dz = original.tz[b] - decoded.tz[b];
+            positionError = std::max(positionError, std::sqrt(dx * dx + dy * dy + dz * dz));
+            float dot = std::fabs(original.qw[b] * decoded.qw[b] + original.qx[b] * decoded.qx[b] +
+                                  original.qy[b] * decoded.qy[b] + original.qz[b] * decoded.qz[b]);
+            rotationError = std::max(rotationError, 2.0f * std::acos(std::min(1.0f, dot)));
+        }
+    }
+
+    size_t rawKeys = clip.positionKeys.size() + clip.rotationKeys.size() + clip.scaleKeys.size();
+    size_t keptKeys = compressed.positionTimes.size() + compressed.rotationTimes.size() + compressed.scaleTimes.size();
+    std::cout << std::setprecision(1) << "  " << label << ": " << clip.tracks.size() << " bones, " << rawKeys << " -> "
+              << keptKeys << " chaves, " << clip.memoryBytes() / 1024.0 << " -> " << compressed.memoryBytes() / 1024.0
+              << " KB (" << double(clip.memoryBytes()) / compressed.memoryBytes() << "x) em " << compressMs.count()
+              << " ms" << std::endl;
+    std::cout << "    amostragem: float " << rawMs * 1e6 / evaluated << " ns/bone, compactado "
+              << compressedMs * 1e6 / evaluated << " ns/bone; erro máx. " << std::setprecision(5) << positionError
+              << " (posição), " << rotationError << " rad (rotação)" << std::endl;
+}
+
+static int benchmarkAnimationCompression(const BenchmarkContext &context)
+{
+    std::cout << std::fixed;
+    std::cout << "Compressão de animação: tolerâncias " << DEFAULT_ANIMATION_COMPRESSION.positionTolerance
+              << " (posição), " << DEFAULT_ANIMATION_COMPRESSION.rotationTolerance << " rad (rotação), "
+              << DEFAULT_ANIMATION_COMPRESSION.scaleTolerance << " (escala)" << std::endl;
+
+    // Os clips originais não ficam no personagem; são importados de novo a partir do modelo
+    CharacterInstance &character = *context.character;
+    LocalPose pose;
+    bindLocalPose(character.getBoneInfo().data(), character.getBoneInfo().size(), pose);
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(context.modelPath, 0);
+    if (!scene || scene->mNumAnimations == 0)
+        std::cout << "  O modelo não possui animações" << std::endl;
+    for (unsigned int i = 0; scene && i < scene->mNumAnimations; i++)
+    {
+        AnimationClip clip;
+        importAnimationClip(scene->mAnimations[i], character.getAsset()->getBoneNames(), clip);
+        measureCompression("Mita, " + clip.name, clip, DEFAULT_ANIMATION_COMPRESSION, pose);
+    }
+
+    // Clip sintético suave com tolerâncias cada vez maiores
+    std::mt19937 random(1234);
+    const size_t boneCount = 256;
+    std::vector<int> parents(boneCount);
+    for (size_t i = 0; i < boneCount; i++)
+        parents[i] = i == 0 ? -1 : (i - 1) / 4;
+    std::vector<BoneInfo> bones = syntheticSkeleton(parents);
+    bindLocalPose(bones.data(), bones.size(), pose);
+    AnimationClip clip = smoothSyntheticClip(boneCount, 4.0f, 30.0f, random);
+    for (float tolerance : {0.0001f, 0.001f, 0.01f})
+    {
+        std::ostringstream label;
+        label << std::setprecision(4) << "sintético, tolerância " << tolerance;
+        measureCompression(label.str(), clip, {tolerance, tolerance, tolerance}, pose);
+    }
+    return 0;
+}
+
+/**
+ * @brief Pose local de um bone em estrutura intercalada (AoS), usada na avaliação de referência.
+ */
+struct ReferenceBonePose
+{
+    aiVector3D translation; ///< Translação no espaço do pai.
+    aiQuaternion rotation;  ///< Rotação.
+    aiVector3D scale;       ///< Escala.
+};
+
+/**
+ * @brief Avaliação de referência, um bone por vez: cross-fade, camada aditiva e matriz local.
+ */
+static void referenceEvaluatePose(const std::vector<ReferenceBonePose> &from, const std::vector<ReferenceBonePose> &to,
+                                  const std::vector<ReferenceBonePose> &layer, float weight, BoneInfo *bones)
+{
+    for (size_t i = 0; i < from.size(); i++)
+    {
+        const ReferenceBonePose &a = from[i], &b = to[i];
+        aiVector3D translation = a.translation + (b.translation - a.translation) * weight + layer[i].translation;
+        aiVector3D scale = a.scale + (b.scale - a.scale) * weight;
+        scale = aiVector3D(scale.x * layer[i].scale.x, scale.y * layer[i].scale.y, scale.z * layer[i].scale.z);
+
+        float s = a.rotation.w * b.rotation.w + a.rotation.x * b.rotation.x + a.rotation.y * b.rotation.y +
+                  a.rotation.z * b.rotation.z < 0.0f ? -weight : weight;
+        float r = 1.0f - weight;
+        aiQuaternion q(r * a.rotation.w + s * b.rotation.w, r * a.rotation.x + s * b.rotation.x,
+                       r * a.rotation.y + s * b.rotation.y, r * a.rotation.z + s * b.rotation.z);
+        float inv = 1.0f / std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+        const aiQuaternion &l = layer[i].rotation;
+        aiQuaternion rotation(
+            inv * (q.w * l.w - q.x * l.x - q.y * l.y - q.z * l.z), inv * (q.w * l.x + q.x * l.w + q.y * l.z - q.z * l.y),
+            inv * (q.w * l.y - q.x * l.z + q.y * l.w + q.z * l.x), inv * (q.w * l.z + q.x * l.y - q.y * l.x + q.z * l.w));
+        bones[i].localTransform = aiMatrix4x4(scale, rotation, translation);
+    }
+}
+
+/**
+ * @brief Mede a avaliação da pose local (cross-fade, camada aditiva e matrizes) em SoA e em AoS.
+ */
+static void measurePose(size_t boneCount, std::mt19937 &random)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    auto randomRotation = [&]()
+    {
+        float x = 0.5f * unit(random), y = 0.5f * unit(random), z = 0.5f * unit(random);
+        return aiQuaternion(std::sqrt(1.0f - x * x - y * y - z * z), x, y, z);
+    };
+
+    // Duas poses animadas e uma camada aditiva com rotação em um a cada 8 bones (ex.: olhar, respiração)
+    LocalPose from, to, layer, pose;
+    from.setIdentity(boneCount);
+    to.setIdentity(boneCount);
+    layer.setIdentity(boneCount);
+    std::vector<ReferenceBonePose> referenceFrom(boneCount), referenceTo(boneCount), referenceLayer(boneCount);
+    for (size_t i = 0; i < boneCount; i++)
+    {
+        aiVector3D one(1.0f, 1.0f, 1.0f), zero(0.0f, 0.0f, 0.0f);
+        referenceFrom[i] = {aiVector3D(unit(random), unit(random), unit(random)), randomRotation(), one};
+        referenceTo[i] = {aiVector3D(unit(random), unit(random), unit(random)), randomRotation(), one};
+        referenceLayer[i] = {zero, i % 8 == 0 ? randomRotation() : aiQuaternion(), one};
+        from.set(i, referenceFrom[i].translation, referenceFrom[i].rotation, one);
+        to.set(i, referenceTo[i].translation, referenceTo[i].rotation, one);
+        layer.setRotation(i, referenceLayer[i].rotation);
+    }
+
+    const int iterations = std::max<int>(100, 2000000 / boneCount);
+    const float weight = 0.3f;
+    std::vector<BoneInfo> bones(boneCount), reference(boneCount);
+    double blendMs = measureMs(iterations, [&] { blendLocalPoses(from, to, weight, pose); });
+    double addMs = measureMs(iterations, [&] { addLocalPose(pose, layer, 1.0f); });
+    double matrixMs = measureMs(iterations, [&] { localPoseToTransforms(pose, bones.data()); });
+    double soaMs = measureMs(iterations, [&]
+    {
+        blendLocalPoses(from, to, weight, pose);
+        addLocalPose(pose, layer, 1.0f);
+        localPoseToTransforms(pose, bones.data());
+    });
+    double aosMs = measureMs(iterations, [&]
+    {
+        referenceEvaluatePose(referenceFrom, referenceTo, referenceLayer, weight, reference.data());
+    });
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < boneCount; i++)
+    {
+        for (unsigned int r = 0; r < 3; r++)
+            for (unsigned int c = 0; c < 4; c++)
+                maxError = std::max(maxError, std::fabs(bones[i].localTransform[r][c] - reference[i].localTransform[r][c]));
+    }
+
+    double perBone = 1e6 / boneCount;
+    std::cout << std::setprecision(2) << "  " << std::setw(5) << boneCount << " bones: SoA " << soaMs * perBone
+              << " ns/bone (mistura " << blendMs * perBone << ", aditiva " << addMs * perBone << ", matrizes "
+              << matrixMs * perBone << "), AoS " << aosMs * perBone << " ns/bone (" << aosMs / soaMs
+              << "x, erro máx. " << std::setprecision(6) << maxError << ")" << std::endl;
+}
+
+static int benchmarkPose(const BenchmarkContext &context)
+{
+    std::cout << std::fixed;
+    std::cout << "Pose local: cross-fade de dois clips, camada aditiva e montagem das matrizes" << std::endl;
+    std::mt19937 random(1234);
+    measurePose(context.character->getBoneInfo().size(), random);
+    for (size_t boneCount : {64, 256, 1024, 4096})
+        measurePose(boneCount, random);
+    return 0;
+}
+
+/**
+ * @brief Desenha o personagem uma vez por instância da multidão, cada uma com sua transformação e uma paleta
+ * própria (a cabeça gira em cada cópia), como seria sem instanciamento.
+ */
+static void drawCrowdSeparately(const BenchmarkContext &context, const Crowd &crowd, BoneHandle head, int frame)
+{
+    CharacterInstance &character = *context.character;
+    const std::vector<CrowdInstance> &instances = crowd.getInstances();
+    for (size_t i = 0; i < instances.size(); i++)
+    {
+        float angle = glm::radians(30.0f) * std::sin(frame * 0.05f + i);
+        character.rotateBone(head, glm::angleAxis(angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+        glPushMatrix();
+        glTranslatef(instances[i].position.x, instances[i].position.y, instances[i].position.z);
+        glRotatef(glm::degrees(instances[i].heading), 0.0f, 0.0f, 1.0f);
+        character.update();
+        character.draw();
+        glPopMatrix();
+    }
+}
+
+static int benchmarkCrowd(const BenchmarkContext &context)
+{
+    CharacterInstance &character = *context.character;
+    SkinningMode previousMode = character.getSkinningMode();
+    if (!character.setSkinningMode(SkinningMode::GPU))
+    {
+        std::cerr << "Skinning na GPU não suportado neste contexto OpenGL" << std::endl;
+        return -1;
+    }
+
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+    glfwSwapInterval(0);
+    BoneHandle head = character.findBone("Head");
+    Crowd crowd;
+    crowd.setThreadPool(context.threadPool);
+    crowd.setCamera(context.camera);
+    const float deltaTime = 1.0f / 60.0f;
+
+    // O atlas de impostores é gerado uma vez e compartilhado por todas as quantidades de instâncias
+    ImpostorAtlas atlas;
+    if (!atlas.bake(character.getAsset()))
+        std::cerr << "Impostores indisponíveis, medindo só a malha instanciada" << std::endl;
+
+    std::cout << std::fixed;
+    for (size_t count : {1, 10, 100, 1000, 10000})
+    {
+        if (!crowd.create(character.getAsset(), count))
+            return -1;
+        const int frames = count >= 10000 ? 20 : count >= 1000 ? 60 : 200;
+        double perFrame = 1.0 / (frames + 1);
+
+        // Atualização (animação e paletas) isolada, com a pose de todas as instâncias avaliada a cada quadro e
+        // com a frequência reduzida pelo LOD; o pico mostra se as avaliações ficaram distribuídas pelos quadros
+        crowd.setAnimationLod(false);
+        double fullUpdateMs = measureMs(frames, [&] { crowd.update(deltaTime); });
+        crowd.setAnimationLod(true);
+        double peakMs = 0.0;
+        size_t evaluated = 0;
+        double updateMs = measureMs(frames, [&]
+        {
+            auto start = std::chrono::steady_clock::now();
+            crowd.update(deltaTime);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            peakMs = std::max(peakMs, elapsed.count());
+            evaluated += crowd.getEvaluatedCount();
+        });
+        renderStats.reset();
+        double frameMs = measureMs(frames, [&]
+        {
+            crowd.update(deltaTime);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            context.camera->applyCamera();
+            context.background->draw();
+            crowd.draw();
+            glfwSwapBuffers(context.window);
+            glFinish();
+        });
+        std::cout << std::setprecision(2) << "  " << std::setw(5) << count << " instâncias: " << frameMs
+                  << " ms/quadro (" << 1000.0 / frameMs << " FPS), " << std::setprecision(1)
+                  << renderStats.drawCalls * perFrame << " desenhos e " << renderStats.triangles * perFrame / 1e6
+                  << " M triângulos por quadro" << std::endl;
+        std::cout << std::setprecision(3) << "         atualização: " << fullUpdateMs << " ms com todas as poses, "
+                  << updateMs << " ms com o LOD da animação (pico " << peakMs << " ms, " << std::setprecision(1)
+                  << evaluated * perFrame << " poses avaliadas por quadro)" << std::endl;
+
+        // Mesmo quadro com as instâncias pequenas na tela desenhadas como impostores
+        if (atlas.isReady())
+        {
+            crowd.setImpostors(&atlas);
+            size_t impostorCount = 0;
+            renderStats.reset();
+            double impostorMs = measureMs(frames, [&]
+            {
+                crowd.update(deltaTime);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                context.camera->applyCamera();
+                context.background->draw();
+                crowd.draw();
+                glfwSwapBuffers(context.window);
+                glFinish();
+                impostorCount = crowd.getImpostorCount();
+            });
+            crowd.setImpostors(nullptr);
+            std::cout << std::setprecision(2) << "         com impostores: " << impostorMs << " ms/quadro ("
+                      << 1000.0 / impostorMs << " FPS), " << impostorCount << " impostores, " << std::setprecision(1)
+                      << renderStats.drawCalls * perFrame << " desenhos e " << renderStats.triangles * perFrame / 1e6
+                      << " M triângulos por quadro" << std::endl;
+        }
+
+        // Sem instanciamento: um draw() do personagem por instância, com a paleta reenviada a cada um
+        if (count > 1000)
+            continue;
+        int frame = 0;
+        renderStats.reset();
+        double separateMs = measureMs(frames, [&]
+        {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            context.camera->applyCamera();
+            context.background->draw();
+            drawCrowdSeparately(context, crowd, head, frame++);
+            glfwSwapBuffers(context.window);
+            glFinish();
+        });
+        std::cout << std::setprecision(2) << "         sem instanciamento: " << separateMs << " ms/quadro ("
+                  << 1000.0 / separateMs << " FPS), " << std::setprecision(1) << renderStats.drawCalls * perFrame
+                  << " desenhos por quadro" << std::endl;
+    }
+
+    crowd.destroy();
+    atlas.destroy();
+    character.setSkinningMode(previousMode);
+    return 0;
+}
+
+/**
+ * @brief Conta os vértices do skinning de referência fora da caixa do seu submesh e a maior distância até ela.
+ */
+static void checkSubmeshBounds(const CharacterInstance &character, size_t &outside, size_t &total, float &maxDistance)
+{
+    const std::vector<SubMesh> &submeshes = character.getAsset()->getSubmeshes();
+    const BoundingBoxes &bounds = character.getSubmeshBounds();
+    outside = total = 0;
+    maxDistance = 0.0f;
+    for (size_t i = 0; i < submeshes.size(); i++)
+    {
+        std::vector<float> positions(submeshes[i].vertices.size() * 3);
+        referenceSkinning(submeshes[i], character.getBoneInfo(), positions.data());
+        glm::vec3 minimum, maximum;
+        bounds.get(i, minimum, maximum);
+        for (size_t v = 0; v < positions.size(); v += 3)
+        {
+            glm::vec3 position(positions[v], positions[v + 1], positions[v + 2]);
+            glm::vec3 distance = glm::max(glm::max(minimum - position, position - maximum), glm::vec3(0.0f));
+            float length = glm::length(distance);
+            maxDistance = std::max(maxDistance, length);
+            outside += length > 0.0f;
+            total++;
+        }
+    }
+}
+
+static int benchmarkCulling(const BenchmarkContext &context)
+{
+    const int frames = 300;
+    CharacterInstance &character = *context.character;
+    SkinningMode previousMode = character.getSkinningMode();
+    std::cout << std::fixed;
+
+    // As caixas dos submeshes precisam conter todos os vértices da pose; as posições quantizadas e o
+    // arredondamento dos pesos podem deixar alguns vértices a uma distância desprezível da caixa
+    poseCharacter(character);
+    size_t outside, total;
+    float maxDistance;
+    checkSubmeshBounds(character, outside, total, maxDistance);
+    glm::vec3 center;
+    float radius;
+    character.getAsset()->getBounds(center, radius);
+    std::cout << std::setprecision(6) << "Caixas dos submeshes: " << outside << " de " << total
+              << " vértices fora (distância máx. " << maxDistance / radius << " do raio do modelo), "
+              << character.getAsset()->getBoneBounds().size() << " caixas de bones em "
+              << character.getAsset()->getSubmeshes().size() << " submeshes" << std::endl;
+
+    // Custo do teste das caixas contra o frustum, com caixas espalhadas em volta da câmera
+    const size_t boxCount = 100000;
+    BoundingBoxes boxes;
+    boxes.resize(boxCount);
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f), size(0.5f, 20.0f);
+    for (size_t i = 0; i < boxCount; i++)
+    {
+        glm::vec3 minimum(coordinate(random), coordinate(random), coordinate(random));
+        boxes.set(i, minimum, minimum + glm::vec3(size(random), size(random), size(random)));
+    }
+    std::vector<uint8_t> visible(boxCount);
+    glm::vec4 planes[6];
+    context.camera->frustumPlanes(planes);
+    double cullMs = measureMs(200, [&] { cullBoxes(planes, boxes, 0, boxCount, visible.data()); });
+    size_t visibleCount = std::count(visible.begin(), visible.end(), 1);
+    std::cout << std::setprecision(2) << "Teste de " << boxCount << " caixas: " << cullMs * 1e6 / boxCount
+              << " ns por caixa, " << visibleCount << " visíveis" << std::endl;
+
+    // Mesma animação com a câmera da cena e com um close no rosto, em que a maior parte dos submeshes fica
+    // fora do frustum. O LOD fica fixo para que só o descarte mude entre as configurações
+    glfwSwapInterval(0);
+    character.setForcedLod(0);
+    BoneHandle head = character.findBone("Head");
+    double perFrame = 1.0 / (frames + 1);
+    Camera3D closeUp(0.0, -3.0, 16.0, 90.0, 0.0, 0.0, 50.0, 36.0, 800.0 / 600.0, 0.1, 1000.0);
+    int width, height;
+    glfwGetFramebufferSize(context.window, &width, &height);
+    closeUp.setViewportSize(width, height);
+    struct CullingConfig
+    {
+        const char *label;
+        const Camera3D *view;
+        const Camera3D *culling;
+    };
+    const CullingConfig configs[] = {{"cena, sem descarte ", context.camera, nullptr},
+                                     {"cena, com descarte ", context.camera, context.camera},
+                                     {"close, sem descarte", &closeUp, nullptr},
+                                     {"close, com descarte", &closeUp, &closeUp}};
+    const SkinningMode modes[] = {SkinningMode::CPU, SkinningMode::GPU};
+    for (SkinningMode mode : modes)
+    {
+        if (!character.setSkinningMode(mode))
+            continue;
+        std::cout << (mode == SkinningMode::CPU ? "Skinning na CPU:" : "Skinning na GPU:") << std::endl;
+        for (const CullingConfig &config : configs)
+        {
+            character.setCamera(config.culling);
+            renderStats.reset();
+            int frame = 0;
+            double frameMs = measureMs(frames, [&]
+            {
+                float angle = glm::radians(30.0f) * std::sin(frame++ * 0.05f);
+                character.rotateBone(head, glm::angleAxis(angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                config.view->applyCamera();
+                context.background->draw();
+                character.update();
+                character.draw();
+                glfwSwapBuffers(context.window);
+                glFinish();
+            });
+            std::cout << std::setprecision(3) << "  " << config.label << "  " << frameMs << " ms/quadro, "
+                      << std::setprecision(1) << renderStats.drawCalls * perFrame << " desenhos, "
+                      << renderStats.triangles * perFrame << " triângulos e " << renderStats.culledSubmeshes * perFrame
+                      << " submeshes descartados por quadro" << std::endl;
+        }
+    }
+    character.setCamera(context.camera);
+    character.setForcedLod(-1);
+    character.setSkinningMode(previousMode);
+
+    // Multidão com e sem o descarte das instâncias fora do frustum da câmera da cena
+    Crowd crowd;
+    crowd.setThreadPool(context.threadPool);
+    crowd.setCamera(context.camera);
+    if (!crowd.create(character.getAsset(), 10000))
+        return 0;
+    const int crowdFrames = 20;
+    for (bool culling : {false, true})
+    {
+        crowd.setFrustumCulling(culling);
+        renderStats.reset();
+        double updateMs = 0.0;
+        double frameMs = measureMs(crowdFrames, [&]
+        {
+            auto start = std::chrono::steady_clock::now();
+            crowd.update(1.0f / 60.0f);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            updateMs += elapsed.count();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            context.camera->applyCamera();
+            context.background->draw();
+            crowd.draw();
+            glfwSwapBuffers(context.window);
+            glFinish();
+        });
+        std::cout << std::setprecision(2) << "Multidão de " << crowd.size() << (culling ? ", com descarte: " : ", sem descarte: ")
+                  << frameMs << " ms/quadro (atualização " << updateMs / (crowdFrames + 1) << " ms), "
+                  << crowd.getCulledCount() << " instâncias descartadas, " << std::setprecision(1)
+                  << renderStats.triangles / (crowdFrames + 1.0) / 1e6 << " M triângulos por quadro" << std::endl;
+    }
+    crowd.destroy();
+    return 0;
+}
+
+static int benchmarkOcclusion(const BenchmarkContext &context)
+{
+    CharacterInstance &character = *context.character;
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+    std::cout << "Buffer de oclusão: " << OCCLUSION_WIDTH << "x" << OCCLUSION_HEIGHT << ", oclusor de "
+              << character.getAsset()->getOccluderIndices().size() / 3 << " triângulos por instância, "
+              << context.threadPool->size() << " thread(s)" << std::endl;
+    glfwSwapInterval(0);
+
+    // O fundo é o oclusor fixo, como em --occlusion
+    glm::vec3 corners[4];
+    context.background->getCorners(corners);
+    std::vector<glm::vec3> backgroundPositions(corners, corners + 4);
+    const std::vector<uint32_t> backgroundIndices = {0, 1, 2, 0, 2, 3};
+
+    std::cout << std::fixed;
+    for (size_t count : {100, 1000, 10000})
+    {
+        Crowd crowd;
+        crowd.setThreadPool(context.threadPool);
+        crowd.setCamera(context.camera);
+        crowd.addStaticOccluder(backgroundPositions, backgroundIndices);
+        if (!crowd.create(character.getAsset(), count))
+            return -1;
+        const int frames = count >= 10000 ? 20 : 60;
+        double perFrame = 1.0 / (frames + 1);
+        std::cout << "  " << count << " instâncias:" << std::endl;
+
+        // Só o frustum, o fundo como único oclusor e o fundo com as instâncias mais próximas
+        const size_t occluderCounts[] = {0, 0, 4, CROWD_MAX_OCCLUDERS, 64};
+        for (int config = 0; config < 5; config++)
+        {
+            crowd.setOcclusionCulling(config > 0, occluderCounts[config]);
+            renderStats.reset();
+            double updateMs = 0.0, occlusionMs = 0.0;
+            size_t culled = 0, occluded = 0, occluderTriangles = 0;
+            double frameMs = measureMs(frames, [&]
+            {
+                auto start = std::chrono::steady_clock::now();
+                crowd.update(1.0f / 60.0f);
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                updateMs += elapsed.count();
+                occlusionMs += crowd.getOcclusionTime();
+                culled += crowd.getCulledCount();
+                occluded += crowd.getOccludedCount();
+                occluderTriangles += crowd.getOcclusionCulling() ? crowd.getOcclusionBuffer().getTriangleCount() : 0;
+
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                context.camera->applyCamera();
+                context.background->draw();
+                crowd.draw();
+                glfwSwapBuffers(context.window);
+                glFinish();
+            });
+            if (config == 0)
+                std::cout << "    só frustum:          ";
+            else
+                std::cout << "    fundo + " << std::setw(2) << occluderCounts[config] << " oclusores: ";
+            std::cout << std::setprecision(2) << frameMs << " ms/quadro, atualização " << updateMs * perFrame
+                      << " ms (oclusão " << occlusionMs * perFrame << " ms, " << std::setprecision(0)
+                      << occluderTriangles * perFrame << " triângulos rasterizados), " << std::setprecision(1)
+                      << 100.0 * culled * perFrame / count << "% descartadas (" << 100.0 * occluded * perFrame / count
+                      << "% por oclusão), " << renderStats.triangles * perFrame / 1e6 << " M triângulos por quadro"
+                      << std::endl;
+        }
+        crowd.destroy();
+    }
+    return 0;
+}
+
+int runBenchmark(const std::string &name, const BenchmarkContext &context)
+{
+    if (name == "skinning")
+        return benchmarkSkinning(context);
+    if (name == "scaling")
+        return benchmarkScaling(context);
+    if (name == "render")
+        return benchmarkRender(context);
+    if (name == "gpuskinning")
+        return benchmarkGpuSkinning(context);
+    if (name == "skeleton")
+        return benchmarkSkeleton(context);
+    if (name == "bones")
+        return benchmarkBones(context);
+    if (name == "vertexformat")
+        return benchmarkVertexFormat(context);
+    if (name == "lod")
+        return benchmarkLod(context);
+    if (name == "meshlets")
+        return benchmarkMeshlets(context);
+    if (name == "animation")
+        return benchmarkAnimation(context);
+    if (name == "animcompression")
+        return benchmarkAnimationCompression(context);
+    if (name == "pose")
+        return benchmarkPose(context);
+    if (name == "crowd")
+        return benchmarkCrowd(context);
+    if (name == "culling")
+        return benchmarkCulling(context);
+    if (name == "occlusion")
+        return benchmarkOcclusion(context);
+
+    std::cerr << "Benchmark desconhecido: " << name << std::endl;
+    return -1;
+}
@@ -0,0 +1,49 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <string>
+#include "characterinstance.hpp"
+#include "camera3d.hpp"
+#include "background.hpp"
+#include "threadpool.hpp"
+
+/**
+ * @brief Objetos da cena disponíveis para os benchmarks.
+ */
+struct BenchmarkContext
+{
+    GLFWwindow *window;           ///< Janela com o contexto OpenGL ativo.
+    Camera3D *camera;             ///< Câmera da cena.
+    CharacterInstance *character; ///< Personagem com o asset já carregado.
+    Background *background;       ///< Fundo já carregado.
+    ThreadPool *threadPool;       ///< Pool de threads configurado pela linha de comando.
+    const char *modelPath;        ///< Arquivo de onde o personagem foi carregado.
+};
+
+/**
+ * @brief Executa um benchmark pelo nome, imprimindo os resultados no terminal.
+ *
+ * Benchmarks disponíveis:
+ * - skinning: compara o skinning original (Vertex por Vertex) com os kernels SoA escalar, SSE2 e AVX2.
+ * - scaling: mede o skinning paralelo de 1 a N threads no modelo carregado e em um modelo sintético grande.
+ * - render: mede o tempo de quadro e as chamadas ao driver da cena completa, com a pose animada e parada (use LIBGL_ALWAYS_SOFTWARE=1 para o llvmpipe).
+ * - gpuskinning: compara a imagem do skinning na CPU com a do vertex shader e mede o tempo de quadro de cada um.
+ * - skeleton: compara a atualização recursiva dos bones com a passada linear, na Mita e em hierarquias sintéticas profundas.
+ * - bones: compara a busca de bones por nome (std::map e tabela plana) com o uso de BoneHandle.
+ * - vertexformat: compara a memória por submesh e o tempo de skinning dos formatos de vértices float e quantizado.
+ * - lod: mede a geração dos LODs de cada submesh, os triângulos de cada nível e o tempo de quadro com cada um.
+ * - meshlets: compara o tempo de quadro e os triângulos enviados sem descarte, com o frustum e com os cones de normais.
+ * - animation: mede o custo por bone da amostragem dos clips com cursor e com busca binária, na Mita e em esqueletos sintéticos.
+ * - animcompression: mede a taxa de compressão, o erro e o custo por bone da amostragem de cada clip compactado.
+ * - pose: compara a avaliação da pose local (cross-fade, camada aditiva e matrizes) em SoA com SSE2 e bone a bone em AoS.
+ * - crowd: mede o tempo de quadro da multidão instanciada de 1 a 10000 instâncias, a atualização com e sem o LOD da animação, o quadro com impostores e, até 1000, o desenho de uma cópia por vez.
+ * - culling: confere as caixas dos submeshes na pose atual, mede o teste das caixas contra o frustum e o quadro com e sem descarte do personagem (câmera da cena e close) e de 10000 instâncias.
+ * - occlusion: mede, em multidões de 100 a 10000 instâncias, a taxa de descarte por oclusão e o custo na CPU do buffer de profundidade com o fundo e 0 a 64 instâncias como oclusores.
+ *
+ * @param name Nome do benchmark.
+ * @param context Objetos da cena já inicializados.
+ * @return 0 em caso de sucesso, -1 se o benchmark não existir.
+ */
+int runBenchmark(const std::string &name, const BenchmarkContext &context);
+
+#endif
@@ -0,0 +1,81 @@
+#include "bonenametable.hpp"
+
+void BoneNameTable::clear()
+{
+    names.clear();
+    hashes.clear();
+    slots.clear();
+}
+
+int BoneNameTable::find(uint32_t hash, std::string_view name) const
+{
+    if (slots.empty())
+        return -1;
+
+    size_t mask = slots.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+    {
+        int index = slots[slot];
+        if (index < 0)
+            return -1;
+        if (hashes[index] == hash && names[index] == name)
+            return index;
+    }
+}
+
+int BoneNameTable::insert(std::string_view name)
+{
+    uint32_t hash = boneNameHash(name);
+    int existing = find(hash, name);
+    if (existing >= 0)
+        return existing;
+
+    int index = names.size();
+    names.emplace_back(name);
+    hashes.push_back(hash);
+
+    // Mantém a ocupação em no máximo 50%, para que as sondagens sejam curtas
+    if (names.size() * 2 > slots.size())
+    {
+        rehash();
+        return index;
+    }
+
+    size_t mask = slots.size() - 1;
+    size_t slot = hash & mask;
+    while (slots[slot] >= 0)
+        slot = (slot + 1) & mask;
+    slots[slot] = index;
+    return index;
+}
+
+void BoneNameTable::renumber(const std::vector<int> &remap)
+{
+    std::vector<std::string> renumberedNames(names.size());
+    std::vector<uint32_t> renumberedHashes(hashes.size());
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        renumberedNames[remap[i]] = std::move(names[i]);
+        renumberedHashes[remap[i]] = hashes[i];
+    }
+    names.swap(renumberedNames);
+    hashes.swap(renumberedHashes);
+    rehash();
+}
+
+void BoneNameTable::rehash()
+{
+    size_t capacity = 16;
+    while (capacity < names.size() * 2)
+        capacity *= 2;
+
+    slots.assign(capacity, -1);
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        size_t slot = hashes[i] & mask;
+        while (slots[slot] >= 0)
+            slot = (slot + 1) & mask;
+        slots[slot] = i;
+    }
+}
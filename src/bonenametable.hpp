@@ -0,0 +1,91 @@
+#ifndef BONENAMETABLE_HPP
+#define BONENAMETABLE_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+/**
+ * @brief Hash FNV-1a de 32 bits de um nome de bone.
+ *
+ * É constexpr, então nomes fixos podem ser resolvidos em tempo de compilação:
+ * @code
+ * constexpr uint32_t HEAD = boneNameHash("Head");
+ * @endcode
+ */
+constexpr uint32_t boneNameHash(std::string_view name)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Tabela hash plana (endereçamento aberto) de nome de bone para índice.
+ *
+ * Os nomes ficam em um vetor indexado pelo índice do bone e a tabela guarda apenas índices, em
+ * slots contíguos com sondagem linear. A busca não aloca memória e só compara strings quando os
+ * hashes coincidem.
+ */
+class BoneNameTable
+{
+private:
+    std::vector<std::string> names; ///< Nome de cada bone, pelo índice.
+    std::vector<uint32_t> hashes;   ///< Hash do nome de cada bone, pelo índice.
+    std::vector<int32_t> slots;     ///< Índice do bone em cada slot (-1 se vazio); tamanho potência de 2.
+
+public:
+    /**
+     * @brief Remove todos os nomes.
+     */
+    void clear();
+
+    /**
+     * @brief Quantidade de nomes registrados.
+     */
+    size_t size() const { return names.size(); }
+
+    /**
+     * @brief Procura o índice de um bone pelo nome.
+     * @return Índice do bone, ou -1 se não existir.
+     */
+    int find(std::string_view name) const { return find(boneNameHash(name), name); }
+
+    /**
+     * @brief Procura o índice de um bone com o hash já calculado (ex.: em tempo de compilação).
+     * @param hash boneNameHash(name).
+     * @param name Nome do bone.
+     * @return Índice do bone, ou -1 se não existir.
+     */
+    int find(uint32_t hash, std::string_view name) const;
+
+    /**
+     * @brief Registra um nome com o próximo índice livre (size()).
+     * @return Índice do bone; se o nome já existir, o índice existente.
+     */
+    int insert(std::string_view name);
+
+    /**
+     * @brief Retorna o nome de um bone.
+     */
+    const std::string &name(int index) const { return names[index]; }
+
+    /**
+     * @brief Renumera os bones após uma reordenação.
+     * @param remap Novo índice de cada bone, indexado pelo índice anterior.
+     */
+    void renumber(const std::vector<int> &remap);
+
+private:
+    /**
+     * @brief Reconstrói os slots com capacidade para pelo menos o dobro dos nomes registrados.
+     */
+    void rehash();
+};
+
+#endif
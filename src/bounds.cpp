@@ -0,0 +1,106 @@
+#include "bounds.hpp"
+#include "skinning.hpp"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BOUNDS_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+void buildBoneBounds(const SkinningStreams &stream, size_t matrixCount, std::vector<BoneBounds> &bounds)
+{
+    // Caixa de cada matriz da paleta; só as que influenciam algum vértice com peso positivo são gravadas
+    std::vector<BoneBounds> boxes(matrixCount);
+    std::vector<char> used(matrixCount, 0);
+    for (size_t i = 0; i < stream.size(); i++)
+    {
+        glm::vec3 position;
+        stream.position(i, position.x, position.y, position.z);
+        for (int k = 0; k < 4; k++)
+        {
+            int matrix = stream.boneID(i, k);
+            if (stream.weight(i, k) == 0.0f || matrix >= static_cast<int>(matrixCount))
+                continue;
+            BoneBounds &box = boxes[matrix];
+            box.minimum = used[matrix] ? glm::min(box.minimum, position) : position;
+            box.maximum = used[matrix] ? glm::max(box.maximum, position) : position;
+            used[matrix] = 1;
+        }
+    }
+    for (size_t matrix = 0; matrix < matrixCount; matrix++)
+    {
+        if (!used[matrix])
+            continue;
+        boxes[matrix].matrix = static_cast<uint32_t>(matrix);
+        bounds.push_back(boxes[matrix]);
+    }
+}
+
+void skinnedBounds(const BoneBounds *bounds, size_t count, const float *palette, glm::vec3 &minimum,
+                   glm::vec3 &maximum)
+{
+    minimum = maximum = glm::vec3(0.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        // O centro é transformado pela matriz e a meia extensão pelos valores absolutos dos seus termos
+        // (Arvo), o que dá a menor caixa alinhada aos eixos que contém a caixa transformada
+        const BoneBounds &box = bounds[i];
+        const float *m = palette + box.matrix * SKINNING_PALETTE_STRIDE;
+        glm::vec3 c = (box.minimum + box.maximum) * 0.5f, e = (box.maximum - box.minimum) * 0.5f;
+        glm::vec3 center, extent;
+        for (int row = 0; row < 3; row++)
+        {
+            center[row] = m[row] * c.x + m[4 + row] * c.y + m[8 + row] * c.z + m[12 + row];
+            extent[row] = std::fabs(m[row]) * e.x + std::fabs(m[4 + row]) * e.y + std::fabs(m[8 + row]) * e.z;
+        }
+        minimum = i == 0 ? center - extent : glm::min(minimum, center - extent);
+        maximum = i == 0 ? center + extent : glm::max(maximum, center + extent);
+    }
+}
+
+void cullBoxes(const glm::vec4 planes[6], const BoundingBoxes &boxes, size_t begin, size_t end, uint8_t *visible)
+{
+    // Canto mais à frente de cada plano: o máximo nos eixos em que a normal é positiva, o mínimo nos demais
+    const float *cornerX[6], *cornerY[6], *cornerZ[6];
+    for (int p = 0; p < 6; p++)
+    {
+        cornerX[p] = planes[p].x >= 0.0f ? boxes.maxX.data() : boxes.minX.data();
+        cornerY[p] = planes[p].y >= 0.0f ? boxes.maxY.data() : boxes.minY.data();
+        cornerZ[p] = planes[p].z >= 0.0f ? boxes.maxZ.data() : boxes.minZ.data();
+    }
+
+    size_t i = begin;
+#ifdef BOUNDS_HAS_SSE2
+    __m128 nx[6], ny[6], nz[6], nw[6];
+    for (int p = 0; p < 6; p++)
+    {
+        nx[p] = _mm_set1_ps(planes[p].x);
+        ny[p] = _mm_set1_ps(planes[p].y);
+        nz[p] = _mm_set1_ps(planes[p].z);
+        nw[p] = _mm_set1_ps(planes[p].w);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(nx[p], _mm_loadu_ps(cornerX[p] + i)),
+                                         _mm_mul_ps(ny[p], _mm_loadu_ps(cornerY[p] + i)));
+            distance = _mm_add_ps(distance, _mm_add_ps(_mm_mul_ps(nz[p], _mm_loadu_ps(cornerZ[p] + i)), nw[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; k++)
+            visible[i + k] = (mask >> k) & 1;
+    }
+#endif
+    for (; i < end; i++)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; p++)
+            inside = planes[p].x * cornerX[p][i] + planes[p].y * cornerY[p][i] + planes[p].z * cornerZ[p][i] +
+                         planes[p].w >= 0.0f;
+        visible[i] = inside;
+    }
+}
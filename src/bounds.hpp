@@ -0,0 +1,105 @@
+#ifndef BOUNDS_HPP
+#define BOUNDS_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+struct SkinningStreams;
+
+/**
+ * @brief Caixa, na bind pose, dos vértices de um submesh influenciados por uma matriz da paleta.
+ *
+ * Como cada vértice após o skinning é uma média ponderada dos seus transformados pelas matrizes que o
+ * influenciam, ele fica dentro da união das caixas dessas matrizes transformadas pela pose atual.
+ */
+struct BoneBounds
+{
+    uint32_t matrix;   ///< Índice da matriz na paleta (o último é a identidade dos vértices sem bones).
+    glm::vec3 minimum; ///< Canto mínimo da caixa.
+    glm::vec3 maximum; ///< Canto máximo da caixa.
+};
+
+/**
+ * @brief Caixas alinhadas aos eixos em estrutura de arrays, testadas contra o frustum 4 de cada vez.
+ */
+struct BoundingBoxes
+{
+    std::vector<float> minX, minY, minZ; ///< Cantos mínimos.
+    std::vector<float> maxX, maxY, maxZ; ///< Cantos máximos.
+
+    /**
+     * @brief Quantidade de caixas.
+     */
+    size_t size() const { return minX.size(); }
+
+    /**
+     * @brief Redimensiona todos os arrays.
+     */
+    void resize(size_t count)
+    {
+        for (std::vector<float> *array : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ})
+            array->resize(count);
+    }
+
+    /**
+     * @brief Grava uma caixa.
+     */
+    void set(size_t i, const glm::vec3 &minimum, const glm::vec3 &maximum)
+    {
+        minX[i] = minimum.x;
+        minY[i] = minimum.y;
+        minZ[i] = minimum.z;
+        maxX[i] = maximum.x;
+        maxY[i] = maximum.y;
+        maxZ[i] = maximum.z;
+    }
+
+    /**
+     * @brief Lê uma caixa.
+     */
+    void get(size_t i, glm::vec3 &minimum, glm::vec3 &maximum) const
+    {
+        minimum = glm::vec3(minX[i], minY[i], minZ[i]);
+        maximum = glm::vec3(maxX[i], maxY[i], maxZ[i]);
+    }
+};
+
+/**
+ * @brief Calcula as caixas de cada matriz da paleta que influencia os vértices de um submesh.
+ *
+ * As posições são as decodificadas dos streams, as mesmas vistas pelos kernels e pelo vertex shader.
+ *
+ * @param stream Streams de skinning do submesh.
+ * @param matrixCount Quantidade de matrizes da paleta (bones + identidade).
+ * @param bounds Caixas das matrizes usadas, acrescentadas ao fim em ordem de matriz.
+ */
+void buildBoneBounds(const SkinningStreams &stream, size_t matrixCount, std::vector<BoneBounds> &bounds);
+
+/**
+ * @brief Caixa conservadora, na pose de uma paleta, dos vértices cobertos por um conjunto de caixas.
+ * @param bounds Caixas da bind pose.
+ * @param count Quantidade de caixas.
+ * @param palette Paleta no formato do kernel de skinning (SKINNING_PALETTE_STRIDE floats por matriz).
+ * @param minimum Canto mínimo resultante.
+ * @param maximum Canto máximo resultante.
+ */
+void skinnedBounds(const BoneBounds *bounds, size_t count, const float *palette, glm::vec3 &minimum,
+                   glm::vec3 &maximum);
+
+/**
+ * @brief Testa um intervalo de caixas contra os planos do frustum, 4 caixas por iteração com SSE2.
+ *
+ * Para cada plano, o canto mais à frente da caixa é escolhido pelos sinais da normal, o mesmo para
+ * todas as caixas; a caixa é descartada se esse canto estiver atrás de algum plano.
+ *
+ * @param planes Planos do frustum, com as normais apontando para dentro (Camera3D::frustumPlanes()).
+ * @param boxes Caixas.
+ * @param begin Primeira caixa do intervalo.
+ * @param end Caixa seguinte à última do intervalo.
+ * @param visible Resultado de cada caixa do intervalo (1 se pode estar visível), a partir de visible[begin].
+ */
+void cullBoxes(const glm::vec4 planes[6], const BoundingBoxes &boxes, size_t begin, size_t end, uint8_t *visible);
+
+#endif
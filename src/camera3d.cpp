@@ -3,7 +3,7 @@
 Camera3D::Camera3D(double eyeX, double eyeY, double eyeZ, double rotX, double rotY, double rotZ,
                    double focalLength, double sensorSize, double aspectRatio, double nearPlane, double farPlane)
     : eyeX(eyeX), eyeY(eyeY), eyeZ(eyeZ),
-      aspectRatio(aspectRatio), nearPlane(nearPlane), farPlane(farPlane)
+      aspectRatio(aspectRatio), nearPlane(nearPlane), farPlane(farPlane), viewportHeight(600)
 {
     // Calcula o campo de visão (FOV) baseado na lente e no sensor do Blender
     fov = calculateFOV(focalLength, sensorSize);
@@ -25,6 +25,64 @@ void Camera3D::applyCamera() const
               0.0, 0.0, 1.0);                        // Vetor "para cima" fixo no eixo Z (Por causa do Blender)
 }
 
+void Camera3D::setViewportSize(int width, int height)
+{
+    // Janela minimizada: o framebuffer tem tamanho zero e a câmera mantém o anterior
+    if (width <= 0 || height <= 0)
+        return;
+    aspectRatio = static_cast<double>(width) / height;
+    viewportHeight = height;
+}
+
+int Camera3D::getViewportHeight() const
+{
+    return viewportHeight;
+}
+
+float Camera3D::projectedSize(const glm::vec3 &center, float radius, int viewportHeight) const
+{
+    // Com a câmera dentro da esfera, o objeto ocupa a tela inteira
+    double dx = center.x - eyeX, dy = center.y - eyeY, dz = center.z - eyeZ;
+    double distance = sqrt(dx * dx + dy * dy + dz * dz);
+    if (distance <= radius)
+        return static_cast<float>(viewportHeight);
+
+    double halfHeight = distance * tan(fov * 0.5 * (M_PI / 180.0));
+    return static_cast<float>(radius / halfHeight * viewportHeight);
+}
+
+glm::vec3 Camera3D::getPosition() const
+{
+    return glm::vec3(eyeX, eyeY, eyeZ);
+}
+
+glm::mat4 Camera3D::viewProjection() const
+{
+    glm::vec3 eye = getPosition();
+    glm::mat4 projection = glm::perspective(glm::radians(static_cast<float>(fov)), static_cast<float>(aspectRatio),
+                                            static_cast<float>(nearPlane), static_cast<float>(farPlane));
+    glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(dirX, dirY, dirZ), glm::vec3(0.0f, 0.0f, 1.0f));
+    return projection * view;
+}
+
+void Camera3D::frustumPlanes(glm::vec4 planes[6]) const
+{
+    glm::mat4 m = viewProjection();
+
+    // Extração de Gribb e Hartmann: cada plano é a soma ou a diferença entre a linha w e uma das linhas x, y, z
+    for (int axis = 0; axis < 3; axis++)
+    {
+        for (int side = 0; side < 2; side++)
+        {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            glm::vec4 plane(m[0][3] + sign * m[0][axis], m[1][3] + sign * m[1][axis], m[2][3] + sign * m[2][axis],
+                            m[3][3] + sign * m[3][axis]);
+            float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            planes[axis * 2 + side] = plane * (1.0f / length);
+        }
+    }
+}
+
 double Camera3D::calculateFOV(double focalLength, double sensorSize) const
 {
     return 2.0 * atan((sensorSize / 2.0) / focalLength) * (180.0 / M_PI);
@@ -15,6 +15,7 @@ private:
     double aspectRatio;      ///< Proporção da tela (largura/altura).
     double nearPlane;        ///< Distância do plano de recorte próximo.
     double farPlane;         ///< Distância do plano de recorte distante.
+    int viewportHeight;      ///< Altura da viewport em pixels, usada para estimar tamanhos projetados.
 
 public:
     /**
@@ -40,6 +41,47 @@ public:
      */
     void applyCamera() const;
 
+    /**
+     * @brief Define o tamanho da viewport, atualizando a proporção da tela e a altura usada na escolha do LOD.
+     *
+     * Deve ser chamado quando o framebuffer muda de tamanho; até lá vale a janela de 800x600 de main().
+     *
+     * @param width Largura em pixels.
+     * @param height Altura em pixels.
+     */
+    void setViewportSize(int width, int height);
+
+    /**
+     * @brief Retorna a altura da viewport em pixels.
+     */
+    int getViewportHeight() const;
+
+    /**
+     * @brief Estima a altura, em pixels, de uma esfera projetada na tela.
+     * @param center Centro da esfera.
+     * @param radius Raio da esfera.
+     * @param viewportHeight Altura da viewport em pixels.
+     * @return Diâmetro projetado da esfera em pixels.
+     */
+    float projectedSize(const glm::vec3 &center, float radius, int viewportHeight) const;
+
+    /**
+     * @brief Retorna a posição da câmera.
+     */
+    glm::vec3 getPosition() const;
+
+    /**
+     * @brief Retorna a matriz de projeção multiplicada pela de visão, as mesmas de applyCamera().
+     */
+    glm::mat4 viewProjection() const;
+
+    /**
+     * @brief Calcula os planos do frustum da câmera, com as mesmas matrizes de applyCamera().
+     * @param planes Planos resultantes (esquerda, direita, baixo, cima, perto, longe), normalizados e com as
+     *               normais apontando para dentro: um ponto p está dentro se dot(plane.xyz, p) + plane.w >= 0.
+     */
+    void frustumPlanes(glm::vec4 planes[6]) const;
+
 private:
     /**
      * @brief Calcula o campo de visão (FOV) com base na distância focal e no tamanho do sensor.
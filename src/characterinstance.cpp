@@ -0,0 +1,606 @@
+#include "characterinstance.hpp"
+#include "camera3d.hpp"
+#include "meshlet.hpp"
+#include "meshprocessing.hpp"
+#include "renderstats.hpp"
+#include "skeleton.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+CharacterInstance::CharacterInstance()
+{
+    playback.clip = fadingPlayback.clip = -1;
+    fadeElapsed = fadeDuration = 0.0f;
+    skinningKernel = detectSkinningKernel();
+    threadPool = nullptr;
+    skinningMode = SkinningMode::CPU;
+    camera = nullptr;
+    backfaceCulling = false;
+    lighting = true;
+    forcedLod = -1;
+    currentLod = 0;
+    poseVersion = 1;
+    transformVersion = skinnedVersion = uploadedVersion = paletteVersion = 0;
+}
+
+CharacterInstance::~CharacterInstance()
+{
+    destroy();
+}
+
+void CharacterInstance::destroy()
+{
+    gpuPalette.destroy();
+    positionStream.destroy();
+    asset.reset();
+}
+
+bool CharacterInstance::setAsset(std::shared_ptr<const SkinnedMeshAsset> meshAsset)
+{
+    gpuPalette.destroy();
+    positionStream.destroy();
+    asset = std::move(meshAsset);
+    playback.clip = fadingPlayback.clip = -1;
+    if (!asset)
+        return false;
+
+    // Sem animação a pose é a bind pose, e a camada aditiva começa neutra
+    boneInfo = asset->getBoneInfo();
+    animationPose = asset->getBindPose();
+    additiveLayer.setIdentity(boneInfo.size());
+    skinningPalette.clear();
+    buildSkinningPalette(boneInfo.data(), boneInfo.size(), skinningPalette);
+    globalTransforms.resize(boneInfo.size());
+    boneChangeVersion.assign(boneInfo.size(), 0);
+    skinnedPositions.assign(asset->getVertexCount() * 3, 0.0f);
+    meshletBounds.resize(asset->getMeshlets().size());
+    meshletBoundsVersion.assign(MAX_LOD_COUNT, 0);
+    submeshBounds.resize(asset->getSubmeshes().size());
+    submeshVisible.assign(asset->getSubmeshes().size(), 1);
+    poseVersion++;
+    transformVersion = skinnedVersion = uploadedVersion = paletteVersion = 0;
+
+    // Posições após o skinning: reescritas no anel de buffers sempre que a pose muda
+    if (!positionStream.create(asset->getVertexCount() * 3 * sizeof(float)))
+        return false;
+    std::cout << "Anel de posições criado (" << asset->getVertexCount() << " vértices, "
+              << (positionStream.isPersistent() ? "mapeamento persistente" : "glBufferSubData") << ")" << std::endl;
+
+    // A paleta na GPU é de cada personagem; o programa e os atributos estáticos são os do asset
+    if (asset->hasGpuSkinning() && !gpuPalette.create())
+        std::cerr << "Paleta do skinning na GPU indisponível, usando a CPU" << std::endl;
+    if (!gpuPalette.isReady())
+        skinningMode = SkinningMode::CPU;
+    update();
+    return true;
+}
+
+const std::shared_ptr<const SkinnedMeshAsset> &CharacterInstance::getAsset() const
+{
+    return asset;
+}
+
+void CharacterInstance::update()
+{
+    if (!asset)
+        return;
+
+    // Atualiza as transformações finais dos bones, respeitando a hierarquia
+    updateBoneTransforms();
+    if (skinningMode == SkinningMode::CPU && skinnedVersion != poseVersion)
+    {
+        // Retransforma apenas os vértices influenciados pelos bones alterados desde o último skinning
+        // (todos, na primeira vez), dividindo o trabalho no pool de threads
+        if (skinnedVersion == 0)
+            dirtyRanges.assign(1, VertexRange{0, skinnedPositions.size() / 3});
+        else
+            collectDirtyRanges(skinnedVersion, dirtyRanges);
+        skinRanges(threadPool, asset->getSkinningStreams(), skinningPalette.data(), dirtyRanges,
+                   skinnedPositions.data(), skinningKernel);
+        for (const auto &range : dirtyRanges)
+            renderStats.skinnedVertices += range.end - range.begin;
+        skinnedVersion = poseVersion;
+    }
+
+    // A câmera pode ter se movido mesmo com a pose parada, então o LOD e o descarte são refeitos sempre
+    currentLod = selectLod();
+
+    // Submeshes cuja caixa na pose atual está fora do frustum não são enviados, nos dois caminhos de skinning
+    if (!camera)
+    {
+        std::fill(submeshVisible.begin(), submeshVisible.end(), 1);
+        return;
+    }
+    glm::vec4 planes[6];
+    camera->frustumPlanes(planes);
+    cullBoxes(planes, submeshBounds, 0, submeshBounds.size(), submeshVisible.data());
+
+    // No caminho da CPU, os meshlets do LOD escolhido são descartados com os limites das posições atuais
+    if (skinningMode == SkinningMode::CPU)
+        refitMeshlets(currentLod);
+}
+
+void CharacterInstance::draw()
+{
+    if (!asset || !asset->getVertexArray())
+        return;
+    if (backfaceCulling)
+    {
+        glEnable(GL_CULL_FACE);
+        renderStats.glCalls++;
+    }
+
+    // No vertex shader, apenas a paleta é enviada; os vértices da bind pose já estão na GPU, no asset
+    if (skinningMode == SkinningMode::GPU)
+    {
+        if (paletteVersion != transformVersion)
+        {
+            gpuPalette.upload(skinningPalette);
+            paletteVersion = transformVersion;
+        }
+        const GpuSkinning &gpuSkinning = asset->getGpuSkinning();
+        gpuSkinning.bind(gpuPalette, lighting);
+        drawSubmeshes(true, currentLod, nullptr);
+        gpuSkinning.unbind();
+        if (backfaceCulling)
+        {
+            glDisable(GL_CULL_FACE);
+            renderStats.glCalls++;
+        }
+        return;
+    }
+
+    // As posições do último update() vão para a região livre do anel de buffers; com a pose inalterada,
+    // a última região é desenhada de novo
+    if (uploadedVersion != skinnedVersion)
+    {
+        void *positions = positionStream.beginWrite();
+        std::memcpy(positions, skinnedPositions.data(), skinnedPositions.size() * sizeof(float));
+        positionStream.endWrite();
+        uploadedVersion = skinnedVersion;
+    }
+
+    // Com a câmera conhecida, os meshlets fora do frustum (ou de costas) não são enviados. No caminho da
+    // GPU as posições do skinning não existem na CPU, então os submeshes são desenhados inteiros
+    MeshletCullingView view;
+    const MeshletCullingView *culling = nullptr;
+    if (camera)
+    {
+        camera->frustumPlanes(view.planes);
+        view.eye = camera->getPosition();
+        view.backfaces = backfaceCulling;
+        culling = &view;
+    }
+
+    // As UVs e os índices já estão no VAO do asset; só o ponteiro das posições muda a cada quadro
+    glBindVertexArray(asset->getVertexArray());
+    glBindBuffer(GL_ARRAY_BUFFER, positionStream.buffer());
+    glVertexPointer(3, GL_FLOAT, 0, reinterpret_cast<const void *>(positionStream.currentOffset()));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    renderStats.glCalls += 4;
+
+    drawSubmeshes(false, currentLod, culling);
+
+    glBindVertexArray(0);
+    renderStats.glCalls++;
+    if (backfaceCulling)
+    {
+        glDisable(GL_CULL_FACE);
+        renderStats.glCalls++;
+    }
+    positionStream.fence();
+}
+
+BoneHandle CharacterInstance::findBone(std::string_view boneName) const
+{
+    return asset ? asset->findBone(boneName) : BoneHandle();
+}
+
+BoneHandle CharacterInstance::findBone(uint32_t hash, std::string_view boneName) const
+{
+    return asset ? asset->findBone(hash, boneName) : BoneHandle();
+}
+
+int CharacterInstance::getAnimationCount() const
+{
+    return asset ? asset->getAnimationCount() : 0;
+}
+
+void CharacterInstance::refitMeshlets(int lod)
+{
+    // Os limites acompanham as posições do skinning na CPU; só mudam quando a pose muda
+    if (meshletBoundsVersion[lod] == skinnedVersion)
+        return;
+
+    size_t begin, end;
+    asset->getLodMeshlets(lod, begin, end);
+    const std::vector<Meshlet> &meshlets = asset->getMeshlets();
+    const uint32_t *meshletVertices = asset->getMeshletVertices().data();
+    const uint8_t *meshletTriangles = asset->getMeshletTriangles().data();
+    auto refit = [&](size_t first, size_t last)
+    {
+        for (size_t m = first; m < last; m++)
+            computeMeshletBounds(meshlets[m], meshletVertices, meshletTriangles, skinnedPositions.data(),
+                                 meshletBounds[m]);
+    };
+    if (threadPool)
+        threadPool->parallelFor(begin, end, MESHLET_REFIT_TASK_SIZE, refit);
+    else
+        refit(begin, end);
+    meshletBoundsVersion[lod] = skinnedVersion;
+}
+
+void CharacterInstance::collectDirtyRanges(uint64_t sinceVersion, std::vector<VertexRange> &ranges) const
+{
+    // O pai vem antes dos filhos, então a invalidação desce pela hierarquia em uma passada
+    const std::vector<std::vector<VertexRange>> &boneVertexRanges = asset->getBoneVertexRanges();
+    std::vector<char> dirty(boneInfo.size(), 0);
+    ranges.clear();
+    for (size_t bone = 0; bone < boneInfo.size(); bone++)
+    {
+        int parent = boneInfo[bone].parentIndex;
+        dirty[bone] = boneChangeVersion[bone] > sinceVersion || (parent >= 0 && dirty[parent]);
+        if (dirty[bone])
+            ranges.insert(ranges.end(), boneVertexRanges[bone].begin(), boneVertexRanges[bone].end());
+    }
+
+    // Ordena e une os intervalos sobrepostos ou adjacentes
+    std::sort(ranges.begin(), ranges.end(), [](const VertexRange &a, const VertexRange &b) { return a.begin < b.begin; });
+    size_t merged = 0;
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        if (merged > 0 && ranges[i].begin <= ranges[merged - 1].end)
+            ranges[merged - 1].end = std::max(ranges[merged - 1].end, ranges[i].end);
+        else
+            ranges[merged++] = ranges[i];
+    }
+    ranges.resize(merged);
+}
+
+void CharacterInstance::drawSubmeshes(bool gpuSkinned, int lod, const MeshletCullingView *culling)
+{
+    // Para cada submesh, vincula a textura e desenha os triângulos indexados do LOD (ou do mais simples que houver)
+    const std::vector<SubMesh> &submeshes = asset->getSubmeshes();
+    const std::vector<Meshlet> &meshlets = asset->getMeshlets();
+    for (size_t i = 0; i < submeshes.size(); i++)
+    {
+        const SubMesh &sub = submeshes[i];
+        size_t subLod = std::min<size_t>(lod, sub.lodCount() - 1);
+        size_t indexCount = sub.lodIndexCount(subLod);
+        if (indexCount == 0)
+            continue;
+        if (!submeshVisible[i])
+        {
+            renderStats.culledSubmeshes++;
+            continue;
+        }
+
+        // Meshlets visíveis consecutivos formam um único intervalo de índices; todos os intervalos do
+        // submesh são enviados em um glMultiDrawElementsBaseVertex
+        size_t indexSize = sub.indexType() == GL_UNSIGNED_INT ? 4 : 2;
+        drawCounts.clear();
+        drawOffsets.clear();
+        if (culling)
+        {
+            size_t runEnd = 0, begin, end;
+            asset->getSubmeshMeshlets(lod, i, begin, end);
+            for (size_t m = begin; m < end; m++)
+            {
+                const Meshlet &meshlet = meshlets[m];
+                if (!isMeshletVisible(meshletBounds[m], *culling))
+                {
+                    renderStats.culledMeshlets++;
+                    continue;
+                }
+                if (!drawCounts.empty() && runEnd == meshlet.indexOffset)
+                    drawCounts.back() += meshlet.triangleCount * 3;
+                else
+                {
+                    drawCounts.push_back(meshlet.triangleCount * 3);
+                    drawOffsets.push_back(reinterpret_cast<const void *>(sub.indexByteOffset +
+                                                                         meshlet.indexOffset * indexSize));
+                }
+                runEnd = meshlet.indexOffset + meshlet.triangleCount * 3;
+            }
+            if (drawCounts.empty())
+                continue;
+        }
+        else
+        {
+            drawCounts.push_back(indexCount);
+            drawOffsets.push_back(reinterpret_cast<const void *>(sub.indexByteOffset +
+                                                                 sub.lodIndexOffset(subLod) * indexSize));
+        }
+
+        // No shader, as posições da bind pose são decodificadas com a AABB de cada submesh
+        if (gpuSkinned)
+            asset->getGpuSkinning().setPositionDecode(asset->getSkinningStreams()[i]);
+
+        glBindTexture(GL_TEXTURE_2D, sub.textureID);
+        if (drawCounts.size() == 1)
+            glDrawElementsBaseVertex(GL_TRIANGLES, drawCounts[0], sub.indexType(), drawOffsets[0], sub.baseVertex);
+        else
+        {
+            drawBaseVertices.assign(drawCounts.size(), sub.baseVertex);
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(), sub.indexType(), drawOffsets.data(),
+                                          drawCounts.size(), drawBaseVertices.data());
+        }
+        renderStats.glCalls += 2;
+        renderStats.drawCalls++;
+        for (GLsizei count : drawCounts)
+            renderStats.triangles += count / 3;
+    }
+}
+
+int CharacterInstance::selectLod() const
+{
+    if (forcedLod >= 0)
+        return forcedLod;
+    if (!camera)
+        return 0;
+
+    glm::vec3 center;
+    float radius;
+    asset->getBounds(center, radius);
+    return selectLodForSize(camera->projectedSize(center, radius, camera->getViewportHeight()));
+}
+
+void CharacterInstance::rotateBone(const std::string &boneName, float angle, float axisX, float axisY, float axisZ)
+{
+    // Verifica se o bone existe no mapeamento
+    BoneHandle bone = findBone(boneName);
+    if (!bone.isValid())
+    {
+        std::cerr << "Bone '" << boneName << "' não encontrada!" << std::endl;
+        return;
+    }
+    rotateBone(bone, angle, axisX, axisY, axisZ);
+}
+
+void CharacterInstance::rotateBone(const std::string &boneName, const glm::quat &rotation)
+{
+    // Procura o bone no mapa de bones
+    BoneHandle bone = findBone(boneName);
+    if (!bone.isValid())
+    {
+        std::cerr << "Bone " << boneName << " não encontrado!" << std::endl;
+        return;
+    }
+    rotateBone(bone, rotation);
+}
+
+void CharacterInstance::rotateBone(BoneHandle bone, float angle, float axisX, float axisY, float axisZ)
+{
+    if (!bone.isValid() || bone.index >= static_cast<int>(boneInfo.size()))
+        return;
+
+    // Quaternion equivalente à matriz de Rodrigues do ângulo (em graus) em torno do eixo normalizado
+    float length = std::sqrt(axisX * axisX + axisY * axisY + axisZ * axisZ);
+    float halfAngle = angle * 3.14159265f / 360.0f;
+    float s = std::sin(halfAngle) / (length > 0.0f ? length : 1.0f);
+    setAdditiveRotation(bone.index, aiQuaternion(std::cos(halfAngle), axisX * s, axisY * s, axisZ * s));
+}
+
+void CharacterInstance::rotateBone(BoneHandle bone, const glm::quat &rotation)
+{
+    if (!bone.isValid() || bone.index >= static_cast<int>(boneInfo.size()))
+        return;
+
+    // A rotação sempre foi aplicada a partir da matriz do glm (colunas) lida como linhas pelo Assimp, ou
+    // seja, a transposta; o conjugado do quaternion mantém o mesmo sentido de rotação
+    setAdditiveRotation(bone.index, aiQuaternion(rotation.w, -rotation.x, -rotation.y, -rotation.z));
+}
+
+void CharacterInstance::setAdditiveRotation(int boneIndex, const aiQuaternion &rotation)
+{
+    // Reaplicar a mesma rotação (ex.: mouse parado) não invalida o skinning já calculado
+    const LocalPose &layer = additiveLayer;
+    if (layer.qw[boneIndex] == rotation.w && layer.qx[boneIndex] == rotation.x && layer.qy[boneIndex] == rotation.y &&
+        layer.qz[boneIndex] == rotation.z)
+        return;
+    additiveLayer.setRotation(boneIndex, rotation);
+    boneChangeVersion[boneIndex] = ++poseVersion;
+}
+
+void CharacterInstance::updateBoneTransforms()
+{
+    if (transformVersion == poseVersion)
+        return;
+
+    // A pose final é a das animações com a camada aditiva; as matrizes locais só são montadas depois da mistura
+    evaluatedPose = animationPose;
+    addLocalPose(evaluatedPose, additiveLayer, 1.0f);
+    localPoseToTransforms(evaluatedPose, boneInfo.data());
+
+    // Uma única passada pelos bones, já ordenados com os pais antes dos filhos, reaproveitando a global de cada pai
+    updateSkeleton(boneInfo.data(), boneInfo.size(), globalTransforms.data());
+
+    // Converte as transformações finais para o formato consumido pelo kernel de skinning
+    buildSkinningPalette(boneInfo.data(), boneInfo.size(), skinningPalette);
+    updateSubmeshBounds();
+    transformVersion = poseVersion;
+}
+
+void CharacterInstance::updateSubmeshBounds()
+{
+    const std::vector<BoneBounds> &boneBounds = asset->getBoneBounds();
+    for (size_t i = 0; i < submeshBounds.size(); i++)
+    {
+        size_t begin, end;
+        asset->getSubmeshBoneBounds(i, begin, end);
+        glm::vec3 minimum, maximum;
+        skinnedBounds(boneBounds.data() + begin, end - begin, skinningPalette.data(), minimum, maximum);
+        submeshBounds.set(i, minimum, maximum);
+    }
+}
+
+uint64_t CharacterInstance::getPoseVersion() const
+{
+    return poseVersion;
+}
+
+bool CharacterInstance::playAnimation(int index, bool loop, float fadeSeconds)
+{
+    if (!asset || index < 0 || index >= asset->getAnimationCount())
+        return false;
+
+    if (fadeSeconds > 0.0f && playback.clip >= 0)
+    {
+        // O clip atual passa a ser misturado com o novo; uma transição ainda em andamento é descartada
+        markAnimatedBones(fadingPlayback.clip, ++poseVersion);
+        fadingPlayback = std::move(playback);
+        fadeElapsed = 0.0f;
+        fadeDuration = fadeSeconds;
+    }
+    else
+    {
+        // Bones animados pelo clip anterior, mas não pelo novo, voltam à bind pose
+        stopAnimation();
+    }
+
+    playback.clip = index;
+    playback.loop = loop;
+    playback.time = 0.0f;
+    playback.cursor.reset(asset->getAnimation(index).tracks.size());
+    evaluateAnimation();
+    return true;
+}
+
+void CharacterInstance::stopAnimation()
+{
+    if (playback.clip < 0)
+        return;
+
+    uint64_t version = ++poseVersion;
+    markAnimatedBones(playback.clip, version);
+    markAnimatedBones(fadingPlayback.clip, version);
+    animationPose = asset->getBindPose();
+    playback.clip = fadingPlayback.clip = -1;
+}
+
+int CharacterInstance::getCurrentAnimation() const
+{
+    return playback.clip;
+}
+
+void CharacterInstance::updateAnimation(float deltaTime)
+{
+    if (playback.clip < 0)
+        return;
+
+    // Um clip sem loop parado na última pose não altera mais o esqueleto, a não ser durante uma transição
+    bool changed = advanceAnimation(playback, asset->getAnimation(playback.clip).duration, deltaTime);
+    if (fadingPlayback.clip >= 0)
+    {
+        advanceAnimation(fadingPlayback, asset->getAnimation(fadingPlayback.clip).duration, deltaTime);
+        fadeElapsed += deltaTime;
+        changed = true;
+    }
+    if (changed)
+        evaluateAnimation();
+}
+
+void CharacterInstance::evaluateAnimation()
+{
+    // Cada clip é amostrado sobre a bind pose, de forma que bones sem canal fiquem na pose original
+    uint64_t version = ++poseVersion;
+    animationPose = asset->getBindPose();
+    sampleAnimationClip(asset->getAnimation(playback.clip), playback.time, playback.cursor, animationPose);
+    markAnimatedBones(playback.clip, version);
+    if (fadingPlayback.clip < 0)
+        return;
+
+    // Os bones do clip anterior mudam tanto durante a transição quanto no quadro em que ela termina
+    markAnimatedBones(fadingPlayback.clip, version);
+    if (fadeElapsed >= fadeDuration)
+    {
+        fadingPlayback.clip = -1;
+        return;
+    }
+    fadePose = asset->getBindPose();
+    sampleAnimationClip(asset->getAnimation(fadingPlayback.clip), fadingPlayback.time, fadingPlayback.cursor, fadePose);
+    blendLocalPoses(fadePose, animationPose, fadeElapsed / fadeDuration, animationPose);
+}
+
+void CharacterInstance::markAnimatedBones(int clip, uint64_t version)
+{
+    if (clip < 0)
+        return;
+    for (const CompressedAnimationTrack &track : asset->getAnimation(clip).tracks)
+        boneChangeVersion[track.bone] = version;
+}
+
+void CharacterInstance::setSkinningKernel(SkinningKernel kernel)
+{
+    skinningKernel = kernel;
+}
+
+bool CharacterInstance::setSkinningMode(SkinningMode mode)
+{
+    if (mode == SkinningMode::GPU && !gpuPalette.isReady())
+        return false;
+    skinningMode = mode;
+    return true;
+}
+
+SkinningMode CharacterInstance::getSkinningMode() const
+{
+    return skinningMode;
+}
+
+void CharacterInstance::setCamera(const Camera3D *sceneCamera)
+{
+    camera = sceneCamera;
+}
+
+void CharacterInstance::setBackfaceCulling(bool enabled)
+{
+    backfaceCulling = enabled;
+}
+
+bool CharacterInstance::getBackfaceCulling() const
+{
+    return backfaceCulling;
+}
+
+void CharacterInstance::setLighting(bool enabled)
+{
+    lighting = enabled;
+}
+
+bool CharacterInstance::getLighting() const
+{
+    return lighting;
+}
+
+void CharacterInstance::setForcedLod(int lod)
+{
+    forcedLod = asset ? std::min(lod, asset->getLodCount() - 1) : lod;
+}
+
+int CharacterInstance::getCurrentLod() const
+{
+    return currentLod;
+}
+
+void CharacterInstance::setThreadPool(ThreadPool *pool)
+{
+    threadPool = pool;
+}
+
+SkinningKernel CharacterInstance::getSkinningKernel() const
+{
+    return skinningKernel;
+}
+
+const BoundingBoxes &CharacterInstance::getSubmeshBounds() const
+{
+    return submeshBounds;
+}
+
+const std::vector<BoneInfo> &CharacterInstance::getBoneInfo() const
+{
+    return boneInfo;
+}
@@ -0,0 +1,351 @@
+#ifndef CHARACTERINSTANCE_HPP
+#define CHARACTERINSTANCE_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "skinnedmeshasset.hpp"
+#include "threadpool.hpp"
+#include "streambuffer.hpp"
+
+class Camera3D;
+
+/**
+ * @brief Personagem desenhado a partir de um SkinnedMeshAsset compartilhado.
+ *
+ * Guarda apenas o estado próprio: reprodução das animações, pose avaliada, bones, paleta, posições do
+ * skinning na CPU e os buffers de saída (anel de posições e paleta na GPU). Vários personagens podem
+ * usar o mesmo asset, cada um com sua pose.
+ *
+ * update() avalia a pose, faz o skinning na CPU e escolhe o LOD e as partes visíveis, sem chamadas
+ * OpenGL; draw() apenas envia o resultado já calculado e emite os desenhos.
+ */
+class CharacterInstance
+{
+private:
+    std::shared_ptr<const SkinnedMeshAsset> asset;      ///< Malha, bones e clips compartilhados.
+    std::vector<BoneInfo> boneInfo;                     ///< Bones com as transformações da pose atual.
+    AnimationPlayback playback;                         ///< Clip em reprodução.
+    AnimationPlayback fadingPlayback;                   ///< Clip anterior, ainda misturado durante a transição.
+    float fadeElapsed;                                  ///< Tempo decorrido da transição atual.
+    float fadeDuration;                                 ///< Duração da transição (cross-fade) atual.
+    LocalPose animationPose;                            ///< Pose dos clips em reprodução (bind pose se nenhum).
+    LocalPose fadePose;                                 ///< Pose do clip anterior durante a transição.
+    LocalPose additiveLayer;                            ///< Camada aditiva das rotações manuais (identidade nos demais bones).
+    LocalPose evaluatedPose;                            ///< Pose final: animação com a camada aditiva.
+    std::vector<float> skinningPalette;                 ///< Paleta de matrizes finais no formato do kernel de skinning.
+    std::vector<aiMatrix4x4> globalTransforms;          ///< Transformação global de cada bone, calculada em updateBoneTransforms().
+    std::vector<uint64_t> boneChangeVersion;            ///< Versão da pose em que a rotação de cada bone mudou pela última vez.
+    std::vector<float> skinnedPositions;                ///< Posições após o skinning, atualizadas só nos intervalos afetados.
+    std::vector<VertexRange> dirtyRanges;               ///< Intervalos retransformados no último update().
+    SkinningKernel skinningKernel;                      ///< Kernel utilizado no skinning.
+    ThreadPool *threadPool;                             ///< Pool usado no skinning paralelo (nullptr executa na thread atual).
+    StreamBuffer positionStream;                        ///< Anel de buffers com as posições após o skinning.
+    GpuPalette gpuPalette;                              ///< Paleta própria lida pelo skinning na GPU do asset.
+    SkinningMode skinningMode;                          ///< Caminho de skinning utilizado.
+    const Camera3D *camera;                             ///< Câmera da cena, usada no LOD e no descarte de meshlets.
+    bool backfaceCulling;                               ///< Descarta triângulos e meshlets de costas para a câmera.
+    bool lighting;                                      ///< Iluminação aplicada pelo skinning na GPU.
+    int forcedLod;                                      ///< LOD fixo, ou -1 para escolher pela distância.
+    int currentLod;                                     ///< LOD escolhido no último update().
+    std::vector<MeshletBounds> meshletBounds;           ///< Limites de cada meshlet nas posições do último skinning.
+    std::vector<uint64_t> meshletBoundsVersion;         ///< Versão das posições usada nos limites de cada LOD.
+    BoundingBoxes submeshBounds;                        ///< Caixa de cada submesh na pose da paleta atual.
+    std::vector<uint8_t> submeshVisible;                ///< Submeshes dentro do frustum no último update().
+    std::vector<GLsizei> drawCounts;                    ///< Índices de cada intervalo enviado no submesh atual.
+    std::vector<const void *> drawOffsets;              ///< Deslocamento de cada intervalo enviado no submesh atual.
+    std::vector<GLint> drawBaseVertices;                ///< baseVertex de cada intervalo enviado no submesh atual.
+    uint64_t poseVersion;                               ///< Incrementada sempre que a rotação de algum bone muda.
+    uint64_t transformVersion;                          ///< Versão da pose das transformações finais e da paleta.
+    uint64_t skinnedVersion;                            ///< Versão da pose das posições em skinnedPositions.
+    uint64_t uploadedVersion;                           ///< Versão da pose das posições na região atual do anel.
+    uint64_t paletteVersion;                            ///< Versão da pose da paleta enviada ao skinning na GPU.
+
+public:
+    /**
+     * @brief Construtor, cria um personagem sem asset.
+     */
+    CharacterInstance();
+
+    /**
+     * @brief Destrutor, libera os buffers OpenGL próprios do personagem.
+     */
+    ~CharacterInstance();
+
+    CharacterInstance(const CharacterInstance &) = delete;
+    CharacterInstance &operator=(const CharacterInstance &) = delete;
+
+    /**
+     * @brief Associa o personagem a um asset já carregado, na bind pose e sem animação.
+     *
+     * Cria o anel de posições e a paleta na GPU do personagem; a malha e os buffers estáticos são os do asset.
+     *
+     * @param meshAsset Asset carregado por SkinnedMeshAsset::load().
+     * @return true se os buffers do personagem foram criados, false caso contrário.
+     */
+    bool setAsset(std::shared_ptr<const SkinnedMeshAsset> meshAsset);
+
+    /**
+     * @brief Libera os buffers OpenGL próprios do personagem e a referência ao asset.
+     *
+     * Deve ser chamado com o contexto OpenGL ainda ativo; o destrutor chama destroy() de novo sem efeito.
+     */
+    void destroy();
+
+    /**
+     * @brief Retorna o asset do personagem (nullptr se nenhum).
+     */
+    const std::shared_ptr<const SkinnedMeshAsset> &getAsset() const;
+
+    /**
+     * @brief Avalia a pose e, no skinning na CPU, retransforma os vértices afetados; em seguida escolhe o
+     * LOD e descarta os submeshes e meshlets fora do frustum da câmera.
+     *
+     * Não faz chamadas OpenGL e deve ser chamado antes de draw() sempre que a pose, a câmera, o LOD fixo ou
+     * o caminho de skinning mudarem. Se a pose não mudou desde a última chamada, só a visibilidade é refeita.
+     */
+    void update();
+
+    /**
+     * @brief Renderiza o personagem com o resultado do último update().
+     *
+     * As posições (ou a paleta, no skinning na GPU) só são enviadas quando mudaram desde o último
+     * draw(); caso contrário, apenas os comandos de desenho são emitidos. O LOD e o descarte são os do
+     * último update().
+     */
+    void draw();
+
+    /**
+     * @brief Procura um bone pelo nome no asset.
+     * @param boneName Nome do bone.
+     * @return Handle do bone, inválido se não existir.
+     */
+    BoneHandle findBone(std::string_view boneName) const;
+
+    /**
+     * @brief Procura um bone pelo nome com o hash já calculado por boneNameHash() (ex.: em tempo de compilação).
+     * @param hash Hash do nome.
+     * @param boneName Nome do bone.
+     * @return Handle do bone, inválido se não existir.
+     */
+    BoneHandle findBone(uint32_t hash, std::string_view boneName) const;
+
+    /**
+     * @brief Rotaciona um bone especificado.
+     * @param boneName Nome do bone a ser rotacionado.
+     * @param angle Ângulo (em graus) da rotação.
+     * @param axisX Componente X do eixo.
+     * @param axisY Componente Y do eixo.
+     * @param axisZ Componente Z do eixo.
+     */
+    void rotateBone(const std::string &boneName, float angle, float axisX, float axisY, float axisZ);
+
+    /**
+     * @brief Rotaciona um bone utilizando um quaternion.
+     * @param boneName Nome do bone a ser rotacionado.
+     * @param rotation Rotação representada como um quaternion glm::quat.
+     */
+    void rotateBone(const std::string &boneName, const glm::quat &rotation);
+
+    /**
+     * @brief Rotaciona um bone já resolvido, sem busca por nome.
+     * @param bone Handle obtido por findBone().
+     * @param angle Ângulo (em graus) da rotação.
+     * @param axisX Componente X do eixo.
+     * @param axisY Componente Y do eixo.
+     * @param axisZ Componente Z do eixo.
+     */
+    void rotateBone(BoneHandle bone, float angle, float axisX, float axisY, float axisZ);
+
+    /**
+     * @brief Rotaciona um bone já resolvido utilizando um quaternion, sem busca por nome.
+     * @param bone Handle obtido por findBone().
+     * @param rotation Rotação representada como um quaternion glm::quat.
+     */
+    void rotateBone(BoneHandle bone, const glm::quat &rotation);
+
+    /**
+     * @brief Retorna a versão atual da pose, que muda a cada rotação efetivamente alterada.
+     */
+    uint64_t getPoseVersion() const;
+
+    /**
+     * @brief Retorna a quantidade de clips de animação do asset.
+     */
+    int getAnimationCount() const;
+
+    /**
+     * @brief Inicia a reprodução de um clip a partir do começo.
+     *
+     * As rotações manuais (ex.: cabeça seguindo o mouse) continuam aplicadas sobre a pose animada, como
+     * uma camada aditiva.
+     *
+     * @param index Índice do clip.
+     * @param loop Recomeça o clip ao chegar ao fim; caso contrário, mantém a última pose.
+     * @param fadeSeconds Duração da transição a partir do clip atual (0 troca imediatamente).
+     * @return true se o clip existir, false caso contrário.
+     */
+    bool playAnimation(int index, bool loop = true, float fadeSeconds = 0.0f);
+
+    /**
+     * @brief Interrompe a reprodução e restaura a bind pose dos bones animados.
+     */
+    void stopAnimation();
+
+    /**
+     * @brief Retorna o clip em reprodução, ou -1 se nenhum.
+     */
+    int getCurrentAnimation() const;
+
+    /**
+     * @brief Avança o clip em reprodução e amostra a pose local dos bones animados.
+     * @param deltaTime Tempo decorrido desde a última chamada, em segundos.
+     */
+    void updateAnimation(float deltaTime);
+
+    /**
+     * @brief Define o kernel de skinning utilizado em update().
+     * @param kernel Kernel desejado; se a CPU não o suportar, o melhor disponível é usado.
+     */
+    void setSkinningKernel(SkinningKernel kernel);
+
+    /**
+     * @brief Retorna o kernel de skinning em uso.
+     */
+    SkinningKernel getSkinningKernel() const;
+
+    /**
+     * @brief Define se o skinning é feito na CPU ou no vertex shader.
+     * @param mode Caminho desejado.
+     * @return true se o caminho foi ativado, false se o skinning na GPU não estiver disponível.
+     */
+    bool setSkinningMode(SkinningMode mode);
+
+    /**
+     * @brief Retorna o caminho de skinning em uso.
+     */
+    SkinningMode getSkinningMode() const;
+
+    /**
+     * @brief Define a câmera usada para escolher o LOD e descartar os submeshes e meshlets fora do frustum.
+     * @param sceneCamera Câmera da cena (nullptr desenha sempre o LOD 0, sem descarte).
+     */
+    void setCamera(const Camera3D *sceneCamera);
+
+    /**
+     * @brief Ativa o descarte de faces de costas (GL_CULL_FACE) e dos meshlets inteiramente de costas.
+     *
+     * Desativado por padrão, pois o modelo pode ter superfícies abertas vistas pelos dois lados.
+     */
+    void setBackfaceCulling(bool enabled);
+
+    /**
+     * @brief Informa se o descarte de faces de costas está ativo.
+     */
+    bool getBackfaceCulling() const;
+
+    /**
+     * @brief Define se o skinning na GPU aplica a iluminação (ativa por padrão, como em Light::apply()).
+     *
+     * O shader não consulta GL_LIGHTING a cada desenho; quem desativa a iluminação da cena deve avisar aqui.
+     */
+    void setLighting(bool enabled);
+
+    /**
+     * @brief Informa se o skinning na GPU aplica a iluminação.
+     */
+    bool getLighting() const;
+
+    /**
+     * @brief Fixa o LOD desenhado, ignorando a câmera.
+     * @param lod Nível desejado, ou -1 para voltar à escolha automática.
+     */
+    void setForcedLod(int lod);
+
+    /**
+     * @brief Retorna o LOD escolhido no último update().
+     */
+    int getCurrentLod() const;
+
+    /**
+     * @brief Define o pool de threads usado para dividir o skinning em tarefas.
+     * @param pool Pool de threads, que deve existir enquanto o personagem for atualizado (nullptr desativa).
+     */
+    void setThreadPool(ThreadPool *pool);
+
+    /**
+     * @brief Retorna as informações dos bones, com as transformações do último update().
+     */
+    const std::vector<BoneInfo> &getBoneInfo() const;
+
+    /**
+     * @brief Retorna a caixa conservadora de cada submesh na pose do último update(), no espaço do modelo.
+     */
+    const BoundingBoxes &getSubmeshBounds() const;
+
+private:
+    /**
+     * @brief Substitui a rotação de um bone na camada aditiva, incrementando a versão da pose se ela mudar.
+     * @param boneIndex Índice do bone.
+     * @param rotation Nova rotação, aplicada no espaço do bone sobre a pose animada.
+     */
+    void setAdditiveRotation(int boneIndex, const aiQuaternion &rotation);
+
+    /**
+     * @brief Amostra o clip atual e, durante a transição, mistura com o clip anterior em animationPose.
+     */
+    void evaluateAnimation();
+
+    /**
+     * @brief Marca os bones animados por um clip como alterados em uma versão da pose.
+     * @param clip Índice do clip (-1 não marca nada).
+     * @param version Versão da pose.
+     */
+    void markAnimatedBones(int clip, uint64_t version);
+
+    /**
+     * @brief Avalia a pose local (animação e camada aditiva), monta as matrizes locais e atualiza as
+     * transformações dos bones com base na hierarquia, se a pose mudou.
+     */
+    void updateBoneTransforms();
+
+    /**
+     * @brief Transforma as caixas dos bones de cada submesh pela paleta atual.
+     */
+    void updateSubmeshBounds();
+
+    /**
+     * @brief Recalcula os limites dos meshlets de um LOD se as posições do skinning mudaram.
+     */
+    void refitMeshlets(int lod);
+
+    /**
+     * @brief Reúne os intervalos de vértices influenciados pelos bones alterados depois de uma versão da pose.
+     *
+     * Um bone alterado invalida também todos os seus descendentes.
+     *
+     * @param sinceVersion Versão da pose das posições atuais.
+     * @param ranges Intervalos ordenados e disjuntos a retransformar.
+     */
+    void collectDirtyRanges(uint64_t sinceVersion, std::vector<VertexRange> &ranges) const;
+
+    /**
+     * @brief Emite um glDrawElementsBaseVertex por submesh, com o VAO do caminho de skinning já vinculado.
+     * @param gpuSkinned true se o shader de skinning estiver ativo (define a decodificação das posições).
+     * @param lod Nível de detalhe desenhado; submeshes com menos níveis usam o mais simples que tiverem.
+     * @param culling Câmera para descartar meshlets (nullptr desenha os submeshes inteiros).
+     *
+     * Os submeshes marcados como fora do frustum em submeshVisible não são desenhados.
+     */
+    void drawSubmeshes(bool gpuSkinned, int lod, const MeshletCullingView *culling);
+
+    /**
+     * @brief Escolhe o LOD pela altura projetada da esfera envolvente, a partir do FOV e da distância da câmera.
+     */
+    int selectLod() const;
+};
+
+#endif
@@ -0,0 +1,562 @@
+#include "crowd.hpp"
+#include "camera3d.hpp"
+#include "renderstats.hpp"
+#include "skeleton.hpp"
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+Crowd::Crowd()
+    : paletteMatrices(0), maxBatchInstances(0), threadPool(nullptr), camera(nullptr), animationLod(true), frame(0),
+      frameTime(0.0f), evaluatedCount(0), impostorAtlas(nullptr), impostorPixels(IMPOSTOR_MAX_PIXELS),
+      frustumCulling(true), lighting(true), culledCount(0), occlusionCulling(false),
+      maxOccluders(CROWD_MAX_OCCLUDERS), skinningKernel(detectSkinningKernel()), occludedCount(0),
+      occlusionMilliseconds(0.0)
+{
+    std::fill(lodStarts, lodStarts + CROWD_GROUP_COUNT + 1, 0);
+    std::fill(drawStarts, drawStarts + MAX_LOD_COUNT + 1, 0);
+}
+
+bool Crowd::create(std::shared_ptr<const SkinnedMeshAsset> asset, size_t count, unsigned int seed)
+{
+    destroy();
+    if (!asset || !asset->hasGpuSkinning() || !gpuPalette.create())
+    {
+        std::cerr << "A multidão requer skinning na GPU" << std::endl;
+        return false;
+    }
+    model = std::move(asset);
+    paletteMatrices = model->getBoneInfo().size() + 1;
+    maxBatchInstances = std::max<size_t>(1, GpuPalette::maxMatrices() / paletteMatrices);
+
+    // Grade com espaçamento igual ao raio da esfera envolvente; as colunas se alternam dos dois lados da
+    // instância 0, e as fileiras se afastam no eixo Y, a direção para onde a câmera olha
+    glm::vec3 center;
+    float radius;
+    model->getBounds(center, radius);
+    float spacing = std::max(radius, 0.001f);
+    size_t columns = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count)))));
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    int clipCount = model->getAnimationCount();
+
+    instances.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        CrowdInstance &instance = instances[i];
+        size_t row = i / columns, column = i % columns;
+        float side = column % 2 == 0 ? -1.0f : 1.0f;
+        instance.position = glm::vec3(side * ((column + 1) / 2) * spacing, row * spacing, 0.0f);
+        instance.heading = i == 0 ? 0.0f : (unit(random) - 0.5f) * glm::radians(90.0f);
+
+        instance.keyFrame = instance.keySteps = 0;
+
+        AnimationPlayback &playback = instance.playback;
+        playback.clip = clipCount > 0 ? static_cast<int>(i % clipCount) : -1;
+        playback.loop = true;
+        playback.time = 0.0f;
+        if (playback.clip < 0)
+            continue;
+        const CompressedAnimationClip &clip = model->getAnimation(playback.clip);
+        playback.cursor.reset(clip.tracks.size());
+        playback.time = unit(random) * clip.duration;
+    }
+
+    instanceLods.resize(count);
+    instanceOrder.resize(count);
+    palettes.assign(count * paletteMatrices * SKINNING_PALETTE_STRIDE, 0.0f);
+    keyPalettes.assign(palettes.size() * 2, 0.0f);
+    instanceBounds.resize(count);
+    instanceVisible.assign(count, 1);
+    frame = 0;
+    if (impostorAtlas && !impostorRenderer.create(count))
+        std::cerr << "Impostores indisponíveis para a multidão" << std::endl;
+    std::cout << "Multidão: " << count << " instâncias, " << paletteMatrices << " matrizes por paleta, até "
+              << maxBatchInstances << " instâncias por envio" << std::endl;
+    update(0.0f);
+    return true;
+}
+
+void Crowd::destroy()
+{
+    gpuPalette.destroy();
+    impostorRenderer.destroy();
+    impostors.clear();
+    instances.clear();
+    instanceLods.clear();
+    instanceOrder.clear();
+    palettes.clear();
+    keyPalettes.clear();
+    instanceBounds.resize(0);
+    instanceVisible.clear();
+    evaluatedCount = culledCount = occludedCount = 0;
+    occlusionMilliseconds = 0.0;
+    std::fill(lodStarts, lodStarts + CROWD_GROUP_COUNT + 1, 0);
+    std::fill(drawStarts, drawStarts + MAX_LOD_COUNT + 1, 0);
+    model.reset();
+}
+
+size_t Crowd::size() const
+{
+    return instances.size();
+}
+
+const std::vector<CrowdInstance> &Crowd::getInstances() const
+{
+    return instances;
+}
+
+void Crowd::setThreadPool(ThreadPool *pool)
+{
+    threadPool = pool;
+}
+
+void Crowd::setCamera(const Camera3D *sceneCamera)
+{
+    camera = sceneCamera;
+}
+
+void Crowd::setAnimationLod(bool enabled)
+{
+    animationLod = enabled;
+}
+
+bool Crowd::getAnimationLod() const
+{
+    return animationLod;
+}
+
+size_t Crowd::getEvaluatedCount() const
+{
+    return evaluatedCount;
+}
+
+void Crowd::setImpostors(const ImpostorAtlas *atlas, float maxPixels)
+{
+    impostorAtlas = atlas && atlas->isReady() ? atlas : nullptr;
+    impostorPixels = maxPixels;
+    impostors.clear();
+    impostorRenderer.destroy();
+    if (impostorAtlas && !instances.empty() && !impostorRenderer.create(instances.size()))
+        std::cerr << "Impostores indisponíveis para a multidão" << std::endl;
+}
+
+size_t Crowd::getImpostorCount() const
+{
+    return lodStarts[CROWD_IMPOSTOR_GROUP + 1] - lodStarts[CROWD_IMPOSTOR_GROUP];
+}
+
+void Crowd::setFrustumCulling(bool enabled)
+{
+    frustumCulling = enabled;
+}
+
+bool Crowd::getFrustumCulling() const
+{
+    return frustumCulling;
+}
+
+void Crowd::setLighting(bool enabled)
+{
+    lighting = enabled;
+}
+
+bool Crowd::getLighting() const
+{
+    return lighting;
+}
+
+size_t Crowd::getCulledCount() const
+{
+    return culledCount;
+}
+
+void Crowd::setOcclusionCulling(bool enabled, size_t occluders)
+{
+    occlusionCulling = enabled;
+    maxOccluders = occluders;
+    occludedCount = 0;
+    occlusionMilliseconds = 0.0;
+    if (enabled && !occlusionBuffer.create())
+        occlusionCulling = false;
+}
+
+bool Crowd::getOcclusionCulling() const
+{
+    return occlusionCulling;
+}
+
+void Crowd::addStaticOccluder(const std::vector<glm::vec3> &positions, const std::vector<uint32_t> &indices)
+{
+    uint32_t base = static_cast<uint32_t>(staticPositions.size() / 3);
+    for (const glm::vec3 &position : positions)
+        staticPositions.insert(staticPositions.end(), {position.x, position.y, position.z});
+    for (uint32_t index : indices)
+        staticIndices.push_back(base + index);
+}
+
+size_t Crowd::getOccludedCount() const
+{
+    return occludedCount;
+}
+
+double Crowd::getOcclusionTime() const
+{
+    return occlusionMilliseconds;
+}
+
+const OcclusionBuffer &Crowd::getOcclusionBuffer() const
+{
+    return occlusionBuffer;
+}
+
+void Crowd::update(float deltaTime)
+{
+    if (!model)
+        return;
+
+    // O tempo de todas as instâncias avança a cada quadro, mesmo nas que só serão interpoladas ou
+    // desenhadas como impostores. Um impostor não tem pose: ao voltar para a malha, é avaliado de novo
+    sortByLod();
+    frame++;
+    frameTime = deltaTime;
+    evaluatedCount = 0;
+    for (size_t i = 0; i < instances.size(); i++)
+    {
+        CrowdInstance &instance = instances[i];
+        if (instance.playback.clip >= 0)
+            advanceAnimation(instance.playback, model->getAnimation(instance.playback.clip).duration, deltaTime);
+        if (instanceLods[i] == CROWD_IMPOSTOR_GROUP)
+            instance.keySteps = 0;
+        else if (instance.keySteps == 0 || frame - instance.keyFrame >= instance.keySteps)
+            evaluatedCount++;
+    }
+
+    // Os impostores só precisam do centro e da rotação de cada instância
+    size_t meshInstances = lodStarts[CROWD_IMPOSTOR_GROUP];
+    impostors.clear();
+    if (impostorAtlas)
+    {
+        glm::vec3 center;
+        float radius;
+        impostorAtlas->getBounds(center, radius);
+        for (size_t k = meshInstances; k < instances.size(); k++)
+        {
+            const CrowdInstance &instance = instances[instanceOrder[k]];
+            impostors.push_back(ImpostorInstance{worldCenter(instance, center), instance.heading});
+        }
+    }
+
+    // Cada tarefa avalia um grupo de instâncias com bones e pose temporários próprios e calcula a caixa de
+    // cada uma a partir da paleta resultante
+    auto evaluate = [this](size_t begin, size_t end)
+    {
+        evaluateInstances(begin, end);
+        boundInstances(begin, end);
+    };
+    if (threadPool)
+        threadPool->parallelFor(0, meshInstances, CROWD_TASK_SIZE, evaluate);
+    else
+        evaluate(0, meshInstances);
+    cullInstances();
+}
+
+void Crowd::boundInstances(size_t begin, size_t end)
+{
+    // A paleta já inclui a transformação da instância, então a caixa resultante está no mundo
+    const std::vector<BoneBounds> &boneBounds = model->getModelBoneBounds();
+    size_t paletteFloats = paletteMatrices * SKINNING_PALETTE_STRIDE;
+    for (size_t k = begin; k < end; k++)
+    {
+        glm::vec3 minimum, maximum;
+        skinnedBounds(boneBounds.data(), boneBounds.size(), &palettes[k * paletteFloats], minimum, maximum);
+        instanceBounds.set(k, minimum, maximum);
+    }
+}
+
+void Crowd::cullInstances()
+{
+    // Os impostores não têm paleta: a caixa é a da esfera envolvente usada no bake
+    size_t meshInstances = lodStarts[CROWD_IMPOSTOR_GROUP];
+    if (impostorAtlas)
+    {
+        glm::vec3 center;
+        float radius;
+        impostorAtlas->getBounds(center, radius);
+        for (size_t k = meshInstances; k < instances.size(); k++)
+        {
+            const glm::vec3 &impostorCenter = impostors[k - meshInstances].center;
+            instanceBounds.set(k, impostorCenter - glm::vec3(radius), impostorCenter + glm::vec3(radius));
+        }
+    }
+
+    if (camera && frustumCulling)
+    {
+        glm::vec4 planes[6];
+        camera->frustumPlanes(planes);
+        cullBoxes(planes, instanceBounds, 0, instances.size(), instanceVisible.data());
+    }
+    else
+        std::fill(instanceVisible.begin(), instanceVisible.end(), 1);
+    occludedCount = 0;
+    occlusionMilliseconds = 0.0;
+    if (camera && occlusionCulling)
+        cullOccludedInstances();
+
+    // As paletas visíveis são movidas para o início, ainda agrupadas por LOD; o destino nunca passa da
+    // origem, então a compactação é feita no próprio buffer
+    size_t paletteFloats = paletteMatrices * SKINNING_PALETTE_STRIDE;
+    size_t next = 0;
+    for (int lod = 0; lod < MAX_LOD_COUNT; lod++)
+    {
+        drawStarts[lod] = next;
+        for (size_t k = lodStarts[lod]; k < lodStarts[lod + 1]; k++)
+        {
+            if (!instanceVisible[k])
+                continue;
+            if (next != k)
+                std::copy(&palettes[k * paletteFloats], &palettes[(k + 1) * paletteFloats],
+                          &palettes[next * paletteFloats]);
+            next++;
+        }
+    }
+    drawStarts[MAX_LOD_COUNT] = next;
+    culledCount = meshInstances - next;
+
+    size_t visibleImpostors = 0;
+    for (size_t k = meshInstances; k < instances.size() && impostorAtlas; k++)
+    {
+        if (instanceVisible[k])
+            impostors[visibleImpostors++] = impostors[k - meshInstances];
+    }
+    culledCount += impostors.size() - visibleImpostors;
+    impostors.resize(visibleImpostors);
+}
+
+void Crowd::cullOccludedInstances()
+{
+    auto start = std::chrono::steady_clock::now();
+    occlusionBuffer.setThreadPool(threadPool);
+    glm::mat4 viewProjection = camera->viewProjection();
+    occlusionBuffer.begin(viewProjection);
+    if (!staticIndices.empty())
+        occlusionBuffer.addOccluder(staticPositions.data(), staticPositions.size() / 3, staticIndices.data(),
+                                    staticIndices.size());
+
+    // Os oclusores são as instâncias visíveis com o centro da caixa mais perto na direção da câmera; dentro
+    // de um mesmo LOD a ordem de instanceOrder não é a da profundidade. O w do espaço de recorte é a
+    // profundidade no espaço da câmera. A malha oclusora é transformada pela paleta do quadro, que já está
+    // no mundo
+    std::vector<std::pair<float, size_t>> candidates;
+    size_t meshInstances = lodStarts[CROWD_IMPOSTOR_GROUP];
+    glm::vec3 minimum, maximum;
+    for (size_t k = 0; k < meshInstances; k++)
+    {
+        if (!instanceVisible[k])
+            continue;
+        instanceBounds.get(k, minimum, maximum);
+        glm::vec4 center = viewProjection * glm::vec4((minimum + maximum) * 0.5f, 1.0f);
+        candidates.emplace_back(center.w, k);
+    }
+    size_t occluderCount = std::min(maxOccluders, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + occluderCount, candidates.end());
+    std::vector<size_t> occluders(occluderCount);
+    for (size_t i = 0; i < occluderCount; i++)
+        occluders[i] = candidates[i].second;
+    const SkinningStreams &streams = model->getOccluderStreams();
+    const std::vector<uint32_t> &indices = model->getOccluderIndices();
+    size_t vertexFloats = streams.size() * 3, paletteFloats = paletteMatrices * SKINNING_PALETTE_STRIDE;
+    occluderPositions.resize(occluders.size() * vertexFloats);
+    auto skin = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+            skinPositions(streams, &palettes[occluders[i] * paletteFloats], 0, streams.size(),
+                          &occluderPositions[i * vertexFloats], skinningKernel);
+    };
+    if (threadPool)
+        threadPool->parallelFor(0, occluders.size(), 1, skin);
+    else
+        skin(0, occluders.size());
+    for (size_t i = 0; i < occluders.size(); i++)
+        occlusionBuffer.addOccluder(&occluderPositions[i * vertexFloats], streams.size(), indices.data(),
+                                    indices.size());
+    occlusionBuffer.finish();
+
+    // Só as instâncias que passaram pelo frustum são testadas
+    size_t visibleBefore = std::count(instanceVisible.begin(), instanceVisible.end(), 1);
+    occlusionBuffer.cullOccluded(instanceBounds, 0, instances.size(), instanceVisible.data());
+    occludedCount = visibleBefore - std::count(instanceVisible.begin(), instanceVisible.end(), 1);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    occlusionMilliseconds = elapsed.count();
+}
+
+uint32_t Crowd::updateInterval(size_t index) const
+{
+    return animationLod ? 1u << instanceLods[index] : 1u;
+}
+
+void Crowd::sortByLod()
+{
+    std::fill(lodStarts, lodStarts + CROWD_GROUP_COUNT + 1, 0);
+    if (!camera)
+    {
+        // Sem câmera todas as instâncias usam o LOD 0, na ordem original
+        for (size_t i = 0; i < instances.size(); i++)
+            instanceOrder[i] = i;
+        std::fill(instanceLods.begin(), instanceLods.end(), 0);
+        std::fill(lodStarts + 1, lodStarts + CROWD_GROUP_COUNT + 1, instances.size());
+        return;
+    }
+
+    int viewportHeight = camera->getViewportHeight();
+    glm::vec3 center;
+    float radius;
+    model->getBounds(center, radius);
+
+    // Ordenação por contagem: as instâncias de cada LOD ficam contíguas nas paletas, e os impostores por último
+    for (size_t i = 0; i < instances.size(); i++)
+    {
+        float pixels = camera->projectedSize(worldCenter(instances[i], center), radius, viewportHeight);
+        instanceLods[i] = impostorAtlas && pixels < impostorPixels ? CROWD_IMPOSTOR_GROUP : selectLodForSize(pixels);
+        lodStarts[instanceLods[i] + 1]++;
+    }
+    for (int group = 0; group < CROWD_GROUP_COUNT; group++)
+        lodStarts[group + 1] += lodStarts[group];
+    size_t next[CROWD_GROUP_COUNT];
+    std::copy(lodStarts, lodStarts + CROWD_GROUP_COUNT, next);
+    for (size_t i = 0; i < instances.size(); i++)
+        instanceOrder[next[instanceLods[i]]++] = i;
+}
+
+void Crowd::evaluateInstances(size_t begin, size_t end)
+{
+    std::vector<BoneInfo> bones(model->getBoneInfo());
+    std::vector<aiMatrix4x4> globals(bones.size());
+    const LocalPose &bindPose = model->getBindPose();
+    LocalPose pose;
+    size_t paletteFloats = paletteMatrices * SKINNING_PALETTE_STRIDE;
+
+    // Amostra o clip da instância em um tempo e grava a paleta, já com a transformação da instância
+    // (o shader não precisa de outro atributo)
+    auto evaluate = [&](CrowdInstance &instance, float time, float *palette)
+    {
+        pose = bindPose;
+        if (instance.playback.clip >= 0)
+            sampleAnimationClip(model->getAnimation(instance.playback.clip), time, instance.playback.cursor, pose);
+        localPoseToTransforms(pose, bones.data());
+        updateSkeleton(bones.data(), bones.size(), globals.data());
+
+        float c = std::cos(instance.heading), s = std::sin(instance.heading);
+        aiMatrix4x4 world(c, -s, 0.0f, instance.position.x,
+                          s, c, 0.0f, instance.position.y,
+                          0.0f, 0.0f, 1.0f, instance.position.z,
+                          0.0f, 0.0f, 0.0f, 1.0f);
+        buildSkinningPalette(bones.data(), bones.size(), world, palette);
+    };
+
+    for (size_t k = begin; k < end; k++)
+    {
+        size_t index = instanceOrder[k];
+        CrowdInstance &instance = instances[index];
+        float *out = &palettes[k * paletteFloats];
+        float *start = &keyPalettes[index * 2 * paletteFloats];
+        float *target = start + paletteFloats;
+
+        uint32_t elapsed = frame - instance.keyFrame;
+        if (instance.keySteps > 0 && elapsed < instance.keySteps)
+        {
+            // Entre duas avaliações, a paleta é interpolada linearmente da inicial para a alvo
+            float weight = static_cast<float>(elapsed) / instance.keySteps;
+            for (size_t i = 0; i < paletteFloats; i++)
+                out[i] = start[i] + (target[i] - start[i]) * weight;
+            continue;
+        }
+
+        // A próxima avaliação cai no quadro em que (frame + índice) é múltiplo do intervalo, o que distribui
+        // as instâncias de cada LOD pelos quadros. Com intervalo 1 (ou na primeira vez) a pose é a do quadro atual
+        uint32_t interval = updateInterval(index);
+        instance.keyFrame = frame;
+        if (interval == 1 || instance.keySteps == 0)
+        {
+            evaluate(instance, instance.playback.time, target);
+            std::copy(target, target + paletteFloats, out);
+            instance.keySteps = 1;
+            continue;
+        }
+
+        // A paleta alvo anterior, que é a pose atual, passa a ser a inicial, e a nova alvo é avaliada no
+        // tempo que o clip terá na próxima avaliação
+        instance.keySteps = interval - (frame + index) % interval;
+        std::copy(target, target + paletteFloats, start);
+        std::copy(start, start + paletteFloats, out);
+        AnimationPlayback ahead;
+        ahead.clip = instance.playback.clip;
+        ahead.time = instance.playback.time;
+        ahead.loop = instance.playback.loop;
+        if (ahead.clip >= 0)
+            advanceAnimation(ahead, model->getAnimation(ahead.clip).duration, frameTime * instance.keySteps);
+        evaluate(instance, ahead.time, target);
+    }
+}
+
+void Crowd::draw() const
+{
+    if (!model || instances.empty())
+        return;
+
+    const std::vector<SubMesh> &submeshes = model->getSubmeshes();
+    const std::vector<SkinningStreams> &streams = model->getSkinningStreams();
+    size_t paletteFloats = paletteMatrices * SKINNING_PALETTE_STRIDE;
+    size_t meshInstances = drawStarts[MAX_LOD_COUNT];
+    if (!impostors.empty() && impostorAtlas && camera)
+        impostorRenderer.draw(*impostorAtlas, camera->getPosition(), impostors.data(), impostors.size());
+    if (meshInstances == 0)
+        return;
+
+    // As paletas vão para a GPU em lotes que cabem no texture buffer (em geral um único lote); dentro de
+    // cada lote, cada LOD e submesh é um único desenho instanciado
+    const GpuSkinning &gpuSkinning = model->getGpuSkinning();
+    gpuSkinning.bind(gpuPalette, lighting);
+    for (size_t batch = 0; batch < meshInstances; batch += maxBatchInstances)
+    {
+        size_t batchEnd = std::min(meshInstances, batch + maxBatchInstances);
+        gpuPalette.upload(&palettes[batch * paletteFloats], (batchEnd - batch) * paletteFloats);
+        for (int lod = 0; lod < MAX_LOD_COUNT; lod++)
+        {
+            size_t first = std::max(drawStarts[lod], batch), last = std::min(drawStarts[lod + 1], batchEnd);
+            if (first >= last)
+                continue;
+            GLsizei instanceCount = last - first;
+            gpuSkinning.setInstanceLayout(paletteMatrices, first - batch);
+            for (size_t i = 0; i < submeshes.size(); i++)
+            {
+                const SubMesh &sub = submeshes[i];
+                size_t subLod = std::min<size_t>(lod, sub.lodCount() - 1);
+                size_t indexCount = sub.lodIndexCount(subLod);
+                if (indexCount == 0)
+                    continue;
+
+                size_t indexSize = sub.indexType() == GL_UNSIGNED_INT ? 4 : 2;
+                const void *offset = reinterpret_cast<const void *>(sub.indexByteOffset +
+                                                                    sub.lodIndexOffset(subLod) * indexSize);
+                gpuSkinning.setPositionDecode(streams[i]);
+                glBindTexture(GL_TEXTURE_2D, sub.textureID);
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, indexCount, sub.indexType(), offset, instanceCount,
+                                                  sub.baseVertex);
+                renderStats.glCalls += 2;
+                renderStats.drawCalls++;
+                renderStats.triangles += indexCount / 3 * instanceCount;
+            }
+        }
+    }
+    gpuSkinning.unbind();
+}
+
+glm::vec3 Crowd::worldCenter(const CrowdInstance &instance, const glm::vec3 &center)
+{
+    float c = std::cos(instance.heading), s = std::sin(instance.heading);
+    return instance.position + glm::vec3(c * center.x - s * center.y, s * center.x + c * center.y, center.z);
+}
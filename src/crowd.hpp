@@ -0,0 +1,311 @@
+#ifndef CROWD_HPP
+#define CROWD_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <glm/glm.hpp>
+#include "skinnedmeshasset.hpp"
+#include "threadpool.hpp"
+#include "meshprocessing.hpp"
+#include "impostor.hpp"
+#include "bounds.hpp"
+#include "occlusion.hpp"
+
+class Camera3D;
+
+/**
+ * @brief Quantidade máxima de instâncias avaliadas em cada tarefa paralela da multidão.
+ */
+const size_t CROWD_TASK_SIZE = 16;
+
+/**
+ * @brief Grupo das instâncias desenhadas como impostores, depois dos grupos de cada LOD da malha.
+ */
+const int CROWD_IMPOSTOR_GROUP = MAX_LOD_COUNT;
+
+/**
+ * @brief Quantidade de grupos em que as instâncias são ordenadas: os LODs da malha e os impostores.
+ */
+const int CROWD_GROUP_COUNT = MAX_LOD_COUNT + 1;
+
+/**
+ * @brief Quantidade padrão de instâncias mais próximas rasterizadas como oclusores a cada quadro.
+ */
+const size_t CROWD_MAX_OCCLUDERS = 16;
+
+/**
+ * @brief Estado próprio de cada personagem da multidão.
+ */
+struct CrowdInstance
+{
+    glm::vec3 position;         ///< Posição no chão (plano XY).
+    float heading;              ///< Rotação em torno do eixo Z, em radianos.
+    AnimationPlayback playback; ///< Clip reproduzido pela instância (clip -1 mantém a bind pose).
+    uint32_t keyFrame;          ///< Quadro em que a pose foi avaliada pela última vez.
+    uint32_t keySteps;          ///< Quadros entre a última avaliação e a paleta alvo (0 antes da primeira).
+};
+
+/**
+ * @brief Multidão de cópias de um SkinnedMeshAsset desenhadas com skinning na GPU e desenhos instanciados.
+ *
+ * Malha, texturas, streams de skinning, clips e o programa de skinning são os do asset; cada instância guarda
+ * apenas a posição e a reprodução do seu clip. A cada update() as paletas de todas as instâncias, já
+ * com a transformação de cada uma, são concatenadas em um único buffer, agrupadas pelo LOD; draw()
+ * envia esse buffer e emite, para cada LOD e submesh, um único glDrawElementsInstancedBaseVertex.
+ *
+ * O LOD também reduz a frequência da animação: uma instância no LOD n só tem a pose avaliada a cada
+ * 2^n quadros, já no tempo da próxima avaliação, e nos quadros intermediários sua paleta é interpolada
+ * entre as duas últimas avaliações. O quadro de cada avaliação depende do índice da instância, para
+ * que as avaliações de um LOD se distribuam igualmente pelos quadros.
+ *
+ * Com um atlas de impostores, as instâncias menores que um limite na tela não têm pose avaliada e são
+ * desenhadas como quads com a direção pré-renderizada mais próxima.
+ *
+ * Depois de montar as paletas, a caixa de cada instância é calculada a partir da sua paleta e as caixas
+ * de todas as instâncias são testadas contra o frustum de uma vez; as paletas das instâncias fora dele são
+ * retiradas do buffer antes do envio, e os impostores fora dele não são desenhados.
+ *
+ * Com o descarte por oclusão, as instâncias que sobraram também são testadas contra um buffer de
+ * profundidade rasterizado na CPU com os oclusores fixos (ex.: o fundo) e com a malha oclusora do asset
+ * (o LOD mais simples, encolhido para dentro do corpo) das instâncias mais próximas da câmera, já na pose
+ * do quadro.
+ */
+class Crowd
+{
+private:
+    std::shared_ptr<const SkinnedMeshAsset> model; ///< Asset compartilhado por todas as instâncias.
+    std::vector<CrowdInstance> instances;          ///< Instâncias da multidão.
+    std::vector<uint8_t> instanceLods;             ///< Grupo (LOD ou impostor) de cada instância no último update().
+    std::vector<uint32_t> instanceOrder;           ///< Instâncias em ordem de grupo, na ordem das paletas.
+    size_t lodStarts[CROWD_GROUP_COUNT + 1];       ///< Primeira posição de instanceOrder de cada grupo.
+    std::vector<float> palettes;                   ///< Paletas das instâncias, na ordem de instanceOrder.
+    std::vector<float> keyPalettes;                ///< Paletas inicial e alvo da interpolação de cada instância.
+    size_t paletteMatrices;                        ///< Matrizes da paleta de cada instância (bones + identidade).
+    size_t maxBatchInstances;                      ///< Instâncias por envio, limitado pelo tamanho do texture buffer.
+    mutable GpuPalette gpuPalette;                 ///< Paletas de todas as instâncias, lidas pelo skinning na GPU do asset.
+    ThreadPool *threadPool;                        ///< Pool usado na avaliação das poses (nullptr executa na thread atual).
+    const Camera3D *camera;                        ///< Câmera usada para escolher o LOD de cada instância.
+    bool animationLod;                             ///< Reduz a frequência da animação das instâncias distantes.
+    uint32_t frame;                                ///< Quantidade de update() desde create().
+    float frameTime;                               ///< deltaTime do último update(), usado para avaliar adiante.
+    size_t evaluatedCount;                         ///< Instâncias com a pose avaliada no último update().
+    const ImpostorAtlas *impostorAtlas;            ///< Atlas dos impostores (nullptr desativa).
+    float impostorPixels;                          ///< Altura projetada abaixo da qual a instância vira impostor.
+    mutable ImpostorRenderer impostorRenderer;     ///< Quads dos impostores.
+    std::vector<ImpostorInstance> impostors;       ///< Impostores visíveis do último update(), na ordem de instanceOrder.
+    BoundingBoxes instanceBounds;                  ///< Caixa de cada instância no mundo, na ordem de instanceOrder.
+    std::vector<uint8_t> instanceVisible;          ///< Instâncias dentro do frustum, na ordem de instanceOrder.
+    size_t drawStarts[MAX_LOD_COUNT + 1];          ///< Primeira paleta de cada LOD, já sem as instâncias descartadas.
+    bool frustumCulling;                           ///< Descarta as instâncias fora do frustum da câmera.
+    bool lighting;                                 ///< Iluminação aplicada pelo skinning na GPU.
+    size_t culledCount;                            ///< Instâncias descartadas no último update().
+    OcclusionBuffer occlusionBuffer;               ///< Profundidade dos oclusores, rasterizada na CPU.
+    bool occlusionCulling;                         ///< Descarta as instâncias ocultas pelos oclusores.
+    size_t maxOccluders;                           ///< Instâncias rasterizadas como oclusores a cada quadro.
+    std::vector<float> staticPositions;            ///< Posições dos oclusores fixos (x, y, z por vértice).
+    std::vector<uint32_t> staticIndices;           ///< Triângulos dos oclusores fixos.
+    std::vector<float> occluderPositions;          ///< Oclusor de cada instância escolhida, após o skinning.
+    SkinningKernel skinningKernel;                 ///< Kernel usado no skinning dos oclusores.
+    size_t occludedCount;                          ///< Instâncias descartadas por oclusão no último update().
+    double occlusionMilliseconds;                  ///< Duração do descarte por oclusão no último update().
+
+public:
+    /**
+     * @brief Construtor, cria uma multidão vazia.
+     */
+    Crowd();
+
+    Crowd(const Crowd &) = delete;
+    Crowd &operator=(const Crowd &) = delete;
+
+    /**
+     * @brief Distribui instâncias de um asset em uma grade diante da origem.
+     *
+     * A instância 0 fica na origem, na posição do personagem original; as demais ocupam fileiras atrás
+     * dela, com orientação e fase de animação aleatórias. Com clips no modelo, cada instância reproduz
+     * um deles em loop.
+     *
+     * @param asset Asset já carregado, com skinning na GPU disponível.
+     * @param count Quantidade de instâncias.
+     * @param seed Semente da orientação, do clip e da fase de cada instância.
+     * @return true se a multidão foi criada, false se o skinning na GPU não estiver disponível.
+     */
+    bool create(std::shared_ptr<const SkinnedMeshAsset> asset, size_t count, unsigned int seed = 1234);
+
+    /**
+     * @brief Libera os recursos OpenGL e as instâncias.
+     */
+    void destroy();
+
+    /**
+     * @brief Quantidade de instâncias.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Retorna as instâncias da multidão.
+     */
+    const std::vector<CrowdInstance> &getInstances() const;
+
+    /**
+     * @brief Define o pool de threads usado para avaliar as poses das instâncias.
+     * @param pool Pool de threads, que deve existir enquanto a multidão for atualizada (nullptr desativa).
+     */
+    void setThreadPool(ThreadPool *pool);
+
+    /**
+     * @brief Define a câmera usada para escolher o LOD de cada instância.
+     * @param sceneCamera Câmera da cena (nullptr desenha todas as instâncias no LOD 0).
+     */
+    void setCamera(const Camera3D *sceneCamera);
+
+    /**
+     * @brief Ativa a redução da frequência da animação pelo LOD de cada instância (ativa por padrão).
+     * @param enabled false avalia a pose de todas as instâncias a cada update().
+     */
+    void setAnimationLod(bool enabled);
+
+    /**
+     * @brief Informa se a frequência da animação é reduzida pelo LOD.
+     */
+    bool getAnimationLod() const;
+
+    /**
+     * @brief Quantidade de instâncias com a pose avaliada no último update(); as demais foram interpoladas.
+     */
+    size_t getEvaluatedCount() const;
+
+    /**
+     * @brief Define o atlas usado para desenhar as instâncias distantes como impostores.
+     * @param atlas Atlas já criado, que deve existir enquanto a multidão existir (nullptr desativa).
+     * @param maxPixels Altura projetada, em pixels, abaixo da qual a instância vira impostor.
+     */
+    void setImpostors(const ImpostorAtlas *atlas, float maxPixels = IMPOSTOR_MAX_PIXELS);
+
+    /**
+     * @brief Quantidade de instâncias desenhadas como impostores no último update().
+     */
+    size_t getImpostorCount() const;
+
+    /**
+     * @brief Ativa o descarte das instâncias fora do frustum da câmera (ativo por padrão).
+     */
+    void setFrustumCulling(bool enabled);
+
+    /**
+     * @brief Informa se as instâncias fora do frustum são descartadas.
+     */
+    bool getFrustumCulling() const;
+
+    /**
+     * @brief Define se o skinning na GPU aplica a iluminação (ativa por padrão, como em Light::apply()).
+     */
+    void setLighting(bool enabled);
+
+    /**
+     * @brief Informa se o skinning na GPU aplica a iluminação.
+     */
+    bool getLighting() const;
+
+    /**
+     * @brief Quantidade de instâncias (malhas e impostores) descartadas no último update(), fora do frustum
+     * ou ocultas pelos oclusores.
+     */
+    size_t getCulledCount() const;
+
+    /**
+     * @brief Ativa o descarte das instâncias ocultas por oclusores (desativado por padrão).
+     * @param enabled true rasteriza os oclusores e testa as instâncias a cada update().
+     * @param occluders Quantidade de instâncias mais próximas rasterizadas como oclusores.
+     */
+    void setOcclusionCulling(bool enabled, size_t occluders = CROWD_MAX_OCCLUDERS);
+
+    /**
+     * @brief Informa se o descarte por oclusão está ativo.
+     */
+    bool getOcclusionCulling() const;
+
+    /**
+     * @brief Acrescenta um oclusor fixo, rasterizado em todos os quadros com o descarte por oclusão.
+     * @param positions Posições no mundo (x, y, z por vértice).
+     * @param indices Triângulos, nos vértices de positions.
+     */
+    void addStaticOccluder(const std::vector<glm::vec3> &positions, const std::vector<uint32_t> &indices);
+
+    /**
+     * @brief Quantidade de instâncias, dentro do frustum, descartadas por oclusão no último update().
+     */
+    size_t getOccludedCount() const;
+
+    /**
+     * @brief Duração, em milissegundos, do descarte por oclusão no último update() (skinning dos oclusores,
+     * rasterização, pirâmide e testes).
+     */
+    double getOcclusionTime() const;
+
+    /**
+     * @brief Retorna o buffer de profundidade dos oclusores do último update().
+     */
+    const OcclusionBuffer &getOcclusionBuffer() const;
+
+    /**
+     * @brief Avança as animações e monta as paletas de todas as instâncias.
+     *
+     * Só as instâncias que chegaram à paleta alvo têm a pose avaliada; as demais são interpoladas.
+     * @param deltaTime Tempo decorrido desde a última chamada, em segundos.
+     */
+    void update(float deltaTime);
+
+    /**
+     * @brief Desenha todas as instâncias com as paletas do último update().
+     */
+    void draw() const;
+
+private:
+    /**
+     * @brief Agrupa as instâncias pelo LOD (ou impostor) escolhido a partir da altura projetada de cada uma.
+     */
+    void sortByLod();
+
+    /**
+     * @brief Monta as paletas das instâncias de um intervalo de instanceOrder, avaliando a pose das que
+     * chegaram à paleta alvo e interpolando as demais.
+     * @param begin Primeira posição do intervalo.
+     * @param end Posição seguinte à última do intervalo.
+     */
+    void evaluateInstances(size_t begin, size_t end);
+
+    /**
+     * @brief Calcula a caixa no mundo de um intervalo de instanceOrder a partir das paletas já montadas.
+     * @param begin Primeira posição do intervalo.
+     * @param end Posição seguinte à última do intervalo.
+     */
+    void boundInstances(size_t begin, size_t end);
+
+    /**
+     * @brief Testa as caixas de todas as instâncias contra o frustum e os oclusores e retira as descartadas
+     * das paletas e dos impostores, mantendo as paletas agrupadas por LOD.
+     */
+    void cullInstances();
+
+    /**
+     * @brief Rasteriza os oclusores fixos e as instâncias visíveis mais próximas da câmera, escolhidas pela
+     * profundidade do centro da caixa no espaço da câmera, e descarta as instâncias cujas caixas ficaram
+     * atrás deles.
+     */
+    void cullOccludedInstances();
+
+    /**
+     * @brief Quadros entre avaliações da pose de uma instância, pelo seu LOD.
+     */
+    uint32_t updateInterval(size_t index) const;
+
+    /**
+     * @brief Posição no mundo de um ponto do modelo, com a posição e a rotação da instância.
+     */
+    static glm::vec3 worldCenter(const CrowdInstance &instance, const glm::vec3 &center);
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "gpuskinning.hpp"
+#include "renderstats.hpp"
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+
+// Decodifica a posição da bind pose (float ou quantizada na AABB do submesh), aplica o skinning com a paleta
+// em colunas (mesmo layout de buildSkinningPalette) e calcula a iluminação por vértice do pipeline fixo para
+// a luz 0, com a normal corrente (não há array de normais, como no caminho da CPU). Em desenhos instanciados,
+// cada instância lê a própria paleta, de instanceStride matrizes, a partir de firstInstance.
+static const char *SKINNING_VERTEX_SHADER = R"(
+#version 140
+#extension GL_ARB_compatibility : require
+
+uniform samplerBuffer palette;
+uniform bool lighting;
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+uniform int instanceStride;
+uniform int firstInstance;
+
+in vec4 position;
+in uvec4 boneIDs;
+in vec4 weights;
+
+mat4 boneMatrix(int bone)
+{
+    int base = ((firstInstance + gl_InstanceID) * instanceStride + bone) * 4;
+    return mat4(texelFetch(palette, base), texelFetch(palette, base + 1),
+                texelFetch(palette, base + 2), texelFetch(palette, base + 3));
+}
+
+vec4 fixedFunctionLighting(vec3 eyePosition)
+{
+    vec3 normal = normalize(gl_NormalMatrix * gl_Normal);
+    vec4 lightPosition = gl_LightSource[0].position;
+    vec3 lightDirection = lightPosition.xyz;
+    float attenuation = 1.0;
+    if (lightPosition.w != 0.0)
+    {
+        lightDirection = lightPosition.xyz / lightPosition.w - eyePosition;
+        float distance = length(lightDirection);
+        attenuation = 1.0 / (gl_LightSource[0].constantAttenuation + gl_LightSource[0].linearAttenuation * distance +
+                             gl_LightSource[0].quadraticAttenuation * distance * distance);
+    }
+    lightDirection = normalize(lightDirection);
+
+    float diffuse = max(dot(normal, lightDirection), 0.0);
+    vec4 color = gl_FrontLightModelProduct.sceneColor +
+                 attenuation * (gl_FrontLightProduct[0].ambient + diffuse * gl_FrontLightProduct[0].diffuse);
+    if (diffuse > 0.0)
+    {
+        vec3 halfVector = normalize(lightDirection + vec3(0.0, 0.0, 1.0));
+        float specular = pow(max(dot(normal, halfVector), 0.0), gl_FrontMaterial.shininess);
+        color += attenuation * specular * gl_FrontLightProduct[0].specular;
+    }
+    color.a = gl_FrontMaterial.diffuse.a;
+    return color;
+}
+
+void main()
+{
+    ivec4 bones = ivec4(boneIDs);
+    mat4 skin = weights.x * boneMatrix(bones.x) + weights.y * boneMatrix(bones.y) +
+                weights.z * boneMatrix(bones.z) + weights.w * boneMatrix(bones.w);
+    vec3 bindPosition = positionOffset + positionScale * position.xyz;
+    vec4 skinnedPosition = vec4((skin * vec4(bindPosition, 1.0)).xyz, 1.0);
+    vec4 eyePosition = gl_ModelViewMatrix * skinnedPosition;
+
+    gl_Position = gl_ProjectionMatrix * eyePosition;
+    gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+    gl_FrontColor = lighting ? fixedFunctionLighting(eyePosition.xyz) : gl_Color;
+    gl_BackColor = gl_FrontColor;
+}
+)";
+
+GpuPalette::GpuPalette() : paletteBuffer(0), paletteTexture(0)
+{
+}
+
+GpuPalette::~GpuPalette()
+{
+    destroy();
+}
+
+size_t GpuPalette::maxMatrices()
+{
+    // Cada matriz ocupa 4 texels RGBA32F; o mínimo garantido pelo OpenGL 3.1 é de 65536 texels
+    GLint texels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &texels);
+    return std::max<GLint>(texels, 65536) / 4;
+}
+
+bool GpuPalette::create()
+{
+    destroy();
+    if (!GpuSkinning::isSupported())
+        return false;
+
+    // A paleta é exposta ao shader como um texture buffer de texels RGBA32F (uma coluna por texel)
+    glGenBuffers(1, &paletteBuffer);
+    glGenTextures(1, &paletteTexture);
+    glBindBuffer(GL_TEXTURE_BUFFER, paletteBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, SKINNING_PALETTE_STRIDE * sizeof(float), nullptr, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, paletteTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, paletteBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    return true;
+}
+
+void GpuPalette::destroy()
+{
+    if (paletteTexture)
+        glDeleteTextures(1, &paletteTexture);
+    if (paletteBuffer)
+        glDeleteBuffers(1, &paletteBuffer);
+    paletteBuffer = paletteTexture = 0;
+}
+
+bool GpuPalette::isReady() const
+{
+    return paletteTexture != 0;
+}
+
+void GpuPalette::upload(const std::vector<float> &palette)
+{
+    upload(palette.data(), palette.size());
+}
+
+void GpuPalette::upload(const float *palette, size_t count)
+{
+    // Orphaning: o driver fornece memória nova se a paleta anterior ainda estiver em uso
+    GLsizeiptr size = count * sizeof(float);
+    glBindBuffer(GL_TEXTURE_BUFFER, paletteBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, size, palette);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    renderStats.glCalls += 4;
+}
+
+void GpuPalette::bind() const
+{
+    glActiveTexture(GpuSkinning::PALETTE_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, paletteTexture);
+    glActiveTexture(GL_TEXTURE0);
+    renderStats.glCalls += 3;
+}
+
+GpuSkinning::GpuSkinning()
+    : vertexArray(0), bindPoseBuffer(0), influenceBuffer(0), lightingLocation(-1), positionOffsetLocation(-1), positionScaleLocation(-1), instanceStrideLocation(-1), firstInstanceLocation(-1)
+{
+}
+
+GpuSkinning::~GpuSkinning()
+{
+    destroy();
+}
+
+bool GpuSkinning::isSupported()
+{
+    return GLEW_VERSION_3_1;
+}
+
+
+bool GpuSkinning::create(const std::vector<SkinningStreams> &streams, GLuint texCoordBuffer, GLenum texCoordType,
+                         GLuint indexBuffer)
+{
+    destroy();
+    if (!isSupported())
+        return false;
+
+    if (!program.build(SKINNING_VERTEX_SHADER, nullptr,
+                       {{POSITION_ATTRIBUTE, "position"}, {BONE_IDS_ATTRIBUTE, "boneIDs"}, {WEIGHTS_ATTRIBUTE, "weights"}}))
+        return false;
+    lightingLocation = program.uniform("lighting");
+    positionOffsetLocation = program.uniform("positionOffset");
+    positionScaleLocation = program.uniform("positionScale");
+    instanceStrideLocation = program.uniform("instanceStride");
+    firstInstanceLocation = program.uniform("firstInstance");
+    glUseProgram(program.id());
+    glUniform1i(program.uniform("palette"), PALETTE_TEXTURE_UNIT - GL_TEXTURE0);
+    glUseProgram(0);
+
+    // As influências já estão compactadas no formato dos atributos (índices inteiros e pesos unorm);
+    // as posições SoA são intercaladas, em float ou em 4 componentes de 16 bits (a última é preenchimento)
+    std::vector<uint8_t> positions;
+    std::vector<uint8_t> influences;
+    InfluenceFormat format = streams.empty() ? InfluenceFormat::Unorm8 : streams[0].influenceFormat;
+    VertexFormat vertexFormat = streams.empty() ? VertexFormat::Float : streams[0].vertexFormat;
+    for (const auto &stream : streams)
+    {
+        if (stream.influenceFormat != format || stream.vertexFormat != vertexFormat)
+        {
+            std::cerr << "Formatos de vértice diferentes entre submeshes" << std::endl;
+            destroy();
+            return false;
+        }
+        for (size_t i = 0; i < stream.size(); i++)
+        {
+            if (vertexFormat == VertexFormat::Float)
+            {
+                const float position[3] = {stream.x[i], stream.y[i], stream.z[i]};
+                const uint8_t *bytes = reinterpret_cast<const uint8_t *>(position);
+                positions.insert(positions.end(), bytes, bytes + sizeof(position));
+            }
+            else
+            {
+                const uint16_t position[4] = {stream.qx[i], stream.qy[i], stream.qz[i], 0};
+                const uint8_t *bytes = reinterpret_cast<const uint8_t *>(position);
+                positions.insert(positions.end(), bytes, bytes + sizeof(position));
+            }
+        }
+        influences.insert(influences.end(), stream.influences.begin(), stream.influences.end());
+    }
+    GLenum componentType = format == InfluenceFormat::Unorm8 ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT;
+    GLsizei stride = format == InfluenceFormat::Unorm8 ? 8 : 16;
+
+    glGenVertexArrays(1, &vertexArray);
+    glBindVertexArray(vertexArray);
+
+    // O atributo 0 substitui gl_Vertex; quantizado, é normalizado para [0, 1] e decodificado com a AABB
+    glGenBuffers(1, &bindPoseBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, bindPoseBuffer);
+    glBufferData(GL_ARRAY_BUFFER, positions.size(), positions.data(), GL_STATIC_DRAW);
+    if (vertexFormat == VertexFormat::Float)
+        glVertexAttribPointer(POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    else
+        glVertexAttribPointer(POSITION_ATTRIBUTE, 4, GL_UNSIGNED_SHORT, GL_TRUE, 0, nullptr);
+    glEnableVertexAttribArray(POSITION_ATTRIBUTE);
+
+    glGenBuffers(1, &influenceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, influenceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, influences.size(), influences.data(), GL_STATIC_DRAW);
+    glVertexAttribIPointer(BONE_IDS_ATTRIBUTE, 4, componentType, stride, nullptr);
+    glVertexAttribPointer(WEIGHTS_ATTRIBUTE, 4, componentType, GL_TRUE, stride, reinterpret_cast<const void *>(stride / 2));
+    glEnableVertexAttribArray(BONE_IDS_ATTRIBUTE);
+    glEnableVertexAttribArray(WEIGHTS_ATTRIBUTE);
+
+    // UVs e índices são os mesmos buffers usados no skinning da CPU
+    glBindBuffer(GL_ARRAY_BUFFER, texCoordBuffer);
+    glTexCoordPointer(2, texCoordType, 0, nullptr);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void GpuSkinning::destroy()
+{
+    program.destroy();
+    if (influenceBuffer)
+        glDeleteBuffers(1, &influenceBuffer);
+    if (bindPoseBuffer)
+        glDeleteBuffers(1, &bindPoseBuffer);
+    if (vertexArray)
+        glDeleteVertexArrays(1, &vertexArray);
+    vertexArray = bindPoseBuffer = influenceBuffer = 0;
+}
+
+bool GpuSkinning::isReady() const
+{
+    return vertexArray != 0;
+}
+
+void GpuSkinning::bind(const GpuPalette &palette, bool lighting) const
+{
+    glUseProgram(program.id());
+    glUniform1i(lightingLocation, lighting);
+    setInstanceLayout(0, 0);
+    palette.bind();
+    glBindVertexArray(vertexArray);
+    renderStats.glCalls += 4;
+}
+
+void GpuSkinning::setPositionDecode(const SkinningStreams &streams) const
+{
+    // A normalização do atributo leva as coordenadas quantizadas para [0, 1], e não [0, 65535]
+    float extent = streams.vertexFormat == VertexFormat::Quantized ? 65535.0f : 1.0f;
+    glUniform3f(positionOffsetLocation, streams.positionOffset[0], streams.positionOffset[1], streams.positionOffset[2]);
+    glUniform3f(positionScaleLocation, streams.positionScale[0] * extent, streams.positionScale[1] * extent,
+                streams.positionScale[2] * extent);
+    renderStats.glCalls += 2;
+}
+
+void GpuSkinning::setInstanceLayout(GLint stride, GLint first) const
+{
+    glUniform1i(instanceStrideLocation, stride);
+    glUniform1i(firstInstanceLocation, first);
+    renderStats.glCalls += 2;
+}
+
+void GpuSkinning::unbind() const
+{
+    glBindVertexArray(0);
+    glUseProgram(0);
+    renderStats.glCalls += 2;
+}
@@ -0,0 +1,171 @@
+#ifndef GPUSKINNING_HPP
+#define GPUSKINNING_HPP
+
+#include <GL/glew.h>
+#include <vector>
+#include "shader.hpp"
+#include "skinning.hpp"
+
+/**
+ * @brief Paleta de matrizes de skinning na GPU: um buffer exposto ao shader como texture buffer.
+ *
+ * Cada personagem (ou multidão) possui a sua, enquanto o programa e os atributos de vértice de
+ * GpuSkinning são compartilhados por todos que usam o mesmo modelo.
+ */
+class GpuPalette
+{
+private:
+    GLuint paletteBuffer;  ///< Buffer com a paleta de matrizes, atualizado a cada quadro.
+    GLuint paletteTexture; ///< Texture buffer que expõe a paleta ao shader.
+
+public:
+    /**
+     * @brief Construtor, não cria recursos OpenGL.
+     */
+    GpuPalette();
+
+    /**
+     * @brief Destrutor, libera os recursos OpenGL.
+     */
+    ~GpuPalette();
+
+    GpuPalette(const GpuPalette &) = delete;
+    GpuPalette &operator=(const GpuPalette &) = delete;
+
+    /**
+     * @brief Quantidade máxima de matrizes em uma paleta enviada, limitada por GL_MAX_TEXTURE_BUFFER_SIZE.
+     */
+    static size_t maxMatrices();
+
+    /**
+     * @brief Cria o buffer e o texture buffer.
+     * @return true se os recursos foram criados, false se não houver suporte (OpenGL 3.1).
+     */
+    bool create();
+
+    /**
+     * @brief Libera os recursos OpenGL.
+     */
+    void destroy();
+
+    /**
+     * @brief Informa se os recursos foram criados com sucesso.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Envia a paleta de matrizes do quadro atual.
+     * @param palette Paleta montada por buildSkinningPalette().
+     */
+    void upload(const std::vector<float> &palette);
+
+    /**
+     * @brief Envia as paletas de várias instâncias, concatenadas.
+     * @param palette Paletas no formato de buildSkinningPalette().
+     * @param count Quantidade de floats.
+     */
+    void upload(const float *palette, size_t count);
+
+    /**
+     * @brief Vincula a paleta à unidade de textura lida pelo shader de GpuSkinning.
+     */
+    void bind() const;
+};
+
+/**
+ * @brief Skinning no vertex shader a partir de uma paleta de matrizes em um texture buffer.
+ *
+ * Posições da bind pose, bones e pesos são enviados uma única vez como atributos de vértice; a cada
+ * quadro apenas a paleta (GpuPalette) é atualizada. O shader reproduz a iluminação por vértice do
+ * pipeline fixo e não possui fragment shader, de modo que texturização e demais etapas continuam no
+ * pipeline fixo.
+ */
+class GpuSkinning
+{
+public:
+    static const GLuint POSITION_ATTRIBUTE = 0;             ///< Localização do atributo com a posição da bind pose.
+    static const GLuint BONE_IDS_ATTRIBUTE = 1;             ///< Localização do atributo com os índices dos bones.
+    static const GLuint WEIGHTS_ATTRIBUTE = 2;              ///< Localização do atributo com os pesos.
+    static const GLenum PALETTE_TEXTURE_UNIT = GL_TEXTURE1; ///< Unidade de textura da paleta.
+
+private:
+    ShaderProgram program;        ///< Programa de skinning.
+    GLuint vertexArray;           ///< VAO com posições da bind pose, influências, UVs e índices.
+    GLuint bindPoseBuffer;        ///< VBO estático com as posições da bind pose.
+    GLuint influenceBuffer;       ///< VBO estático com as influências compactadas dos streams de skinning.
+    GLint lightingLocation;       ///< Uniform que ativa a iluminação de GL_LIGHT0.
+    GLint positionOffsetLocation; ///< Uniform com o canto mínimo da AABB do submesh.
+    GLint positionScaleLocation;  ///< Uniform com a escala de decodificação das posições do submesh.
+    GLint instanceStrideLocation; ///< Uniform com a quantidade de matrizes da paleta de cada instância.
+    GLint firstInstanceLocation;  ///< Uniform com a paleta da primeira instância do próximo desenho.
+
+public:
+    /**
+     * @brief Construtor, não cria recursos OpenGL.
+     */
+    GpuSkinning();
+
+    /**
+     * @brief Destrutor, libera os recursos OpenGL.
+     */
+    ~GpuSkinning();
+
+    GpuSkinning(const GpuSkinning &) = delete;
+    GpuSkinning &operator=(const GpuSkinning &) = delete;
+
+    /**
+     * @brief Informa se o contexto atual suporta o skinning na GPU (OpenGL 3.1 / GLSL 1.40).
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Compila o shader e envia os atributos estáticos de todos os submeshes.
+     * @param streams Streams de skinning de cada submesh, na ordem dos buffers do personagem.
+     * @param texCoordBuffer VBO de UVs do personagem, compartilhado com o caminho da CPU.
+     * @param texCoordType Tipo das UVs no VBO (GL_FLOAT ou GL_HALF_FLOAT).
+     * @param indexBuffer Buffer de índices do personagem, compartilhado com o caminho da CPU.
+     * @return true se os recursos foram criados, false caso contrário.
+     */
+    bool create(const std::vector<SkinningStreams> &streams, GLuint texCoordBuffer, GLenum texCoordType, GLuint indexBuffer);
+
+    /**
+     * @brief Libera os recursos OpenGL.
+     */
+    void destroy();
+
+    /**
+     * @brief Informa se os recursos foram criados com sucesso.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Ativa o programa e o VAO para os comandos de desenho seguintes, com uma única paleta.
+     * @param palette Paleta lida pelo shader.
+     * @param lighting Aplica a iluminação de GL_LIGHT0, como o pipeline fixo com GL_LIGHTING ativo.
+     */
+    void bind(const GpuPalette &palette, bool lighting) const;
+
+    /**
+     * @brief Define a decodificação das posições do próximo submesh desenhado (entre bind() e unbind()).
+     * @param streams Streams de skinning do submesh.
+     */
+    void setPositionDecode(const SkinningStreams &streams) const;
+
+    /**
+     * @brief Define onde cada instância lê sua paleta nos próximos desenhos instanciados (entre bind() e unbind()).
+     *
+     * A instância i do desenho usa as matrizes a partir de (first + i) * stride. bind() volta ao padrão,
+     * em que todas as instâncias usam a paleta a partir da matriz 0.
+     *
+     * @param stride Quantidade de matrizes por instância.
+     * @param first Paleta da primeira instância do desenho.
+     */
+    void setInstanceLayout(GLint stride, GLint first) const;
+
+    /**
+     * @brief Restaura o pipeline fixo.
+     */
+    void unbind() const;
+};
+
+#endif
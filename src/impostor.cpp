@@ -0,0 +1,291 @@
+#include "impostor.hpp"
+#include "characterinstance.hpp"
+#include "renderstats.hpp"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+ImpostorAtlas::ImpostorAtlas()
+    : texture(0), viewCount(0), cellSize(0), columns(0), rows(0), boundsCenter(0.0f), boundsRadius(0.0f),
+      bakeMilliseconds(0.0)
+{
+}
+
+ImpostorAtlas::~ImpostorAtlas()
+{
+    destroy();
+}
+
+bool ImpostorAtlas::isSupported()
+{
+    return GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object;
+}
+
+bool ImpostorAtlas::bake(std::shared_ptr<const SkinnedMeshAsset> asset, int views, int cell)
+{
+    destroy();
+    if (!asset || views <= 0 || cell <= 0)
+        return false;
+    if (!isSupported())
+    {
+        std::cerr << "Impostores requerem framebuffers fora da tela (OpenGL 3.0)" << std::endl;
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // Personagem temporário na pose a pré-renderizar, com o skinning na CPU e sem câmera (LOD 0, sem descarte)
+    CharacterInstance character;
+    if (!character.setAsset(asset))
+        return false;
+    if (character.getAnimationCount() > 0)
+        character.playAnimation(0, false);
+    character.setLighting(false);
+    character.update();
+    asset->getBounds(boundsCenter, boundsRadius);
+    boundsRadius = std::max(boundsRadius, 0.001f);
+
+    viewCount = views;
+    cellSize = cell;
+    columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(views))));
+    rows = (views + columns - 1) / columns;
+    int width = columns * cellSize, height = rows * cellSize;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLuint framebuffer, depthBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    if (complete)
+    {
+        // Estado da cena preservado: viewport, cor de limpeza, iluminação e matrizes
+        glPushAttrib(GL_VIEWPORT_BIT | GL_COLOR_BUFFER_BIT | GL_ENABLE_BIT | GL_CURRENT_BIT);
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+
+        // Fundo transparente e cores da textura sem iluminação; a luz é aplicada ao desenhar o impostor
+        glViewport(0, 0, width, height);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glDisable(GL_LIGHTING);
+        glDisable(GL_CULL_FACE);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_TEXTURE_2D);
+        glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+        // Projeção ortográfica da esfera envolvente, com a câmera no plano horizontal do centro e Z para cima
+        float r = boundsRadius;
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(-r, r, -r, r, 0.0, 4.0 * r);
+        glMatrixMode(GL_MODELVIEW);
+        for (int view = 0; view < viewCount; view++)
+        {
+            float angle = 2.0f * static_cast<float>(M_PI) * view / viewCount;
+            glm::vec3 eye = boundsCenter + 2.0f * r * glm::vec3(std::cos(angle), std::sin(angle), 0.0f);
+            glViewport((view % columns) * cellSize, (view / columns) * cellSize, cellSize, cellSize);
+            glLoadIdentity();
+            gluLookAt(eye.x, eye.y, eye.z, boundsCenter.x, boundsCenter.y, boundsCenter.z, 0.0, 0.0, 1.0);
+            character.draw();
+        }
+
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+        glPopMatrix();
+        glPopAttrib();
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    if (!complete)
+    {
+        std::cerr << "Framebuffer do atlas de impostores incompleto" << std::endl;
+        destroy();
+        return false;
+    }
+
+    // Os mipmaps evitam o serrilhado dos impostores pequenos
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    bakeMilliseconds = elapsed.count();
+    std::cout << "Atlas de impostores: " << viewCount << " direções em " << width << "x" << height << ", "
+              << memoryBytes() / 1024 << " KB, gerado em " << bakeMilliseconds << " ms" << std::endl;
+    return true;
+}
+
+void ImpostorAtlas::destroy()
+{
+    if (texture)
+        glDeleteTextures(1, &texture);
+    texture = 0;
+    viewCount = cellSize = columns = rows = 0;
+}
+
+bool ImpostorAtlas::isReady() const
+{
+    return texture != 0;
+}
+
+GLuint ImpostorAtlas::getTexture() const
+{
+    return texture;
+}
+
+int ImpostorAtlas::getViewCount() const
+{
+    return viewCount;
+}
+
+int ImpostorAtlas::selectView(float angle) const
+{
+    int view = static_cast<int>(std::lround(angle * viewCount / (2.0f * static_cast<float>(M_PI)))) % viewCount;
+    return view < 0 ? view + viewCount : view;
+}
+
+void ImpostorAtlas::getCell(int view, float &u0, float &v0, float &u1, float &v1) const
+{
+    float cellU = 1.0f / columns, cellV = 1.0f / rows;
+    u0 = (view % columns) * cellU;
+    v0 = (view / columns) * cellV;
+    u1 = u0 + cellU;
+    v1 = v0 + cellV;
+}
+
+void ImpostorAtlas::getBounds(glm::vec3 &center, float &radius) const
+{
+    center = boundsCenter;
+    radius = boundsRadius;
+}
+
+size_t ImpostorAtlas::memoryBytes() const
+{
+    // Cada nível de mipmap tem um quarto dos pixels do anterior
+    size_t bytes = 0;
+    for (size_t width = columns * cellSize, height = rows * cellSize; width > 0 || height > 0; width /= 2, height /= 2)
+        bytes += std::max<size_t>(width, 1) * std::max<size_t>(height, 1) * 4;
+    return isReady() ? bytes : 0;
+}
+
+double ImpostorAtlas::getBakeTime() const
+{
+    return bakeMilliseconds;
+}
+
+ImpostorRenderer::ImpostorRenderer() : vertexArray(0), capacity(0)
+{
+}
+
+ImpostorRenderer::~ImpostorRenderer()
+{
+    destroy();
+}
+
+bool ImpostorRenderer::create(size_t maxInstances)
+{
+    destroy();
+    if (maxInstances == 0 || !stream.create(maxInstances * 4 * 5 * sizeof(float)))
+        return false;
+    glGenVertexArrays(1, &vertexArray);
+    glBindVertexArray(vertexArray);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glBindVertexArray(0);
+    capacity = maxInstances;
+    return true;
+}
+
+void ImpostorRenderer::destroy()
+{
+    stream.destroy();
+    if (vertexArray)
+        glDeleteVertexArrays(1, &vertexArray);
+    vertexArray = 0;
+    capacity = 0;
+}
+
+size_t ImpostorRenderer::getCapacity() const
+{
+    return capacity;
+}
+
+void ImpostorRenderer::draw(const ImpostorAtlas &atlas, const glm::vec3 &eye, const ImpostorInstance *instances,
+                            size_t count) const
+{
+    count = std::min(count, capacity);
+    if (count == 0 || !atlas.isReady())
+        return;
+
+    // Quads verticais voltados para a câmera (só giram em torno do eixo Z, como as direções do atlas):
+    // u, v, x, y, z por vértice, no mesmo layout do fundo
+    glm::vec3 center;
+    float radius;
+    atlas.getBounds(center, radius);
+    float *vertices = static_cast<float *>(stream.beginWrite());
+    for (size_t i = 0; i < count; i++)
+    {
+        const ImpostorInstance &instance = instances[i];
+        float angle = std::atan2(eye.y - instance.center.y, eye.x - instance.center.x);
+        float u0, v0, u1, v1;
+        atlas.getCell(atlas.selectView(angle - instance.heading), u0, v0, u1, v1);
+
+        // Na célula, u cresce para a direita da câmera do bake, que é perpendicular à direção da câmera
+        glm::vec3 right(-std::sin(angle) * radius, std::cos(angle) * radius, 0.0f);
+        glm::vec3 up(0.0f, 0.0f, radius);
+        const glm::vec3 corners[4] = {instance.center - right - up, instance.center + right - up,
+                                      instance.center + right + up, instance.center - right + up};
+        const float texCoords[4][2] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+        for (int k = 0; k < 4; k++)
+        {
+            *vertices++ = texCoords[k][0];
+            *vertices++ = texCoords[k][1];
+            *vertices++ = corners[k].x;
+            *vertices++ = corners[k].y;
+            *vertices++ = corners[k].z;
+        }
+    }
+    stream.endWrite();
+
+    // O teste de alfa descarta o fundo transparente das células sem exigir ordenação; a normal corrente
+    // é a mesma dos personagens, então a iluminação por vértice é equivalente
+    const GLsizei stride = 5 * sizeof(GLfloat);
+    const char *offset = reinterpret_cast<const char *>(stream.currentOffset());
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, stream.buffer());
+    glTexCoordPointer(2, GL_FLOAT, stride, offset);
+    glVertexPointer(3, GL_FLOAT, stride, offset + 2 * sizeof(GLfloat));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glNormal3f(0.0f, 0.0f, 1.0f);
+    glEnable(GL_ALPHA_TEST);
+    glAlphaFunc(GL_GREATER, 0.5f);
+    glBindTexture(GL_TEXTURE_2D, atlas.getTexture());
+    glDrawArrays(GL_QUADS, 0, count * 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_ALPHA_TEST);
+    glBindVertexArray(0);
+    renderStats.glCalls += 12;
+    renderStats.drawCalls++;
+    renderStats.triangles += count * 2;
+    stream.fence();
+}
@@ -0,0 +1,191 @@
+#ifndef IMPOSTOR_HPP
+#define IMPOSTOR_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "skinnedmeshasset.hpp"
+#include "streambuffer.hpp"
+
+/**
+ * @brief Quantidade padrão de direções, em volta do eixo Z, pré-renderizadas no atlas de impostores.
+ */
+const int IMPOSTOR_VIEW_COUNT = 16;
+
+/**
+ * @brief Lado padrão, em pixels, da célula de cada direção no atlas.
+ */
+const int IMPOSTOR_CELL_SIZE = 128;
+
+/**
+ * @brief Altura projetada, em pixels, abaixo da qual um personagem é desenhado como impostor.
+ */
+const float IMPOSTOR_MAX_PIXELS = 32.0f;
+
+/**
+ * @brief Posição de um impostor a desenhar.
+ */
+struct ImpostorInstance
+{
+    glm::vec3 center; ///< Centro da esfera envolvente do modelo, no mundo.
+    float heading;    ///< Rotação do modelo em torno do eixo Z, em radianos.
+};
+
+/**
+ * @brief Atlas com o modelo pré-renderizado de várias direções, usado para desenhar personagens distantes.
+ *
+ * Cada célula guarda a vista ortográfica da esfera envolvente a partir de uma direção horizontal, com
+ * as cores da textura sem iluminação e alfa 0 fora do modelo. A iluminação é aplicada ao desenhar o
+ * impostor, com a mesma normal corrente usada nos caminhos de skinning.
+ */
+class ImpostorAtlas
+{
+private:
+    GLuint texture;          ///< Textura do atlas (RGBA, com mipmaps).
+    int viewCount;           ///< Quantidade de direções pré-renderizadas.
+    int cellSize;            ///< Lado de cada célula, em pixels.
+    int columns;             ///< Células por linha do atlas.
+    int rows;                ///< Linhas de células do atlas.
+    glm::vec3 boundsCenter;  ///< Centro da esfera envolvente, no espaço do modelo.
+    float boundsRadius;      ///< Raio da esfera envolvente.
+    double bakeMilliseconds; ///< Duração do último bake().
+
+public:
+    /**
+     * @brief Construtor, cria um atlas vazio.
+     */
+    ImpostorAtlas();
+
+    /**
+     * @brief Destrutor, libera a textura do atlas.
+     */
+    ~ImpostorAtlas();
+
+    ImpostorAtlas(const ImpostorAtlas &) = delete;
+    ImpostorAtlas &operator=(const ImpostorAtlas &) = delete;
+
+    /**
+     * @brief Informa se o contexto suporta framebuffers fora da tela (OpenGL 3.0 ou ARB_framebuffer_object).
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Renderiza o modelo em um framebuffer fora da tela, de viewCount direções em volta do eixo Z.
+     *
+     * A pose é a do primeiro quadro do clip 0 (a bind pose se o modelo não tiver clips). As texturas do
+     * asset já devem ter sido enviadas (TextureLoader::finish()).
+     *
+     * @param asset Asset carregado.
+     * @param views Quantidade de direções.
+     * @param cell Lado de cada célula, em pixels.
+     * @return true se o atlas foi criado, false caso contrário.
+     */
+    bool bake(std::shared_ptr<const SkinnedMeshAsset> asset, int views = IMPOSTOR_VIEW_COUNT,
+              int cell = IMPOSTOR_CELL_SIZE);
+
+    /**
+     * @brief Libera a textura do atlas.
+     */
+    void destroy();
+
+    /**
+     * @brief Informa se o atlas foi criado.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Retorna a textura do atlas.
+     */
+    GLuint getTexture() const;
+
+    /**
+     * @brief Retorna a quantidade de direções do atlas.
+     */
+    int getViewCount() const;
+
+    /**
+     * @brief Escolhe a direção pré-renderizada mais próxima.
+     * @param angle Ângulo, no plano XY do modelo, da direção do modelo para a câmera.
+     * @return Índice da direção, entre 0 e getViewCount() - 1.
+     */
+    int selectView(float angle) const;
+
+    /**
+     * @brief Retorna as coordenadas de textura da célula de uma direção.
+     */
+    void getCell(int view, float &u0, float &v0, float &u1, float &v1) const;
+
+    /**
+     * @brief Retorna a esfera envolvente usada no bake, no espaço do modelo.
+     */
+    void getBounds(glm::vec3 &center, float &radius) const;
+
+    /**
+     * @brief Memória da textura do atlas, incluindo os mipmaps, em bytes.
+     */
+    size_t memoryBytes() const;
+
+    /**
+     * @brief Duração do último bake(), em milissegundos.
+     */
+    double getBakeTime() const;
+};
+
+/**
+ * @brief Desenha impostores como quads verticais voltados para a câmera, todos em um único glDrawArrays.
+ *
+ * Os vértices de cada quadro são escritos em um anel de buffers; a célula de cada impostor é a da
+ * direção mais próxima da câmera, relativa à rotação do modelo.
+ */
+class ImpostorRenderer
+{
+private:
+    GLuint vertexArray;          ///< VAO com os arrays de vértices dos quads.
+    mutable StreamBuffer stream; ///< Anel de buffers com u, v, x, y, z de cada vértice.
+    size_t capacity;             ///< Quantidade máxima de impostores por desenho.
+
+public:
+    /**
+     * @brief Construtor, não cria recursos OpenGL.
+     */
+    ImpostorRenderer();
+
+    /**
+     * @brief Destrutor, libera os recursos OpenGL.
+     */
+    ~ImpostorRenderer();
+
+    ImpostorRenderer(const ImpostorRenderer &) = delete;
+    ImpostorRenderer &operator=(const ImpostorRenderer &) = delete;
+
+    /**
+     * @brief Cria o VAO e o anel de buffers.
+     * @param maxInstances Quantidade máxima de impostores por desenho.
+     * @return true se os recursos foram criados, false caso contrário.
+     */
+    bool create(size_t maxInstances);
+
+    /**
+     * @brief Libera os recursos OpenGL.
+     */
+    void destroy();
+
+    /**
+     * @brief Retorna a quantidade máxima de impostores por desenho.
+     */
+    size_t getCapacity() const;
+
+    /**
+     * @brief Desenha os impostores com o atlas, com teste de alfa para descartar o fundo das células.
+     * @param atlas Atlas já criado.
+     * @param eye Posição da câmera, para orientar os quads e escolher as direções.
+     * @param instances Impostores a desenhar.
+     * @param count Quantidade de impostores (no máximo getCapacity()).
+     */
+    void draw(const ImpostorAtlas &atlas, const glm::vec3 &eye, const ImpostorInstance *instances,
+              size_t count) const;
+};
+
+#endif
@@ -0,0 +1,222 @@
+#include "localpose.hpp"
+#include "skinnedmeshasset.hpp"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOCALPOSE_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+void LocalPose::setIdentity(size_t count)
+{
+    tx.assign(count, 0.0f);
+    ty.assign(count, 0.0f);
+    tz.assign(count, 0.0f);
+    qw.assign(count, 1.0f);
+    qx.assign(count, 0.0f);
+    qy.assign(count, 0.0f);
+    qz.assign(count, 0.0f);
+    sx.assign(count, 1.0f);
+    sy.assign(count, 1.0f);
+    sz.assign(count, 1.0f);
+}
+
+void bindLocalPose(const BoneInfo *bones, size_t count, LocalPose &pose)
+{
+    pose.setIdentity(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        aiVector3D scale, translation;
+        aiQuaternion rotation;
+        bones[i].defaultLocalTransform.Decompose(scale, rotation, translation);
+        pose.set(i, translation, rotation, scale);
+    }
+}
+
+/**
+ * @brief Cross-fade de um único bone; usado no fim dos arrays e sem SSE2.
+ */
+static inline void blendBone(const LocalPose &from, const LocalPose &to, float weight, LocalPose &out, size_t i)
+{
+    float r = 1.0f - weight;
+    out.tx[i] = r * from.tx[i] + weight * to.tx[i];
+    out.ty[i] = r * from.ty[i] + weight * to.ty[i];
+    out.tz[i] = r * from.tz[i] + weight * to.tz[i];
+    out.sx[i] = r * from.sx[i] + weight * to.sx[i];
+    out.sy[i] = r * from.sy[i] + weight * to.sy[i];
+    out.sz[i] = r * from.sz[i] + weight * to.sz[i];
+
+    float dot = from.qw[i] * to.qw[i] + from.qx[i] * to.qx[i] + from.qy[i] * to.qy[i] + from.qz[i] * to.qz[i];
+    float s = dot < 0.0f ? -weight : weight;
+    float w = r * from.qw[i] + s * to.qw[i];
+    float x = r * from.qx[i] + s * to.qx[i];
+    float y = r * from.qy[i] + s * to.qy[i];
+    float z = r * from.qz[i] + s * to.qz[i];
+    float inv = 1.0f / std::sqrt(w * w + x * x + y * y + z * z);
+    out.qw[i] = w * inv;
+    out.qx[i] = x * inv;
+    out.qy[i] = y * inv;
+    out.qz[i] = z * inv;
+}
+
+/**
+ * @brief Camada aditiva de um único bone; usada no fim dos arrays e sem SSE2.
+ */
+static inline void addBone(LocalPose &pose, const LocalPose &layer, float weight, size_t i)
+{
+    pose.tx[i] += weight * layer.tx[i];
+    pose.ty[i] += weight * layer.ty[i];
+    pose.tz[i] += weight * layer.tz[i];
+    pose.sx[i] *= 1.0f + weight * (layer.sx[i] - 1.0f);
+    pose.sy[i] *= 1.0f + weight * (layer.sy[i] - 1.0f);
+    pose.sz[i] *= 1.0f + weight * (layer.sz[i] - 1.0f);
+
+    // nlerp da identidade até a rotação da camada, no menor arco
+    float s = layer.qw[i] < 0.0f ? -weight : weight;
+    float bw = 1.0f - weight + s * layer.qw[i];
+    float bx = s * layer.qx[i], by = s * layer.qy[i], bz = s * layer.qz[i];
+    float inv = 1.0f / std::sqrt(bw * bw + bx * bx + by * by + bz * bz);
+    bw *= inv;
+    bx *= inv;
+    by *= inv;
+    bz *= inv;
+
+    float aw = pose.qw[i], ax = pose.qx[i], ay = pose.qy[i], az = pose.qz[i];
+    pose.qw[i] = aw * bw - ax * bx - ay * by - az * bz;
+    pose.qx[i] = aw * bx + ax * bw + ay * bz - az * by;
+    pose.qy[i] = aw * by - ax * bz + ay * bw + az * bx;
+    pose.qz[i] = aw * bz + ax * by - ay * bx + az * bw;
+}
+
+#ifdef LOCALPOSE_HAS_SSE2
+static inline __m128 lerp4(__m128 a, __m128 b, __m128 t)
+{
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+static inline __m128 madd4(__m128 a, __m128 b, __m128 c)
+{
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+}
+#endif
+
+void blendLocalPoses(const LocalPose &from, const LocalPose &to, float weight, LocalPose &out)
+{
+    size_t count = from.size();
+    if (out.size() != count)
+        out.setIdentity(count);
+    size_t i = 0;
+#ifdef LOCALPOSE_HAS_SSE2
+    const __m128 t = _mm_set1_ps(weight);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(&out.tx[i], lerp4(_mm_loadu_ps(&from.tx[i]), _mm_loadu_ps(&to.tx[i]), t));
+        _mm_storeu_ps(&out.ty[i], lerp4(_mm_loadu_ps(&from.ty[i]), _mm_loadu_ps(&to.ty[i]), t));
+        _mm_storeu_ps(&out.tz[i], lerp4(_mm_loadu_ps(&from.tz[i]), _mm_loadu_ps(&to.tz[i]), t));
+        _mm_storeu_ps(&out.sx[i], lerp4(_mm_loadu_ps(&from.sx[i]), _mm_loadu_ps(&to.sx[i]), t));
+        _mm_storeu_ps(&out.sy[i], lerp4(_mm_loadu_ps(&from.sy[i]), _mm_loadu_ps(&to.sy[i]), t));
+        _mm_storeu_ps(&out.sz[i], lerp4(_mm_loadu_ps(&from.sz[i]), _mm_loadu_ps(&to.sz[i]), t));
+
+        __m128 aw = _mm_loadu_ps(&from.qw[i]), ax = _mm_loadu_ps(&from.qx[i]);
+        __m128 ay = _mm_loadu_ps(&from.qy[i]), az = _mm_loadu_ps(&from.qz[i]);
+        __m128 bw = _mm_loadu_ps(&to.qw[i]), bx = _mm_loadu_ps(&to.qx[i]);
+        __m128 by = _mm_loadu_ps(&to.qy[i]), bz = _mm_loadu_ps(&to.qz[i]);
+
+        // Inverte o quaternion de destino quando o produto escalar é negativo (menor arco)
+        __m128 dot = madd4(aw, bw, madd4(ax, bx, madd4(ay, by, _mm_mul_ps(az, bz))));
+        __m128 sign = _mm_and_ps(dot, signMask);
+        __m128 w = lerp4(aw, _mm_xor_ps(bw, sign), t);
+        __m128 x = lerp4(ax, _mm_xor_ps(bx, sign), t);
+        __m128 y = lerp4(ay, _mm_xor_ps(by, sign), t);
+        __m128 z = lerp4(az, _mm_xor_ps(bz, sign), t);
+        __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(madd4(w, w, madd4(x, x, madd4(y, y, _mm_mul_ps(z, z))))));
+        _mm_storeu_ps(&out.qw[i], _mm_mul_ps(w, inv));
+        _mm_storeu_ps(&out.qx[i], _mm_mul_ps(x, inv));
+        _mm_storeu_ps(&out.qy[i], _mm_mul_ps(y, inv));
+        _mm_storeu_ps(&out.qz[i], _mm_mul_ps(z, inv));
+    }
+#endif
+    for (; i < count; i++)
+        blendBone(from, to, weight, out, i);
+}
+
+void addLocalPose(LocalPose &pose, const LocalPose &layer, float weight)
+{
+    size_t count = pose.size();
+    size_t i = 0;
+#ifdef LOCALPOSE_HAS_SSE2
+    const __m128 t = _mm_set1_ps(weight);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 rest = _mm_set1_ps(1.0f - weight);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(&pose.tx[i], madd4(t, _mm_loadu_ps(&layer.tx[i]), _mm_loadu_ps(&pose.tx[i])));
+        _mm_storeu_ps(&pose.ty[i], madd4(t, _mm_loadu_ps(&layer.ty[i]), _mm_loadu_ps(&pose.ty[i])));
+        _mm_storeu_ps(&pose.tz[i], madd4(t, _mm_loadu_ps(&layer.tz[i]), _mm_loadu_ps(&pose.tz[i])));
+        _mm_storeu_ps(&pose.sx[i], _mm_mul_ps(_mm_loadu_ps(&pose.sx[i]), lerp4(one, _mm_loadu_ps(&layer.sx[i]), t)));
+        _mm_storeu_ps(&pose.sy[i], _mm_mul_ps(_mm_loadu_ps(&pose.sy[i]), lerp4(one, _mm_loadu_ps(&layer.sy[i]), t)));
+        _mm_storeu_ps(&pose.sz[i], _mm_mul_ps(_mm_loadu_ps(&pose.sz[i]), lerp4(one, _mm_loadu_ps(&layer.sz[i]), t)));
+
+        // nlerp da identidade até a rotação da camada; o produto escalar com a identidade é a componente w
+        __m128 lw = _mm_loadu_ps(&layer.qw[i]);
+        __m128 s = _mm_xor_ps(t, _mm_and_ps(lw, signMask));
+        __m128 bw = madd4(s, lw, rest);
+        __m128 bx = _mm_mul_ps(s, _mm_loadu_ps(&layer.qx[i]));
+        __m128 by = _mm_mul_ps(s, _mm_loadu_ps(&layer.qy[i]));
+        __m128 bz = _mm_mul_ps(s, _mm_loadu_ps(&layer.qz[i]));
+        __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(madd4(bw, bw, madd4(bx, bx, madd4(by, by, _mm_mul_ps(bz, bz))))));
+        bw = _mm_mul_ps(bw, inv);
+        bx = _mm_mul_ps(bx, inv);
+        by = _mm_mul_ps(by, inv);
+        bz = _mm_mul_ps(bz, inv);
+
+        // Produto pose * camada: a rotação da camada é aplicada no espaço do bone
+        __m128 aw = _mm_loadu_ps(&pose.qw[i]), ax = _mm_loadu_ps(&pose.qx[i]);
+        __m128 ay = _mm_loadu_ps(&pose.qy[i]), az = _mm_loadu_ps(&pose.qz[i]);
+        __m128 w = _mm_sub_ps(_mm_mul_ps(aw, bw), madd4(ax, bx, madd4(ay, by, _mm_mul_ps(az, bz))));
+        __m128 x = _mm_sub_ps(madd4(aw, bx, madd4(ax, bw, _mm_mul_ps(ay, bz))), _mm_mul_ps(az, by));
+        __m128 y = _mm_sub_ps(madd4(aw, by, madd4(ay, bw, _mm_mul_ps(az, bx))), _mm_mul_ps(ax, bz));
+        __m128 z = _mm_sub_ps(madd4(aw, bz, madd4(ax, by, _mm_mul_ps(az, bw))), _mm_mul_ps(ay, bx));
+        _mm_storeu_ps(&pose.qw[i], w);
+        _mm_storeu_ps(&pose.qx[i], x);
+        _mm_storeu_ps(&pose.qy[i], y);
+        _mm_storeu_ps(&pose.qz[i], z);
+    }
+#endif
+    for (; i < count; i++)
+        addBone(pose, layer, weight, i);
+}
+
+void localPoseToTransforms(const LocalPose &pose, BoneInfo *bones)
+{
+    for (size_t i = 0; i < pose.size(); i++)
+    {
+        float w = pose.qw[i], x = pose.qx[i], y = pose.qy[i], z = pose.qz[i];
+        float xx = x * x * 2.0f, yy = y * y * 2.0f, zz = z * z * 2.0f;
+        float xy = x * y * 2.0f, xz = x * z * 2.0f, yz = y * z * 2.0f;
+        float wx = w * x * 2.0f, wy = w * y * 2.0f, wz = w * z * 2.0f;
+        float sx = pose.sx[i], sy = pose.sy[i], sz = pose.sz[i];
+
+        // Matriz de rotação com as colunas multiplicadas pela escala e a translação na última coluna
+        aiMatrix4x4 &m = bones[i].localTransform;
+        m.a1 = (1.0f - yy - zz) * sx;
+        m.a2 = (xy - wz) * sy;
+        m.a3 = (xz + wy) * sz;
+        m.a4 = pose.tx[i];
+        m.b1 = (xy + wz) * sx;
+        m.b2 = (1.0f - xx - zz) * sy;
+        m.b3 = (yz - wx) * sz;
+        m.b4 = pose.ty[i];
+        m.c1 = (xz - wy) * sx;
+        m.c2 = (yz + wx) * sy;
+        m.c3 = (1.0f - xx - yy) * sz;
+        m.c4 = pose.tz[i];
+        m.d1 = 0.0f;
+        m.d2 = 0.0f;
+        m.d3 = 0.0f;
+        m.d4 = 1.0f;
+    }
+}
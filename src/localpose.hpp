@@ -0,0 +1,105 @@
+#ifndef LOCALPOSE_HPP
+#define LOCALPOSE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <assimp/types.h>
+
+struct BoneInfo;
+
+/**
+ * @brief Pose local dos bones em estrutura de arrays (SoA): translação, rotação e escala.
+ *
+ * As operações de mistura percorrem os arrays de 4 em 4 bones com SSE2, e as matrizes locais só são
+ * montadas no fim da avaliação, por localPoseToTransforms().
+ */
+struct LocalPose
+{
+    std::vector<float> tx, ty, tz;     ///< Translação de cada bone, no espaço do pai.
+    std::vector<float> qw, qx, qy, qz; ///< Rotação de cada bone (quaternion unitário).
+    std::vector<float> sx, sy, sz;     ///< Escala de cada bone.
+
+    /**
+     * @brief Quantidade de bones da pose.
+     */
+    size_t size() const { return tx.size(); }
+
+    /**
+     * @brief Redimensiona a pose e coloca todos os bones na transformação identidade.
+     *
+     * Uma pose identidade é o valor neutro de uma camada aditiva.
+     */
+    void setIdentity(size_t count);
+
+    /**
+     * @brief Define a translação, a rotação e a escala de um bone.
+     */
+    void set(size_t bone, const aiVector3D &translation, const aiQuaternion &rotation, const aiVector3D &scale)
+    {
+        tx[bone] = translation.x;
+        ty[bone] = translation.y;
+        tz[bone] = translation.z;
+        setRotation(bone, rotation);
+        sx[bone] = scale.x;
+        sy[bone] = scale.y;
+        sz[bone] = scale.z;
+    }
+
+    /**
+     * @brief Define apenas a rotação de um bone.
+     */
+    void setRotation(size_t bone, const aiQuaternion &rotation)
+    {
+        qw[bone] = rotation.w;
+        qx[bone] = rotation.x;
+        qy[bone] = rotation.y;
+        qz[bone] = rotation.z;
+    }
+
+    /**
+     * @brief Retorna a rotação de um bone.
+     */
+    aiQuaternion rotation(size_t bone) const { return aiQuaternion(qw[bone], qx[bone], qy[bone], qz[bone]); }
+};
+
+/**
+ * @brief Decompõe a transformação local da bind pose de cada bone em translação, rotação e escala.
+ * @param bones Bones com defaultLocalTransform preenchida.
+ * @param count Quantidade de bones.
+ * @param pose Pose resultante.
+ */
+void bindLocalPose(const BoneInfo *bones, size_t count, LocalPose &pose);
+
+/**
+ * @brief Mistura duas poses (cross-fade): translações e escalas lineares, rotações por nlerp no menor arco.
+ *
+ * out pode ser a mesma pose que from ou to, e é redimensionada quando tem outro tamanho.
+ *
+ * @param from Pose com peso 1 - weight.
+ * @param to Pose com peso weight.
+ * @param weight Peso de to, entre 0 e 1.
+ * @param out Pose resultante.
+ */
+void blendLocalPoses(const LocalPose &from, const LocalPose &to, float weight, LocalPose &out);
+
+/**
+ * @brief Aplica uma camada aditiva sobre uma pose.
+ *
+ * A rotação da camada é composta no espaço do bone (pose * camada), como uma rotação manual aplicada
+ * após a transformação local; a translação é somada e a escala multiplicada. Com peso menor que 1, a
+ * camada é antes aproximada da identidade por nlerp.
+ *
+ * @param pose Pose atualizada.
+ * @param layer Diferença em relação à identidade (ver LocalPose::setIdentity()).
+ * @param weight Peso da camada, entre 0 e 1.
+ */
+void addLocalPose(LocalPose &pose, const LocalPose &layer, float weight);
+
+/**
+ * @brief Monta a matriz local (T * R * S) de cada bone a partir da pose.
+ * @param pose Pose avaliada.
+ * @param bones Bones cujo localTransform é substituído (pose.size() elementos).
+ */
+void localPoseToTransforms(const LocalPose &pose, BoneInfo *bones);
+
+#endif
@@ -2,17 +2,27 @@
 #include "stb_image.h"
 
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include "camera3d.hpp"
-#include "character3d.hpp"
+#include "characterinstance.hpp"
+#include "crowd.hpp"
+#include "impostor.hpp"
 #include "light.hpp"
 #include "background.hpp"
+#include "textureloader.hpp"
+#include "benchmark.hpp"
+#include "threadpool.hpp"
 
 Light lightning(1.0, 0.0, 16.0, LUZ_PONTUAL);
 Background background;
+Camera3D *sceneCamera = nullptr;
 bool exitFlag = false;
 
 void init()
@@ -22,16 +32,27 @@ void init()
     glClearColor(0.0, 0.0, 0.0, 1.0);
 }
 
-void display(GLFWwindow *window, const Camera3D &camera, const Character3D &character)
+void display(GLFWwindow *window, const Camera3D &camera, CharacterInstance &character, const Crowd &crowd)
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     camera.applyCamera();
     lightning.apply();
     background.draw();
-    character.draw();
+    if (crowd.size() > 0)
+        crowd.draw();
+    else
+        character.draw();
     glfwSwapBuffers(window);
 }
 
+void framebufferResized(GLFWwindow *window, int width, int height)
+{
+    // A câmera guarda a altura da viewport para a escolha do LOD, sem consultar o OpenGL a cada quadro
+    glViewport(0, 0, width, height);
+    if (sceneCamera)
+        sceneCamera->setViewportSize(width, height);
+}
+
 void keyboardEvents(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
     if(action == GLFW_PRESS || action == GLFW_REPEAT)
@@ -49,6 +70,32 @@ void keyboardEvents(GLFWwindow* window, int key, int scancode, int action, int m
         case GLFW_KEY_DOWN:
             lightning.setLessBrightness();
             break;
+
+        case GLFW_KEY_G:
+        {
+            // Alterna o skinning entre a CPU e o vertex shader
+            CharacterInstance *character = static_cast<CharacterInstance *>(glfwGetWindowUserPointer(window));
+            bool gpu = character->getSkinningMode() == SkinningMode::CPU;
+            if (character->setSkinningMode(gpu ? SkinningMode::GPU : SkinningMode::CPU))
+                std::cout << "Skinning na " << (gpu ? "GPU" : "CPU") << std::endl;
+            else
+                std::cerr << "Skinning na GPU não suportado" << std::endl;
+            break;
+        }
+
+        case GLFW_KEY_N:
+        {
+            // Troca para o próximo clip com cross-fade
+            CharacterInstance *character = static_cast<CharacterInstance *>(glfwGetWindowUserPointer(window));
+            int count = character->getAnimationCount();
+            if (count > 0)
+            {
+                int next = (character->getCurrentAnimation() + 1) % count;
+                character->playAnimation(next, true, 0.3f);
+                std::cout << "Animação " << next << std::endl;
+            }
+            break;
+        }
         
         default:
             break;
@@ -56,7 +103,7 @@ void keyboardEvents(GLFWwindow* window, int key, int scancode, int action, int m
     }
 }
 
-void rotateHeadToMouse(GLFWwindow *window, Character3D &character)
+void rotateHeadToMouse(GLFWwindow *window, CharacterInstance &character, BoneHandle head)
 {
     // Captura a posição atual do mouse na janela
     double mouseX, mouseY;
@@ -86,11 +133,45 @@ void rotateHeadToMouse(GLFWwindow *window, Character3D &character)
     glm::quat combinedRotation = rotationYQuat * rotationXQuat;
 
     // Aplica a rotação ao bone "Head"
-    character.rotateBone("Head", combinedRotation);
+    character.rotateBone(head, combinedRotation);
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    // Uso: ./program [--threads <n>] [--gpu-skinning] [--quantized] [--backface-culling] [--animation <índice>]
+    //                [--crowd <n>] [--impostors] [--occlusion] [--bench <nome>]
+    std::string benchmarkName;
+    int animationIndex = -1;
+    size_t crowdCount = 0;
+    bool impostors = false;
+    bool occlusion = false;
+    unsigned int threadCount = 0;
+    bool gpuSkinning = false;
+    VertexFormat vertexFormat = VertexFormat::Float;
+    bool backfaceCulling = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--bench" && i + 1 < argc)
+            benchmarkName = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc)
+            threadCount = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--gpu-skinning")
+            gpuSkinning = true;
+        else if (arg == "--quantized")
+            vertexFormat = VertexFormat::Quantized;
+        else if (arg == "--backface-culling")
+            backfaceCulling = true;
+        else if (arg == "--animation" && i + 1 < argc)
+            animationIndex = std::atoi(argv[++i]);
+        else if (arg == "--crowd" && i + 1 < argc)
+            crowdCount = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--impostors")
+            impostors = true;
+        else if (arg == "--occlusion")
+            occlusion = true;
+    }
+
     if (!glfwInit())
     {
         std::cerr << "Falha ao inicializar GLFW" << std::endl;
@@ -106,32 +187,130 @@ int main()
     }
 
     glfwMakeContextCurrent(window);
+
+    // Carrega as funções OpenGL modernas (buffers, VAOs, fences)
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+        std::cerr << "Falha ao inicializar GLEW" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
     glfwSetKeyCallback(window, keyboardEvents);
 
+    const char *modelPath = "Mita/Mita (orig).fbx";
     Camera3D camera(0.0, -9.0, 16.0, 90.0, 0.0, 0.0, 50.0, 36.0, 800.0 / 600.0, 0.1, 1000.0);
-    Character3D character;
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    camera.setViewportSize(framebufferWidth, framebufferHeight);
+    sceneCamera = &camera;
+    glfwSetFramebufferSizeCallback(window, framebufferResized);
+    std::shared_ptr<SkinnedMeshAsset> asset = std::make_shared<SkinnedMeshAsset>();
+    CharacterInstance character;
+    ThreadPool threadPool(threadCount);
+    character.setThreadPool(&threadPool);
+    character.setCamera(&camera);
+    character.setBackfaceCulling(backfaceCulling);
+    std::cout << "Skinning com " << threadPool.size() << " thread(s)" << std::endl;
 
-    if (!character.loadModel("Mita/Mita (orig).fbx", "Mita"))
     {
-        return -1;
+        // Todas as texturas são decodificadas em paralelo e enviadas ao OpenGL conforme ficam prontas
+        TextureLoader textureLoader;
+
+        if (!asset->load(modelPath, "Mita", textureLoader, vertexFormat) || !character.setAsset(asset))
+        {
+            return -1;
+        }
+
+        background.loadTexture("assets/fundo.png", textureLoader);
+        textureLoader.finish();
+
+        if(!background.isLoaded(textureLoader))
+        {
+            return -1;
+        }
+    }
+
+    glfwSetWindowUserPointer(window, &character);
+    if (gpuSkinning && !character.setSkinningMode(SkinningMode::GPU))
+        std::cerr << "Skinning na GPU não suportado, usando a CPU" << std::endl;
+    if (animationIndex >= 0 && !character.playAnimation(animationIndex))
+        std::cerr << "Animação " << animationIndex << " não encontrada (o modelo possui "
+                  << character.getAnimationCount() << ")" << std::endl;
+
+    // A multidão usa o mesmo asset do personagem: malha, texturas e clips compartilhados. O atlas de
+    // impostores é declarado antes para continuar válido enquanto a multidão o referencia
+    ImpostorAtlas impostorAtlas;
+    Crowd crowd;
+    crowd.setThreadPool(&threadPool);
+    crowd.setCamera(&camera);
+    if (crowdCount > 0 && !crowd.create(asset, crowdCount))
+        std::cerr << "Multidão indisponível, desenhando um único personagem" << std::endl;
+    if (impostors && crowd.size() > 0)
+    {
+        if (impostorAtlas.bake(asset))
+            crowd.setImpostors(&impostorAtlas);
+        else
+            std::cerr << "Impostores indisponíveis, desenhando todas as instâncias com a malha" << std::endl;
+    }
+
+    // O plano do fundo é o oclusor fixo; as instâncias mais próximas são acrescentadas a cada quadro
+    if (occlusion && crowd.size() > 0)
+    {
+        glm::vec3 corners[4];
+        background.getCorners(corners);
+        crowd.addStaticOccluder(std::vector<glm::vec3>(corners, corners + 4), {0, 1, 2, 0, 2, 3});
+        crowd.setOcclusionCulling(true);
     }
 
     init();
 
-    if(!background.loadTexture("assets/fundo.png"))
+    if (!benchmarkName.empty())
     {
-        return -1;
+        BenchmarkContext context{window, &camera, &character, &background, &threadPool, modelPath};
+        int result = runBenchmark(benchmarkName, context);
+        crowd.destroy();
+        impostorAtlas.destroy();
+        character.destroy();
+        asset.reset();
+        glfwTerminate();
+        return result;
     }
 
+    // O bone da cabeça é resolvido uma única vez, sem busca por nome a cada quadro
+    BoneHandle head = character.findBone("Head");
+    if (!head.isValid())
+        std::cerr << "Bone Head não encontrado!" << std::endl;
+
+    double previousTime = glfwGetTime();
     while(!glfwWindowShouldClose(window) && !exitFlag)
     {
-        // Chama a função para rotacionar o bone "Head" para olhar para o mouse
-        rotateHeadToMouse(window, character);
+        // Avança a animação pelo tempo real decorrido desde o quadro anterior
+        double currentTime = glfwGetTime();
+        float deltaTime = static_cast<float>(currentTime - previousTime);
+        previousTime = currentTime;
+        if (crowd.size() > 0)
+            crowd.update(deltaTime);
+        else
+        {
+            character.updateAnimation(deltaTime);
+
+            // Chama a função para rotacionar o bone "Head" para olhar para o mouse
+            rotateHeadToMouse(window, character, head);
+
+            // Avalia a pose e faz o skinning na CPU antes do desenho, que só envia o resultado
+            character.update();
+        }
 
-        display(window, camera, character);
+        display(window, camera, character, crowd);
         glfwPollEvents();
     }
 
+    // Os buffers do personagem e do asset são liberados enquanto o contexto ainda existe
+    crowd.destroy();
+    impostorAtlas.destroy();
+    character.destroy();
+    asset.reset();
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,451 @@
+#include "meshcache.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Versão do formato do cache. Deve ser incrementada sempre que o layout gravado mudar.
+static const uint32_t MESH_CACHE_VERSION = 9;
+static const char MESH_CACHE_MAGIC[8] = {'M', 'I', 'T', 'A', 'M', 'S', 'H', '\0'};
+
+static_assert(std::is_trivially_copyable<Vertex>::value, "Vertex precisa ser copiável byte a byte");
+static_assert(std::is_trivially_copyable<aiMatrix4x4>::value, "aiMatrix4x4 precisa ser copiável byte a byte");
+static_assert(std::is_trivially_copyable<CompressedAnimationTrack>::value,
+              "CompressedAnimationTrack precisa ser copiável byte a byte");
+
+struct MeshCacheHeader
+{
+    char magic[8];        ///< Identificador do formato.
+    uint32_t version;     ///< Versão do formato do cache.
+    uint32_t vertexSize;  ///< sizeof(Vertex) no momento da gravação.
+    uint64_t sourceSize;  ///< Tamanho do modelo original em bytes.
+    int64_t sourceMTime;  ///< Data de modificação do modelo original.
+    uint64_t payloadSize; ///< Tamanho dos dados após o cabeçalho.
+    uint64_t checksum;    ///< Checksum FNV-1a 64 bits dos dados.
+};
+
+/**
+ * @brief Calcula o checksum FNV-1a de 64 bits de um bloco de memória.
+ */
+static uint64_t fnv1a64(const unsigned char *data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Obtém o tamanho e a data de modificação do modelo original.
+ */
+static bool sourceStamp(const std::string &sourcePath, uint64_t &size, int64_t &mtime)
+{
+    std::error_code ec;
+    size = std::filesystem::file_size(sourcePath, ec);
+    if (ec)
+        return false;
+    mtime = std::filesystem::last_write_time(sourcePath, ec).time_since_epoch().count();
+    return !ec;
+}
+
+/**
+ * @brief Mapeia um arquivo somente leitura em memória, liberando o mapeamento ao sair de escopo.
+ */
+class MappedFile
+{
+private:
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::string &path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+            return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+            return;
+        data = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data)
+            size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED)
+            {
+                data = static_cast<const unsigned char *>(ptr);
+                size = st.st_size;
+            }
+        }
+        // O mapeamento continua válido após fechar o descritor
+        close(fd);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+#else
+        if (data)
+            munmap(const_cast<unsigned char *>(data), size);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const unsigned char *bytes() const { return data; }
+    size_t length() const { return size; }
+};
+
+/**
+ * @brief Acumula os dados do cache em um buffer contínuo.
+ */
+class CacheWriter
+{
+public:
+    std::vector<unsigned char> buffer;
+
+    void write(const void *src, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(src);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void write(const T &value) { write(&value, sizeof(T)); }
+
+    void writeString(const std::string &str)
+    {
+        write(static_cast<uint32_t>(str.size()));
+        write(str.data(), str.size());
+    }
+};
+
+/**
+ * @brief Lê os dados do cache diretamente da memória mapeada, verificando os limites a cada leitura.
+ */
+class CacheReader
+{
+private:
+    const unsigned char *cursor;
+    const unsigned char *end;
+
+public:
+    CacheReader(const unsigned char *data, size_t size) : cursor(data), end(data + size) {}
+
+    bool read(void *dst, size_t size)
+    {
+        if (static_cast<size_t>(end - cursor) < size)
+            return false;
+        std::memcpy(dst, cursor, size);
+        cursor += size;
+        return true;
+    }
+
+    template <typename T>
+    bool read(T &value) { return read(&value, sizeof(T)); }
+
+    bool readString(std::string &str)
+    {
+        uint32_t length;
+        if (!read(length) || static_cast<size_t>(end - cursor) < length)
+            return false;
+        str.assign(reinterpret_cast<const char *>(cursor), length);
+        cursor += length;
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T> &values, uint32_t count)
+    {
+        if (static_cast<size_t>(end - cursor) / sizeof(T) < count)
+            return false;
+        values.resize(count);
+        return read(values.data(), count * sizeof(T));
+    }
+
+    bool finished() const { return cursor == end; }
+};
+
+/**
+ * @brief Lê as chaves compactadas de um tipo de canal: um tempo e 3 uint16 por chave.
+ */
+static bool readKeys(CacheReader &reader, std::vector<float> &times, std::vector<uint16_t> &values)
+{
+    uint32_t count;
+    return reader.read(count) && count <= UINT32_MAX / 3 && reader.readArray(times, count) &&
+           reader.readArray(values, count * 3);
+}
+
+/**
+ * @brief Grava as chaves compactadas de um tipo de canal no formato lido por readKeys().
+ */
+static void writeKeys(CacheWriter &writer, const std::vector<float> &times, const std::vector<uint16_t> &values)
+{
+    writer.write(static_cast<uint32_t>(times.size()));
+    writer.write(times.data(), times.size() * sizeof(float));
+    writer.write(values.data(), values.size() * sizeof(uint16_t));
+}
+
+/**
+ * @brief Informa se o intervalo de chaves de um canal cabe no array do clip.
+ */
+static bool validKeyRange(const KeyRange &range, size_t keyCount)
+{
+    return range.offset <= keyCount && range.count <= keyCount - range.offset;
+}
+
+std::string meshCachePath(const std::string &sourcePath)
+{
+    return sourcePath + ".meshcache";
+}
+
+bool loadMeshCache(const std::string &cachePath, const std::string &sourcePath,
+                   std::vector<SubMesh> &submeshes, BoneNameTable &boneNames,
+                   std::vector<BoneInfo> &boneInfo, std::vector<CompressedAnimationClip> &animations)
+{
+    uint64_t sourceSize;
+    int64_t sourceMTime;
+    if (!sourceStamp(sourcePath, sourceSize, sourceMTime))
+        return false;
+
+    MappedFile file(cachePath);
+    if (!file.bytes() || file.length() < sizeof(MeshCacheHeader))
+        return false;
+
+    // Valida o cabeçalho antes de tocar nos dados
+    MeshCacheHeader header;
+    std::memcpy(&header, file.bytes(), sizeof(header));
+    if (std::memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != MESH_CACHE_VERSION || header.vertexSize != sizeof(Vertex))
+    {
+        std::cout << "Cache de malha em formato antigo, reimportando: " << cachePath << std::endl;
+        return false;
+    }
+    if (header.sourceSize != sourceSize || header.sourceMTime != sourceMTime)
+    {
+        std::cout << "Modelo alterado desde o último cache, reimportando: " << sourcePath << std::endl;
+        return false;
+    }
+
+    const unsigned char *payload = file.bytes() + sizeof(header);
+    if (header.payloadSize != file.length() - sizeof(header) || fnv1a64(payload, header.payloadSize) != header.checksum)
+    {
+        std::cerr << "Cache de malha corrompido: " << cachePath << std::endl;
+        return false;
+    }
+
+    // Converte os dados mapeados diretamente em SubMesh/BoneInfo
+    CacheReader reader(payload, header.payloadSize);
+    uint32_t submeshCount, boneCount;
+    if (!reader.read(submeshCount) || !reader.read(boneCount))
+        return false;
+
+    std::vector<SubMesh> loadedSubmeshes(submeshCount);
+    for (auto &sub : loadedSubmeshes)
+    {
+        uint32_t vertexCount, index16Count, index32Count, lodCount;
+        sub.textureID = 0;
+        sub.baseVertex = 0;
+        sub.indexByteOffset = 0;
+        if (!reader.readString(sub.texturePath) || !reader.read(vertexCount) || !reader.readArray(sub.vertices, vertexCount) ||
+            !reader.read(index16Count) || !reader.readArray(sub.indices16, index16Count) ||
+            !reader.read(index32Count) || !reader.readArray(sub.indices32, index32Count) ||
+            !reader.read(lodCount) || !reader.readArray(sub.lodOffsets, lodCount))
+            return false;
+
+        // Os LODs precisam estar em ordem e dentro dos índices
+        size_t previousOffset = 0;
+        for (uint32_t offset : sub.lodOffsets)
+        {
+            if (offset < previousOffset || offset > sub.indexCount() || offset % 3 != 0)
+                return false;
+            previousOffset = offset;
+        }
+
+        // Índices e bones fora do intervalo passariam pelo checksum e seriam lidos fora dos arrays no skinning
+        // e no desenho. Influências sem peso têm o bone 0 e não são usadas
+        for (const Vertex &vert : sub.vertices)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                if (vert.boneIDs[k] < 0 || (vert.weights[k] != 0.0f && static_cast<uint32_t>(vert.boneIDs[k]) >= boneCount))
+                    return false;
+            }
+        }
+        for (uint16_t index : sub.indices16)
+        {
+            if (index >= vertexCount)
+                return false;
+        }
+        for (uint32_t index : sub.indices32)
+        {
+            if (index >= vertexCount)
+                return false;
+        }
+    }
+
+    BoneNameTable loadedNames;
+    std::vector<BoneInfo> loadedBones(boneCount);
+    for (uint32_t i = 0; i < boneCount; i++)
+    {
+        std::string name;
+        BoneInfo &info = loadedBones[i];
+        int32_t parentIndex;
+        if (!reader.readString(name) || !reader.read(info.offsetMatrix) ||
+            !reader.read(info.defaultLocalTransform) || !reader.read(parentIndex))
+            return false;
+        info.localTransform = info.defaultLocalTransform;
+        info.finalTransformation = aiMatrix4x4();
+        info.parentIndex = parentIndex;
+        if (parentIndex < -1 || parentIndex >= static_cast<int32_t>(boneCount))
+            return false;
+
+        // Nomes repetidos indicariam um cache inconsistente
+        if (loadedNames.insert(name) != static_cast<int>(i))
+            return false;
+    }
+
+    uint32_t animationCount;
+    if (!reader.read(animationCount))
+        return false;
+    std::vector<CompressedAnimationClip> loadedAnimations(animationCount);
+    for (auto &clip : loadedAnimations)
+    {
+        uint32_t trackCount;
+        if (!reader.readString(clip.name) || !reader.read(clip.duration) || !reader.read(trackCount) ||
+            !reader.readArray(clip.tracks, trackCount) || !readKeys(reader, clip.positionTimes, clip.positionKeys) ||
+            !readKeys(reader, clip.rotationTimes, clip.rotationKeys) || !readKeys(reader, clip.scaleTimes, clip.scaleKeys))
+            return false;
+
+        // Os canais precisam apontar para bones existentes e para chaves dentro dos arrays
+        for (const CompressedAnimationTrack &track : clip.tracks)
+        {
+            if (track.bone < 0 || static_cast<uint32_t>(track.bone) >= boneCount ||
+                !validKeyRange(track.position, clip.positionTimes.size()) ||
+                !validKeyRange(track.rotation, clip.rotationTimes.size()) ||
+                !validKeyRange(track.scale, clip.scaleTimes.size()))
+                return false;
+        }
+    }
+    if (!reader.finished())
+        return false;
+
+    submeshes = std::move(loadedSubmeshes);
+    boneNames = std::move(loadedNames);
+    boneInfo = std::move(loadedBones);
+    animations = std::move(loadedAnimations);
+    return true;
+}
+
+bool saveMeshCache(const std::string &cachePath, const std::string &sourcePath,
+                   const std::vector<SubMesh> &submeshes, const BoneNameTable &boneNames,
+                   const std::vector<BoneInfo> &boneInfo, const std::vector<CompressedAnimationClip> &animations)
+{
+    MeshCacheHeader header;
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    if (!sourceStamp(sourcePath, header.sourceSize, header.sourceMTime))
+        return false;
+
+    CacheWriter writer;
+    writer.write(static_cast<uint32_t>(submeshes.size()));
+    writer.write(static_cast<uint32_t>(boneInfo.size()));
+    for (const auto &sub : submeshes)
+    {
+        writer.writeString(sub.texturePath);
+        writer.write(static_cast<uint32_t>(sub.vertices.size()));
+        writer.write(sub.vertices.data(), sub.vertices.size() * sizeof(Vertex));
+        writer.write(static_cast<uint32_t>(sub.indices16.size()));
+        writer.write(sub.indices16.data(), sub.indices16.size() * sizeof(uint16_t));
+        writer.write(static_cast<uint32_t>(sub.indices32.size()));
+        writer.write(sub.indices32.data(), sub.indices32.size() * sizeof(uint32_t));
+        writer.write(static_cast<uint32_t>(sub.lodOffsets.size()));
+        writer.write(sub.lodOffsets.data(), sub.lodOffsets.size() * sizeof(uint32_t));
+    }
+    for (size_t i = 0; i < boneInfo.size(); i++)
+    {
+        writer.writeString(boneNames.name(i));
+        writer.write(boneInfo[i].offsetMatrix);
+        writer.write(boneInfo[i].defaultLocalTransform);
+        writer.write(static_cast<int32_t>(boneInfo[i].parentIndex));
+    }
+    writer.write(static_cast<uint32_t>(animations.size()));
+    for (const auto &clip : animations)
+    {
+        writer.writeString(clip.name);
+        writer.write(clip.duration);
+        writer.write(static_cast<uint32_t>(clip.tracks.size()));
+        writer.write(clip.tracks.data(), clip.tracks.size() * sizeof(CompressedAnimationTrack));
+        writeKeys(writer, clip.positionTimes, clip.positionKeys);
+        writeKeys(writer, clip.rotationTimes, clip.rotationKeys);
+        writeKeys(writer, clip.scaleTimes, clip.scaleKeys);
+    }
+
+    header.payloadSize = writer.buffer.size();
+    header.checksum = fnv1a64(writer.buffer.data(), writer.buffer.size());
+
+    // Grava em um arquivo temporário e renomeia, para nunca deixar um cache pela metade
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "Erro ao criar cache de malha: " << cachePath << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(writer.buffer.data()), writer.buffer.size());
+        if (!out)
+        {
+            std::cerr << "Erro ao gravar cache de malha: " << cachePath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec)
+    {
+        std::cerr << "Erro ao gravar cache de malha: " << cachePath << std::endl;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef MESHCACHE_HPP
+#define MESHCACHE_HPP
+
+#include <vector>
+#include <string>
+#include "skinnedmeshasset.hpp"
+#include "animation.hpp"
+
+/**
+ * @brief Retorna o caminho do cache binário associado a um modelo.
+ * @param sourcePath Caminho do modelo original (ex.: arquivo FBX).
+ * @return Caminho do arquivo de cache, gravado ao lado do modelo original.
+ */
+std::string meshCachePath(const std::string &sourcePath);
+
+/**
+ * @brief Carrega os dados do modelo a partir do cache binário, mapeando o arquivo em memória.
+ *
+ * O cache só é aceito se a versão do formato, o layout do Vertex, o tamanho e a data de modificação
+ * do modelo original e o checksum dos dados conferirem. Caso contrário nada é alterado.
+ *
+ * @param cachePath Caminho do arquivo de cache.
+ * @param sourcePath Caminho do modelo original usado para validar o cache.
+ * @param submeshes Submeshes carregados do cache.
+ * @param boneNames Nome de cada bone, pelo índice.
+ * @param boneInfo Informações de cada bone.
+ * @param animations Clips de animação compactados, com os canais já associados aos bones.
+ * @return true se o cache for válido e tiver sido carregado, false caso contrário.
+ */
+bool loadMeshCache(const std::string &cachePath, const std::string &sourcePath,
+                   std::vector<SubMesh> &submeshes, BoneNameTable &boneNames,
+                   std::vector<BoneInfo> &boneInfo, std::vector<CompressedAnimationClip> &animations);
+
+/**
+ * @brief Grava os dados do modelo já importado em um cache binário versionado.
+ * @param cachePath Caminho do arquivo de cache.
+ * @param sourcePath Caminho do modelo original, cujo tamanho e data de modificação são registrados.
+ * @param submeshes Submeshes a serem gravados.
+ * @param boneNames Nome de cada bone, pelo índice.
+ * @param boneInfo Informações de cada bone.
+ * @param animations Clips de animação compactados.
+ * @return true se o cache for gravado com sucesso, false caso contrário.
+ */
+bool saveMeshCache(const std::string &cachePath, const std::string &sourcePath,
+                   const std::vector<SubMesh> &submeshes, const BoneNameTable &boneNames,
+                   const std::vector<BoneInfo> &boneInfo, const std::vector<CompressedAnimationClip> &animations);
+
+#endif
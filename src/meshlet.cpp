@@ -0,0 +1,126 @@
+#include "meshlet.hpp"
+#include <algorithm>
+#include <cmath>
+
+void buildMeshlets(const std::vector<uint32_t> &indices, size_t begin, size_t end, uint32_t baseVertex,
+                   size_t vertexCount, std::vector<Meshlet> &meshlets, std::vector<uint32_t> &meshletVertices,
+                   std::vector<uint8_t> &meshletTriangles)
+{
+    // Índice local de cada vértice no meshlet atual (-1 se ainda não faz parte dele)
+    std::vector<int> local(vertexCount, -1);
+    auto startMeshlet = [&](size_t indexOffset)
+    {
+        return Meshlet{static_cast<uint32_t>(indexOffset), 0, static_cast<uint32_t>(meshletVertices.size()), 0,
+                       static_cast<uint32_t>(meshletTriangles.size())};
+    };
+    auto finishMeshlet = [&](const Meshlet &meshlet)
+    {
+        for (size_t v = meshlet.vertexOffset; v < meshletVertices.size(); v++)
+            local[meshletVertices[v] - baseVertex] = -1;
+        meshlets.push_back(meshlet);
+    };
+
+    Meshlet current = startMeshlet(begin);
+    for (size_t i = begin; i + 2 < end; i += 3)
+    {
+        const uint32_t *triangle = &indices[i];
+        size_t newVertices = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            bool repeated = (k > 0 && triangle[k] == triangle[0]) || (k > 1 && triangle[k] == triangle[1]);
+            if (local[triangle[k]] < 0 && !repeated)
+                newVertices++;
+        }
+        if (current.vertexCount + newVertices > MESHLET_MAX_VERTICES || current.triangleCount == MESHLET_MAX_TRIANGLES)
+        {
+            finishMeshlet(current);
+            current = startMeshlet(i);
+        }
+
+        for (int k = 0; k < 3; k++)
+        {
+            if (local[triangle[k]] < 0)
+            {
+                local[triangle[k]] = current.vertexCount++;
+                meshletVertices.push_back(baseVertex + triangle[k]);
+            }
+            meshletTriangles.push_back(static_cast<uint8_t>(local[triangle[k]]));
+        }
+        current.triangleCount++;
+    }
+    if (current.triangleCount > 0)
+        finishMeshlet(current);
+}
+
+void computeMeshletBounds(const Meshlet &meshlet, const uint32_t *meshletVertices, const uint8_t *meshletTriangles,
+                          const float *positions, MeshletBounds &bounds)
+{
+    // Esfera centrada na AABB dos vértices
+    const uint32_t *vertices = meshletVertices + meshlet.vertexOffset;
+    glm::vec3 minimum(positions[vertices[0] * 3], positions[vertices[0] * 3 + 1], positions[vertices[0] * 3 + 2]);
+    glm::vec3 maximum = minimum;
+    for (uint32_t v = 1; v < meshlet.vertexCount; v++)
+    {
+        const float *p = &positions[vertices[v] * 3];
+        minimum = glm::min(minimum, glm::vec3(p[0], p[1], p[2]));
+        maximum = glm::max(maximum, glm::vec3(p[0], p[1], p[2]));
+    }
+    bounds.center = (minimum + maximum) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+    {
+        const float *p = &positions[vertices[v] * 3];
+        glm::vec3 offset = glm::vec3(p[0], p[1], p[2]) - bounds.center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    bounds.radius = std::sqrt(radiusSquared);
+
+    // Cone de normais: eixo na média das normais unitárias, abertura até a normal mais afastada
+    const uint8_t *triangles = meshletTriangles + meshlet.triangleOffset;
+    glm::vec3 normals[MESHLET_MAX_TRIANGLES];
+    size_t normalCount = 0;
+    glm::vec3 axis(0.0f);
+    for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+    {
+        const float *a = &positions[vertices[triangles[t * 3]] * 3];
+        const float *b = &positions[vertices[triangles[t * 3 + 1]] * 3];
+        const float *c = &positions[vertices[triangles[t * 3 + 2]] * 3];
+        glm::vec3 normal = glm::cross(glm::vec3(b[0] - a[0], b[1] - a[1], b[2] - a[2]),
+                                      glm::vec3(c[0] - a[0], c[1] - a[1], c[2] - a[2]));
+        float length = glm::length(normal);
+        if (length == 0.0f)
+            continue;
+        normals[normalCount] = normal / length;
+        axis += normals[normalCount++];
+    }
+
+    float axisLength = glm::length(axis);
+    bounds.coneAxis = axisLength > 0.0f ? axis / axisLength : glm::vec3(0.0f, 0.0f, 1.0f);
+    bounds.coneCutoff = axisLength > 0.0f ? 1.0f : -1.0f;
+    for (size_t n = 0; n < normalCount; n++)
+        bounds.coneCutoff = std::min(bounds.coneCutoff, glm::dot(bounds.coneAxis, normals[n]));
+}
+
+bool isMeshletVisible(const MeshletBounds &bounds, const MeshletCullingView &view)
+{
+    for (const glm::vec4 &plane : view.planes)
+    {
+        float distance = plane.x * bounds.center.x + plane.y * bounds.center.y + plane.z * bounds.center.z + plane.w;
+        if (distance < -bounds.radius)
+            return false;
+    }
+    if (!view.backfaces || bounds.coneCutoff <= 0.0f)
+        return true;
+
+    // Com o eixo a um ângulo phi da direção de visão e o cone com semiângulo theta, a normal mais voltada
+    // para a câmera forma phi + theta com essa direção. Todos os triângulos estão de costas se, mesmo para
+    // ela, a distância projetada supera o raio da esfera
+    glm::vec3 toCenter = bounds.center - view.eye;
+    float distance = glm::length(toCenter);
+    if (distance <= bounds.radius)
+        return true;
+    float cosPhi = glm::dot(bounds.coneAxis, toCenter) / distance;
+    float sinPhi = std::sqrt(std::max(0.0f, 1.0f - cosPhi * cosPhi));
+    float sinTheta = std::sqrt(std::max(0.0f, 1.0f - bounds.coneCutoff * bounds.coneCutoff));
+    return distance * (cosPhi * bounds.coneCutoff - sinPhi * sinTheta) <= bounds.radius;
+}
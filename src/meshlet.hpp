@@ -0,0 +1,99 @@
+#ifndef MESHLET_HPP
+#define MESHLET_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Quantidade máxima de vértices únicos em um meshlet (índices locais cabem em um byte).
+ */
+const size_t MESHLET_MAX_VERTICES = 64;
+
+/**
+ * @brief Quantidade máxima de triângulos em um meshlet.
+ */
+const size_t MESHLET_MAX_TRIANGLES = 124;
+
+/**
+ * @brief Quantidade máxima de meshlets em cada tarefa de recálculo dos limites.
+ */
+const size_t MESHLET_REFIT_TASK_SIZE = 256;
+
+/**
+ * @brief Grupo de triângulos consecutivos nos índices de um submesh, descartado como uma unidade.
+ *
+ * Os triângulos continuam desenhados a partir do buffer de índices do submesh; a lista de vértices e os
+ * triângulos com índices locais servem apenas para recalcular os limites do meshlet.
+ */
+struct Meshlet
+{
+    uint32_t indexOffset;    ///< Primeiro índice do meshlet nos índices do submesh.
+    uint32_t triangleCount;  ///< Quantidade de triângulos (até MESHLET_MAX_TRIANGLES).
+    uint32_t vertexOffset;   ///< Primeiro vértice do meshlet na lista de vértices dos meshlets.
+    uint32_t vertexCount;    ///< Quantidade de vértices únicos (até MESHLET_MAX_VERTICES).
+    uint32_t triangleOffset; ///< Primeiro índice local do meshlet na lista de triângulos dos meshlets.
+};
+
+/**
+ * @brief Limites de um meshlet na pose atual.
+ */
+struct MeshletBounds
+{
+    glm::vec3 center;   ///< Centro da esfera envolvente.
+    float radius;       ///< Raio da esfera envolvente.
+    glm::vec3 coneAxis; ///< Eixo do cone que contém as normais dos triângulos.
+    float coneCutoff;   ///< Cosseno do semiângulo do cone; sem valor positivo, o meshlet nunca está de costas.
+};
+
+/**
+ * @brief Dados da câmera usados para descartar meshlets.
+ */
+struct MeshletCullingView
+{
+    glm::vec4 planes[6]; ///< Planos do frustum, com as normais apontando para dentro.
+    glm::vec3 eye;       ///< Posição da câmera.
+    bool backfaces;      ///< Descarta também os meshlets inteiramente de costas para a câmera.
+};
+
+/**
+ * @brief Divide um intervalo de triângulos em meshlets, mantendo a ordem dos triângulos.
+ *
+ * Os triângulos são percorridos em ordem e um novo meshlet começa quando o atual excederia
+ * MESHLET_MAX_VERTICES vértices ou MESHLET_MAX_TRIANGLES triângulos. Com os índices já otimizados para
+ * a cache de vértices, triângulos consecutivos são vizinhos e os meshlets ficam compactos.
+ *
+ * @param indices Índices do submesh em 32 bits.
+ * @param begin Primeiro índice do intervalo (múltiplo de 3).
+ * @param end Índice seguinte ao último do intervalo.
+ * @param baseVertex Somado aos índices ao gravar a lista de vértices (numeração global das posições).
+ * @param vertexCount Quantidade de vértices do submesh.
+ * @param meshlets Meshlets gerados, acrescentados ao fim.
+ * @param meshletVertices Vértices de cada meshlet, acrescentados ao fim.
+ * @param meshletTriangles Triângulos de cada meshlet em índices locais, acrescentados ao fim.
+ */
+void buildMeshlets(const std::vector<uint32_t> &indices, size_t begin, size_t end, uint32_t baseVertex,
+                   size_t vertexCount, std::vector<Meshlet> &meshlets, std::vector<uint32_t> &meshletVertices,
+                   std::vector<uint8_t> &meshletTriangles);
+
+/**
+ * @brief Recalcula a esfera envolvente e o cone de normais de um meshlet a partir das posições atuais.
+ * @param meshlet Meshlet.
+ * @param meshletVertices Lista de vértices dos meshlets.
+ * @param meshletTriangles Lista de triângulos dos meshlets.
+ * @param positions Posições de todos os vértices (x, y, z por vértice), na numeração de meshletVertices.
+ * @param bounds Limites resultantes.
+ */
+void computeMeshletBounds(const Meshlet &meshlet, const uint32_t *meshletVertices, const uint8_t *meshletTriangles,
+                          const float *positions, MeshletBounds &bounds);
+
+/**
+ * @brief Informa se algum triângulo do meshlet pode estar visível.
+ *
+ * O meshlet é descartado se a esfera estiver fora de algum plano do frustum ou, com view.backfaces, se
+ * todas as normais do cone estiverem de costas para qualquer ponto da esfera vista da câmera.
+ */
+bool isMeshletVisible(const MeshletBounds &bounds, const MeshletCullingView &view);
+
+#endif
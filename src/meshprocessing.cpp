@@ -0,0 +1,620 @@
+#include "meshprocessing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+    /**
+     * @brief Hash FNV-1a sobre os bytes do vértice.
+     */
+    struct VertexHash
+    {
+        size_t operator()(const Vertex &vert) const
+        {
+            const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&vert);
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < sizeof(Vertex); i++)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    /**
+     * @brief Compara dois vértices byte a byte.
+     */
+    struct VertexEqual
+    {
+        bool operator()(const Vertex &a, const Vertex &b) const
+        {
+            return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+        }
+    };
+
+    /**
+     * @brief Tamanho da cache LRU simulada pelo algoritmo de Forsyth.
+     */
+    const int FORSYTH_CACHE_SIZE = 32;
+
+    /**
+     * @brief Maior quantidade de triângulos restantes com pontuação própria; acima disso o bônus é o mesmo.
+     */
+    const int FORSYTH_MAX_VALENCE = 32;
+
+    /**
+     * @brief Tabelas de pontuação de Forsyth, indexadas pela posição na cache e pelos triângulos restantes.
+     */
+    struct ForsythScores
+    {
+        float cache[FORSYTH_CACHE_SIZE];
+        float valence[FORSYTH_MAX_VALENCE + 1];
+
+        ForsythScores()
+        {
+            // Os 3 vértices do último triângulo têm pontuação fixa, para não favorecer o mesmo triângulo de
+            // novo; os demais decaem com a idade na cache
+            for (int i = 0; i < FORSYTH_CACHE_SIZE; i++)
+            {
+                if (i < 3)
+                    cache[i] = 0.75f;
+                else
+                    cache[i] = std::pow(1.0f - float(i - 3) / (FORSYTH_CACHE_SIZE - 3), 1.5f);
+            }
+
+            // Vértices com poucos triângulos restantes recebem um bônus, para serem concluídos logo
+            valence[0] = 0.0f;
+            for (int i = 1; i <= FORSYTH_MAX_VALENCE; i++)
+                valence[i] = 2.0f / std::sqrt(float(i));
+        }
+
+        float vertex(int cachePosition, int remaining) const
+        {
+            if (remaining == 0)
+                return -1.0f;
+            float score = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+            return score + valence[std::min(remaining, FORSYTH_MAX_VALENCE)];
+        }
+    };
+
+    /**
+     * @brief Quádrica de erro (matriz 4x4 simétrica) da soma das distâncias ao quadrado a um conjunto de planos.
+     */
+    struct Quadric
+    {
+        double a00, a01, a02, a03, a11, a12, a13, a22, a23, a33;
+
+        Quadric() : a00(0), a01(0), a02(0), a03(0), a11(0), a12(0), a13(0), a22(0), a23(0), a33(0) {}
+
+        /**
+         * @brief Acumula o plano nx*x + ny*y + nz*z + d = 0 (normal unitária) com um peso.
+         */
+        void addPlane(double nx, double ny, double nz, double d, double weight)
+        {
+            a00 += weight * nx * nx;
+            a01 += weight * nx * ny;
+            a02 += weight * nx * nz;
+            a03 += weight * nx * d;
+            a11 += weight * ny * ny;
+            a12 += weight * ny * nz;
+            a13 += weight * ny * d;
+            a22 += weight * nz * nz;
+            a23 += weight * nz * d;
+            a33 += weight * d * d;
+        }
+
+        void add(const Quadric &q)
+        {
+            a00 += q.a00;
+            a01 += q.a01;
+            a02 += q.a02;
+            a03 += q.a03;
+            a11 += q.a11;
+            a12 += q.a12;
+            a13 += q.a13;
+            a22 += q.a22;
+            a23 += q.a23;
+            a33 += q.a33;
+        }
+
+        /**
+         * @brief Erro de mover o vértice para o ponto (x, y, z).
+         */
+        double evaluate(double x, double y, double z) const
+        {
+            return a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x + a11 * y * y + 2 * a12 * y * z +
+                   2 * a13 * y + a22 * z * z + 2 * a23 * z + a33;
+        }
+    };
+
+    /**
+     * @brief Colapso candidato de um vértice sobre outro, com o erro resultante.
+     */
+    struct Collapse
+    {
+        uint32_t from; ///< Vértice removido.
+        uint32_t to;   ///< Vértice que passa a ocupar o lugar de from.
+        double cost;   ///< Erro da quádrica acumulada na posição de to.
+    };
+
+    /**
+     * @brief Índice do bone de maior peso de um vértice (-1 se não houver influência).
+     */
+    int dominantBone(const Vertex &vert)
+    {
+        int dominant = -1;
+        for (int k = 0; k < 4; k++)
+        {
+            if (vert.weights[k] > 0.0f && (dominant < 0 || vert.weights[k] > vert.weights[dominant]))
+                dominant = k;
+        }
+        return dominant < 0 ? -1 : vert.boneIDs[dominant];
+    }
+
+    /**
+     * @brief Normal não normalizada do triângulo (a, b, c).
+     */
+    void triangleNormal(const Vertex &a, const Vertex &b, const Vertex &c, double normal[3])
+    {
+        double e1[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+        double e2[3] = {c.x - a.x, c.y - a.y, c.z - a.z};
+        normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    }
+}
+
+int selectInfluences(BoneInfluence *influences, size_t count, Vertex &vert)
+{
+    // Maiores pesos primeiro; o índice do bone desempata para que o resultado seja determinístico
+    size_t kept = std::min<size_t>(count, MAX_BONE_INFLUENCES);
+    auto stronger = [](const BoneInfluence &a, const BoneInfluence &b)
+    {
+        return a.weight != b.weight ? a.weight > b.weight : a.bone < b.bone;
+    };
+    std::partial_sort(influences, influences + kept, influences + count, stronger);
+
+    float total = 0.0f;
+    for (size_t k = 0; k < kept; k++)
+    {
+        if (influences[k].weight > 0.0f)
+            total += influences[k].weight;
+    }
+
+    for (int k = 0; k < MAX_BONE_INFLUENCES; k++)
+    {
+        bool used = k < static_cast<int>(kept) && influences[k].weight > 0.0f;
+        vert.boneIDs[k] = used ? influences[k].bone : 0;
+        vert.weights[k] = used ? influences[k].weight / total : 0.0f;
+    }
+
+    int dropped = 0;
+    for (size_t k = kept; k < count; k++)
+    {
+        if (influences[k].weight > 0.0f)
+            dropped++;
+    }
+    return dropped;
+}
+
+void weldVertices(const std::vector<Vertex> &corners, const std::vector<uint32_t> &cornerIndices, SubMesh &sub)
+{
+    std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> unique;
+    unique.reserve(corners.size());
+
+    std::vector<uint32_t> indices;
+    indices.reserve(cornerIndices.size());
+    sub.vertices.clear();
+
+    // Cada canto reaproveita o vértice já emitido quando um idêntico existir
+    for (uint32_t corner : cornerIndices)
+    {
+        const Vertex &vert = corners[corner];
+        auto inserted = unique.emplace(vert, static_cast<uint32_t>(sub.vertices.size()));
+        if (inserted.second)
+            sub.vertices.push_back(vert);
+        indices.push_back(inserted.first->second);
+    }
+
+    sub.vertices.shrink_to_fit();
+    sub.setIndices(indices);
+}
+
+VertexCacheStats analyzeVertexCache(const SubMesh &sub)
+{
+    std::vector<uint32_t> indices = sub.getIndices();
+    std::vector<size_t> cachedAt(sub.vertices.size(), 0);
+    std::vector<char> used(sub.vertices.size(), 0);
+    size_t transformed = 0;
+    size_t uniqueVertices = 0;
+
+    // Um vértice está na FIFO se entrou há no máximo VERTEX_CACHE_SIZE transformações; acertos não o renovam
+    for (uint32_t index : indices)
+    {
+        if (!used[index])
+        {
+            used[index] = 1;
+            uniqueVertices++;
+        }
+        if (cachedAt[index] == 0 || transformed + 1 - cachedAt[index] > VERTEX_CACHE_SIZE)
+        {
+            transformed++;
+            cachedAt[index] = transformed;
+        }
+    }
+
+    VertexCacheStats stats;
+    stats.acmr = indices.empty() ? 0.0f : float(transformed) / (indices.size() / 3);
+    stats.atvr = uniqueVertices == 0 ? 0.0f : float(transformed) / uniqueVertices;
+    return stats;
+}
+
+void optimizeVertexCache(SubMesh &sub)
+{
+    std::vector<uint32_t> indices = sub.getIndices();
+    optimizeVertexCache(indices, sub.vertices.size());
+    sub.setIndices(indices);
+}
+
+void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount)
+{
+    static const ForsythScores scores;
+    size_t triangleCount = indices.size() / 3;
+
+    // Triângulos de cada vértice (adjacência compacta); remaining conta os ainda não emitidos
+    std::vector<int> remaining(vertexCount, 0);
+    for (uint32_t index : indices)
+        remaining[index]++;
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remaining[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<size_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        for (int k = 0; k < 3; k++)
+            adjacency[cursor[indices[t * 3 + k]]++] = t;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+        vertexScore[v] = scores.vertex(-1, remaining[v]);
+    std::vector<float> triangleScore(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        const uint32_t *triangle = &indices[t * 3];
+        triangleScore[t] = vertexScore[triangle[0]] + vertexScore[triangle[1]] + vertexScore[triangle[2]];
+    }
+
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<uint32_t> optimized;
+    optimized.reserve(indices.size());
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+    size_t nextUnemitted = 0;
+
+    // O primeiro triângulo é o de maior pontuação da malha
+    size_t best = std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin();
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        // Sem candidatos na cache, recomeça pelo próximo triângulo ainda não emitido
+        if (best == triangleCount)
+        {
+            while (emitted[nextUnemitted])
+                nextUnemitted++;
+            best = nextUnemitted;
+        }
+
+        const uint32_t *triangle = &indices[best * 3];
+        optimized.insert(optimized.end(), triangle, triangle + 3);
+        emitted[best] = 1;
+
+        // Retira o triângulo da adjacência dos seus vértices
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t v = triangle[k];
+            uint32_t *begin = &adjacency[adjacencyOffsets[v]];
+            uint32_t *end = begin + remaining[v];
+            *std::find(begin, end, static_cast<uint32_t>(best)) = *(end - 1);
+            remaining[v]--;
+        }
+
+        // Os vértices do triângulo vão para o início da cache LRU; os que passam do limite saem dela
+        nextCache.assign(triangle, triangle + 3);
+        for (uint32_t v : cache)
+        {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                nextCache.push_back(v);
+        }
+        for (size_t i = FORSYTH_CACHE_SIZE; i < nextCache.size(); i++)
+        {
+            cachePosition[nextCache[i]] = -1;
+            vertexScore[nextCache[i]] = scores.vertex(-1, remaining[nextCache[i]]);
+        }
+        nextCache.resize(std::min<size_t>(nextCache.size(), FORSYTH_CACHE_SIZE));
+        cache.swap(nextCache);
+
+        // Atualiza as pontuações dos vértices da cache e escolhe o melhor triângulo entre os que os usam
+        for (size_t i = 0; i < cache.size(); i++)
+        {
+            cachePosition[cache[i]] = i;
+            vertexScore[cache[i]] = scores.vertex(i, remaining[cache[i]]);
+        }
+        best = triangleCount;
+        float bestScore = -1.0f;
+        for (uint32_t v : cache)
+        {
+            for (int a = 0; a < remaining[v]; a++)
+            {
+                uint32_t t = adjacency[adjacencyOffsets[v] + a];
+                const uint32_t *candidate = &indices[t * 3];
+                float score = vertexScore[candidate[0]] + vertexScore[candidate[1]] + vertexScore[candidate[2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(optimized);
+}
+
+void optimizeVertexFetch(SubMesh &sub)
+{
+    std::vector<uint32_t> indices = sub.getIndices();
+    const uint32_t unassigned = ~0u;
+    std::vector<uint32_t> remap(sub.vertices.size(), unassigned);
+    std::vector<Vertex> vertices;
+    vertices.reserve(sub.vertices.size());
+
+    // Cada vértice recebe o próximo número livre na primeira vez em que um triângulo o usa
+    for (uint32_t &index : indices)
+    {
+        if (remap[index] == unassigned)
+        {
+            remap[index] = vertices.size();
+            vertices.push_back(sub.vertices[index]);
+        }
+        index = remap[index];
+    }
+    for (size_t i = 0; i < sub.vertices.size(); i++)
+    {
+        if (remap[i] == unassigned)
+            vertices.push_back(sub.vertices[i]);
+    }
+
+    sub.vertices.swap(vertices);
+    sub.setIndices(indices);
+}
+
+std::vector<uint32_t> simplifyIndices(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+                                      size_t targetIndexCount)
+{
+    size_t vertexCount = vertices.size();
+
+    // Vértices que dividem a posição com outros estão em costuras de UV; vértices em arestas usadas por um
+    // único triângulo (ou por mais de dois) estão na borda. Ambos ficam travados para preservar o contorno
+    std::vector<char> locked(vertexCount, 0);
+    std::vector<uint32_t> byPosition(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++)
+        byPosition[i] = i;
+    auto positionLess = [&](uint32_t a, uint32_t b)
+    {
+        const Vertex &va = vertices[a], &vb = vertices[b];
+        return va.x != vb.x ? va.x < vb.x : va.y != vb.y ? va.y < vb.y : va.z < vb.z;
+    };
+    std::sort(byPosition.begin(), byPosition.end(), positionLess);
+    for (size_t i = 1; i < vertexCount; i++)
+    {
+        if (!positionLess(byPosition[i - 1], byPosition[i]))
+            locked[byPosition[i - 1]] = locked[byPosition[i]] = 1;
+    }
+
+    std::unordered_map<uint64_t, int> edgeUses;
+    edgeUses.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            uint64_t a = indices[i + k], b = indices[i + (k + 1) % 3];
+            edgeUses[std::min(a, b) << 32 | std::max(a, b)]++;
+        }
+    }
+    for (const auto &edge : edgeUses)
+    {
+        if (edge.second != 2)
+            locked[edge.first >> 32] = locked[edge.first & 0xffffffffu] = 1;
+    }
+
+    std::vector<int> bones(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++)
+        bones[i] = dominantBone(vertices[i]);
+
+    // Quádrica de cada vértice: planos dos triângulos vizinhos, ponderados pela área
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        double normal[3];
+        const Vertex &a = vertices[indices[i]];
+        triangleNormal(a, vertices[indices[i + 1]], vertices[indices[i + 2]], normal);
+        double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length == 0.0)
+            continue;
+        double nx = normal[0] / length, ny = normal[1] / length, nz = normal[2] / length;
+        double d = -(nx * a.x + ny * a.y + nz * a.z);
+        for (int k = 0; k < 3; k++)
+            quadrics[indices[i + k]].addPlane(nx, ny, nz, d, length * 0.5);
+    }
+
+    std::vector<uint32_t> result = indices;
+    std::vector<uint32_t> collapseTo(vertexCount);
+    std::vector<char> touched(vertexCount);
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+    while (result.size() > targetIndexCount)
+    {
+        // Triângulos de cada vértice, para verificar se um colapso inverte algum deles
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t index : result)
+            adjacencyOffsets[index + 1]++;
+        for (size_t v = 0; v < vertexCount; v++)
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        adjacency.resize(result.size());
+        std::vector<size_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < result.size(); i++)
+            adjacency[cursor[result[i]]++] = i / 3;
+
+        // Colapsos possíveis ao longo das arestas, do menor erro para o maior. Só vértices livres são movidos,
+        // e apenas sobre vizinhos com o mesmo bone dominante, o que mantém os pesos e as fronteiras entre bones
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                uint32_t from = result[i + k], to = result[i + (k + 1) % 3];
+                if (locked[from] || bones[from] != bones[to])
+                    continue;
+                Quadric q = quadrics[from];
+                q.add(quadrics[to]);
+                collapses.push_back(Collapse{from, to, q.evaluate(vertices[to].x, vertices[to].y, vertices[to].z)});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+        // Aplica colapsos independentes (sem vértices em comum com os já feitos na passada) até a meta
+        for (size_t v = 0; v < vertexCount; v++)
+            collapseTo[v] = v;
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+        size_t removed = 0;
+        for (const Collapse &collapse : collapses)
+        {
+            if (removed >= trianglesToRemove)
+                break;
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+
+            bool flips = false;
+            size_t collapsedTriangles = 0;
+            for (size_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1] && !flips; a++)
+            {
+                const uint32_t *triangle = &result[adjacency[a] * 3];
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+                {
+                    collapsedTriangles++;
+                    continue;
+                }
+
+                // Rejeita o colapso se a normal do triângulo girar mais de ~75 graus
+                const Vertex *corners[3];
+                for (int k = 0; k < 3; k++)
+                    corners[k] = &vertices[triangle[k] == collapse.from ? collapse.to : triangle[k]];
+                double before[3], after[3];
+                triangleNormal(vertices[triangle[0]], vertices[triangle[1]], vertices[triangle[2]], before);
+                triangleNormal(*corners[0], *corners[1], *corners[2], after);
+                double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+                double lengths = std::sqrt((before[0] * before[0] + before[1] * before[1] + before[2] * before[2]) *
+                                           (after[0] * after[0] + after[1] * after[1] + after[2] * after[2]));
+                flips = dot <= 0.25 * lengths;
+            }
+            if (flips || collapsedTriangles == 0)
+                continue;
+
+            // Os vizinhos também são marcados, pois a verificação acima assumiu as posições atuais deles
+            for (size_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++)
+            {
+                const uint32_t *triangle = &result[adjacency[a] * 3];
+                touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+            }
+            collapseTo[collapse.from] = collapse.to;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            removed += collapsedTriangles;
+        }
+        if (removed == 0)
+            break;
+
+        // Reescreve os índices descartando os triângulos que se tornaram degenerados
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            uint32_t a = collapseTo[result[i]], b = collapseTo[result[i + 1]], c = collapseTo[result[i + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+    return result;
+}
+
+void buildLodChain(SubMesh &sub, int lodCount)
+{
+    // Cada LOD é simplificado a partir do anterior, com a metade dos triângulos do LOD 0 a cada nível
+    std::vector<uint32_t> indices = sub.getIndices();
+    indices.resize(sub.lodIndexCount(0));
+    std::vector<uint32_t> previous = indices;
+    sub.lodOffsets.clear();
+    for (int lod = 1; lod < lodCount; lod++)
+    {
+        size_t target = (sub.lodIndexCount(0) / 3 >> lod) * 3;
+        std::vector<uint32_t> simplified = simplifyIndices(sub.vertices, previous, target);
+
+        // Um nível que quase não reduz a malha (costuras e bordas travadas) encerra a cadeia
+        if (simplified.empty() || simplified.size() * 10 > previous.size() * 9)
+            break;
+        optimizeVertexCache(simplified, sub.vertices.size());
+        sub.lodOffsets.push_back(indices.size());
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+    sub.setIndices(indices);
+}
+
+int selectLodForSize(float pixels)
+{
+    int lod = 0;
+    for (float threshold = LOD_FULL_DETAIL_PIXELS; pixels < threshold && lod < MAX_LOD_COUNT - 1; threshold *= 0.5f)
+        lod++;
+    return lod;
+}
+
+void sortVerticesByBone(SubMesh &sub, size_t boneCount)
+{
+    // Chave de cada vértice: índice do bone de maior peso
+    std::vector<int> keys(sub.vertices.size());
+    for (size_t i = 0; i < sub.vertices.size(); i++)
+    {
+        int dominant = dominantBone(sub.vertices[i]);
+        keys[i] = dominant < 0 ? static_cast<int>(boneCount) : dominant;
+    }
+
+    std::vector<uint32_t> order(sub.vertices.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    // Aplica a nova ordem aos vértices e atualiza os índices dos triângulos
+    std::vector<Vertex> vertices(sub.vertices.size());
+    std::vector<uint32_t> remap(sub.vertices.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        vertices[i] = sub.vertices[order[i]];
+        remap[order[i]] = i;
+    }
+    sub.vertices.swap(vertices);
+
+    std::vector<uint32_t> indices = sub.getIndices();
+    for (uint32_t &index : indices)
+        index = remap[index];
+    sub.setIndices(indices);
+}
@@ -0,0 +1,152 @@
+#ifndef MESHPROCESSING_HPP
+#define MESHPROCESSING_HPP
+
+#include <vector>
+#include <cstdint>
+#include "skinnedmeshasset.hpp"
+
+/**
+ * @brief Quantidade máxima de influências mantidas por vértice (tamanho de Vertex::boneIDs).
+ */
+const int MAX_BONE_INFLUENCES = 4;
+
+/**
+ * @brief Tamanho da cache de vértices transformados (FIFO) simulada nas estatísticas de ACMR e ATVR.
+ */
+const size_t VERTEX_CACHE_SIZE = 16;
+
+/**
+ * @brief Quantidade máxima de níveis de detalhe gerados por submesh, incluindo a malha original.
+ */
+const int MAX_LOD_COUNT = 4;
+
+/**
+ * @brief Altura projetada, em pixels, a partir da qual o LOD 0 é usado; cada LOD seguinte vale para a metade.
+ */
+const float LOD_FULL_DETAIL_PIXELS = 300.0f;
+
+/**
+ * @brief Influência de um bone sobre um vértice, como lida do modelo.
+ */
+struct BoneInfluence
+{
+    int bone;     ///< Índice do bone.
+    float weight; ///< Peso da influência.
+};
+
+/**
+ * @brief Mantém as MAX_BONE_INFLUENCES influências mais fortes de um vértice e renormaliza os pesos.
+ *
+ * Influências com peso não positivo são descartadas. Os slots restantes recebem bone 0 e peso 0.
+ *
+ * @param influences Todas as influências do vértice (são reordenadas).
+ * @param count Quantidade de influências.
+ * @param vert Vértice que recebe os bones e os pesos.
+ * @return Quantidade de influências positivas descartadas por excederem o limite.
+ */
+int selectInfluences(BoneInfluence *influences, size_t count, Vertex &vert);
+
+/**
+ * @brief Solda os vértices idênticos de uma malha e gera os índices dos triângulos.
+ *
+ * Dois vértices são considerados idênticos quando posição, UV, bones e pesos coincidem,
+ * de modo que cada vértice único é armazenado e transformado uma única vez.
+ *
+ * @param corners Vértices de origem, referenciados pelos cantos dos triângulos.
+ * @param cornerIndices Índice em corners de cada canto (3 por triângulo).
+ * @param sub Submesh que recebe os vértices únicos e os índices.
+ */
+void weldVertices(const std::vector<Vertex> &corners, const std::vector<uint32_t> &cornerIndices, SubMesh &sub);
+
+/**
+ * @brief Eficiência da cache de vértices transformados para uma ordem de triângulos.
+ */
+struct VertexCacheStats
+{
+    float acmr; ///< Average cache miss ratio: vértices transformados por triângulo (entre 0.5 e 3).
+    float atvr; ///< Average transformed vertex ratio: vértices transformados por vértice único (1 é o ideal).
+};
+
+/**
+ * @brief Simula uma cache FIFO de VERTEX_CACHE_SIZE vértices percorrendo os índices de um submesh.
+ * @param sub Submesh analisado.
+ * @return ACMR e ATVR dos índices na ordem atual.
+ */
+VertexCacheStats analyzeVertexCache(const SubMesh &sub);
+
+/**
+ * @brief Reordena os triângulos de um submesh para a cache de vértices transformados (algoritmo de Forsyth).
+ *
+ * A cada passo é emitido o triângulo de maior pontuação entre os que usam vértices da cache LRU simulada.
+ * A pontuação de um vértice favorece os que estão mais recentes na cache e os que restam em poucos
+ * triângulos, para que sejam concluídos antes de saírem da cache. Os vértices não são alterados.
+ *
+ * @param sub Submesh a ser reordenado.
+ */
+void optimizeVertexCache(SubMesh &sub);
+
+/**
+ * @brief Versão de optimizeVertexCache() para uma lista de índices avulsa, como a de um LOD.
+ * @param indices Índices dos triângulos, reordenados no lugar.
+ * @param vertexCount Quantidade de vértices referenciáveis pelos índices.
+ */
+void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+
+/**
+ * @brief Renumera os vértices de um submesh na ordem em que os índices os usam pela primeira vez.
+ *
+ * Deve ser chamada após optimizeVertexCache(), para que as leituras de vértices sigam a ordem dos
+ * triângulos. Vértices não referenciados por nenhum triângulo ficam no final.
+ *
+ * @param sub Submesh a ser reordenado.
+ */
+void optimizeVertexFetch(SubMesh &sub);
+
+/**
+ * @brief Simplifica uma malha por colapsos de arestas guiados por quádricas de erro, sem criar vértices.
+ *
+ * Cada colapso move um vértice sobre um vizinho, de modo que os índices resultantes continuam usando os
+ * vértices originais, com UVs e pesos intactos. Vértices em costuras de UV e bordas nunca são movidos, e
+ * um vértice só colapsa sobre outro com o mesmo bone dominante. Colapsos que invertem triângulos são
+ * rejeitados, então a meta pode não ser atingida.
+ *
+ * @param vertices Vértices do submesh.
+ * @param indices Índices dos triângulos a simplificar.
+ * @param targetIndexCount Quantidade de índices desejada.
+ * @return Índices simplificados.
+ */
+std::vector<uint32_t> simplifyIndices(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+                                      size_t targetIndexCount);
+
+/**
+ * @brief Gera a cadeia de LODs de um submesh a partir do LOD 0, com a metade dos triângulos a cada nível.
+ *
+ * Os LODs são concatenados aos índices do LOD 0 (ver SubMesh::lodOffsets), já otimizados para a cache de
+ * vértices. A cadeia termina antes de lodCount quando a simplificação deixa de reduzir a malha.
+ *
+ * @param sub Submesh com o LOD 0 nos índices; LODs anteriores são descartados.
+ * @param lodCount Quantidade máxima de níveis, incluindo o LOD 0.
+ */
+void buildLodChain(SubMesh &sub, int lodCount);
+
+/**
+ * @brief Escolhe o LOD pela altura projetada do modelo: um nível a mais a cada vez que ela cai pela metade.
+ * @param pixels Altura projetada da esfera envolvente, em pixels.
+ * @return LOD entre 0 e MAX_LOD_COUNT - 1.
+ */
+int selectLodForSize(float pixels);
+
+/**
+ * @brief Reordena os vértices de um submesh pelo bone dominante (maior peso), remapeando os índices.
+ *
+ * Com os bones numerados em pré-ordem da hierarquia, os vértices dominados por um bone e por seus
+ * descendentes ficam contíguos, o que reduz a quantidade de intervalos a retransformar quando
+ * apenas parte do esqueleto se move. A ordem relativa dos vértices com o mesmo bone é mantida, então a
+ * ordem de leitura de optimizeVertexFetch() continua valendo dentro de cada grupo.
+ *
+ * @param sub Submesh a ser reordenado.
+ * @param boneCount Quantidade de bones; vértices sem influência ficam no final.
+ */
+void sortVerticesByBone(SubMesh &sub, size_t boneCount);
+
+#endif
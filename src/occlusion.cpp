@@ -0,0 +1,250 @@
+#include "occlusion.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+OcclusionBuffer::OcclusionBuffer() : width(0), height(0), viewProjection(1.0f), threadPool(nullptr)
+{
+}
+
+bool OcclusionBuffer::create(int bufferWidth, int bufferHeight)
+{
+    levels.clear();
+    levelWidths.clear();
+    levelHeights.clear();
+    triangles.clear();
+    if (bufferWidth <= 0 || bufferHeight <= 0)
+        return false;
+    width = bufferWidth;
+    height = bufferHeight;
+
+    // Cada nível tem a metade (arredondada para cima) das dimensões do anterior, até um único pixel
+    for (int w = width, h = height;; w = (w + 1) / 2, h = (h + 1) / 2)
+    {
+        levelWidths.push_back(w);
+        levelHeights.push_back(h);
+        levels.emplace_back(static_cast<size_t>(w) * h, 1.0f);
+        if (w == 1 && h == 1)
+            break;
+    }
+    return true;
+}
+
+void OcclusionBuffer::setThreadPool(ThreadPool *pool)
+{
+    threadPool = pool;
+}
+
+void OcclusionBuffer::begin(const glm::mat4 &cameraViewProjection)
+{
+    viewProjection = cameraViewProjection;
+    triangles.clear();
+}
+
+void OcclusionBuffer::addOccluder(const float *positions, size_t vertexCount, const uint32_t *indices,
+                                  size_t indexCount)
+{
+    if (levels.empty())
+        return;
+    clipVertices.resize(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+        clipVertices[v] = viewProjection * glm::vec4(positions[v * 3], positions[v * 3 + 1], positions[v * 3 + 2], 1.0f);
+
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        const glm::vec4 *corners[3] = {&clipVertices[indices[i]], &clipVertices[indices[i + 1]],
+                                       &clipVertices[indices[i + 2]]};
+        OccluderTriangle triangle;
+        bool crossesNear = false;
+        for (int k = 0; k < 3; k++)
+        {
+            const glm::vec4 &c = *corners[k];
+            if (c.w <= 0.0f || c.z < -c.w)
+            {
+                crossesNear = true;
+                break;
+            }
+            triangle.x[k] = (c.x / c.w * 0.5f + 0.5f) * width;
+            triangle.y[k] = (c.y / c.w * 0.5f + 0.5f) * height;
+            triangle.z[k] = c.z / c.w * 0.5f + 0.5f;
+        }
+        if (crossesNear)
+            continue;
+
+        // Orientação anti-horária na tela, para que as funções de aresta sejam positivas dentro do triângulo
+        float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) -
+                     (triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+        if (area < 0.0f)
+        {
+            std::swap(triangle.x[1], triangle.x[2]);
+            std::swap(triangle.y[1], triangle.y[2]);
+            std::swap(triangle.z[1], triangle.z[2]);
+            area = -area;
+        }
+        if (area < 1e-6f)
+            continue;
+        triangle.inverseArea = 1.0f / area;
+
+        // Pixels cujo centro (x + 0.5, y + 0.5) pode estar dentro do triângulo
+        float minX = std::min({triangle.x[0], triangle.x[1], triangle.x[2]});
+        float maxX = std::max({triangle.x[0], triangle.x[1], triangle.x[2]});
+        float minY = std::min({triangle.y[0], triangle.y[1], triangle.y[2]});
+        float maxY = std::max({triangle.y[0], triangle.y[1], triangle.y[2]});
+        triangle.minX = std::max(0, static_cast<int>(std::ceil(minX - 0.5f)));
+        triangle.maxX = std::min(width - 1, static_cast<int>(std::floor(maxX - 0.5f)));
+        triangle.minY = std::max(0, static_cast<int>(std::ceil(minY - 0.5f)));
+        triangle.maxY = std::min(height - 1, static_cast<int>(std::floor(maxY - 0.5f)));
+        if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+            continue;
+        triangles.push_back(triangle);
+    }
+}
+
+void OcclusionBuffer::finish()
+{
+    if (levels.empty())
+        return;
+
+    // Cada tarefa limpa e rasteriza as suas linhas, então as tarefas nunca escrevem nos mesmos pixels
+    auto rasterize = [this](size_t begin, size_t end) { rasterizeRows(static_cast<int>(begin), static_cast<int>(end)); };
+    if (threadPool)
+        threadPool->parallelFor(0, height, OCCLUSION_BAND_ROWS, rasterize);
+    else
+        rasterize(0, height);
+    buildPyramid();
+}
+
+void OcclusionBuffer::rasterizeRows(int rowBegin, int rowEnd)
+{
+    float *depth = levels[0].data();
+    std::fill(depth + static_cast<size_t>(rowBegin) * width, depth + static_cast<size_t>(rowEnd) * width, 1.0f);
+
+    for (const OccluderTriangle &t : triangles)
+    {
+        int y0 = std::max(t.minY, rowBegin), y1 = std::min(t.maxY, rowEnd - 1);
+        if (y0 > y1)
+            continue;
+
+        // Função de cada aresta, oposta ao vértice k, avaliada no centro do primeiro pixel de cada linha e
+        // incrementada ao longo dela
+        float stepX[3], stepY[3], origin[3];
+        for (int k = 0; k < 3; k++)
+        {
+            int a = (k + 1) % 3, b = (k + 2) % 3;
+            stepX[k] = t.y[a] - t.y[b];
+            stepY[k] = t.x[b] - t.x[a];
+            origin[k] = (t.x[b] - t.x[a]) * (t.minY + 0.5f - t.y[a]) - (t.y[b] - t.y[a]) * (t.minX + 0.5f - t.x[a]);
+        }
+        for (int y = y0; y <= y1; y++)
+        {
+            float w[3];
+            for (int k = 0; k < 3; k++)
+                w[k] = origin[k] + stepY[k] * (y - t.minY);
+            float *row = depth + static_cast<size_t>(y) * width;
+            for (int x = t.minX; x <= t.maxX; x++)
+            {
+                if (w[0] >= 0.0f && w[1] >= 0.0f && w[2] >= 0.0f)
+                {
+                    float z = (w[0] * t.z[0] + w[1] * t.z[1] + w[2] * t.z[2]) * t.inverseArea;
+                    row[x] = std::min(row[x], z);
+                }
+                for (int k = 0; k < 3; k++)
+                    w[k] += stepX[k];
+            }
+        }
+    }
+}
+
+void OcclusionBuffer::buildPyramid()
+{
+    // Cada pixel guarda a profundidade mais distante dos até 2x2 pixels do nível anterior que ele cobre
+    for (size_t level = 1; level < levels.size(); level++)
+    {
+        const std::vector<float> &source = levels[level - 1];
+        std::vector<float> &target = levels[level];
+        int sourceWidth = levelWidths[level - 1], sourceHeight = levelHeights[level - 1];
+        for (int y = 0; y < levelHeights[level]; y++)
+        {
+            int y0 = y * 2, y1 = std::min(y * 2 + 1, sourceHeight - 1);
+            for (int x = 0; x < levelWidths[level]; x++)
+            {
+                int x0 = x * 2, x1 = std::min(x * 2 + 1, sourceWidth - 1);
+                target[static_cast<size_t>(y) * levelWidths[level] + x] =
+                    std::max(std::max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+                             std::max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+            }
+        }
+    }
+}
+
+bool OcclusionBuffer::isVisible(const glm::vec3 &minimum, const glm::vec3 &maximum) const
+{
+    if (levels.empty())
+        return true;
+
+    // Retângulo e profundidade mais próxima dos 8 cantos projetados; uma caixa que cruza o plano próximo
+    // não tem projeção limitada e é considerada visível
+    float minX = std::numeric_limits<float>::max(), minY = minX, nearest = minX;
+    float maxX = -minX, maxY = -minX;
+    for (int corner = 0; corner < 8; corner++)
+    {
+        glm::vec4 c = viewProjection * glm::vec4(corner & 1 ? maximum.x : minimum.x, corner & 2 ? maximum.y : minimum.y,
+                                                 corner & 4 ? maximum.z : minimum.z, 1.0f);
+        if (c.w <= 0.0f || c.z < -c.w)
+            return true;
+        float x = (c.x / c.w * 0.5f + 0.5f) * width, y = (c.y / c.w * 0.5f + 0.5f) * height;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearest = std::min(nearest, c.z / c.w * 0.5f + 0.5f);
+    }
+
+    // Um pixel a mais em cada lado cobre a diferença entre a cobertura pelos centros e a área real
+    int x0 = std::max(0, static_cast<int>(std::floor(minX)) - 1);
+    int x1 = std::min(width - 1, static_cast<int>(std::floor(maxX)) + 1);
+    int y0 = std::max(0, static_cast<int>(std::floor(minY)) - 1);
+    int y1 = std::min(height - 1, static_cast<int>(std::floor(maxY)) + 1);
+    if (x0 > x1 || y0 > y1)
+        return true;
+
+    // Nível em que o retângulo cobre no máximo 4x4 pixels
+    size_t level = 0;
+    while (level + 1 < levels.size() && ((x1 >> level) - (x0 >> level) > 3 || (y1 >> level) - (y0 >> level) > 3))
+        level++;
+    const float *depth = levels[level].data();
+    int levelWidth = levelWidths[level];
+    for (int y = y0 >> level; y <= y1 >> level; y++)
+    {
+        for (int x = x0 >> level; x <= x1 >> level; x++)
+        {
+            if (depth[static_cast<size_t>(y) * levelWidth + x] >= nearest)
+                return true;
+        }
+    }
+    return false;
+}
+
+void OcclusionBuffer::cullOccluded(const BoundingBoxes &boxes, size_t begin, size_t end, uint8_t *visible) const
+{
+    auto test = [&](size_t first, size_t last)
+    {
+        glm::vec3 minimum, maximum;
+        for (size_t i = first; i < last; i++)
+        {
+            if (!visible[i])
+                continue;
+            boxes.get(i, minimum, maximum);
+            visible[i] = isVisible(minimum, maximum);
+        }
+    };
+    if (threadPool)
+        threadPool->parallelFor(begin, end, OCCLUSION_TEST_TASK_SIZE, test);
+    else
+        test(begin, end);
+}
+
+size_t OcclusionBuffer::getTriangleCount() const
+{
+    return triangles.size();
+}
@@ -0,0 +1,157 @@
+#ifndef OCCLUSION_HPP
+#define OCCLUSION_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "bounds.hpp"
+#include "threadpool.hpp"
+
+/**
+ * @brief Largura padrão, em pixels, do buffer de profundidade dos oclusores.
+ */
+const int OCCLUSION_WIDTH = 256;
+
+/**
+ * @brief Altura padrão, em pixels, do buffer de profundidade dos oclusores (4:3, como a janela).
+ */
+const int OCCLUSION_HEIGHT = 192;
+
+/**
+ * @brief Quantidade máxima de linhas do buffer rasterizadas em cada tarefa paralela.
+ */
+const size_t OCCLUSION_BAND_ROWS = 16;
+
+/**
+ * @brief Quantidade máxima de caixas testadas em cada tarefa paralela.
+ */
+const size_t OCCLUSION_TEST_TASK_SIZE = 256;
+
+/**
+ * @brief Fração da distância ao centro da caixa do bone dominante mantida em cada vértice da malha oclusora.
+ *
+ * O LOD mais simples pode passar da silhueta real (triângulos que ligam o braço ao tronco, por exemplo);
+ * encolhido para dentro do corpo, ele cobre menos pixels e fica atrás da superfície verdadeira.
+ */
+const float OCCLUDER_SHRINK = 0.8f;
+
+/**
+ * @brief Triângulo de um oclusor já projetado no buffer, com a orientação corrigida para área positiva.
+ */
+struct OccluderTriangle
+{
+    float x[3], y[3];       ///< Vértices em pixels do buffer.
+    float z[3];             ///< Profundidade de cada vértice, entre 0 (perto) e 1 (longe).
+    float inverseArea;      ///< Inverso do dobro da área, para normalizar as coordenadas baricêntricas.
+    int minX, minY;         ///< Primeiro pixel coberto pelo retângulo envolvente.
+    int maxX, maxY;         ///< Último pixel coberto pelo retângulo envolvente.
+};
+
+/**
+ * @brief Buffer de profundidade em baixa resolução rasterizado na CPU, com uma pirâmide de profundidades
+ * para testar caixas contra os oclusores (hierarchical-Z).
+ *
+ * A cada quadro, begin() recebe a câmera, addOccluder() projeta os triângulos dos oclusores e finish()
+ * os rasteriza em faixas de linhas distribuídas no pool de threads e monta a pirâmide, em que cada nível
+ * guarda a profundidade mais distante de 2x2 pixels do anterior. Uma caixa está oculta se o ponto mais
+ * próximo dela estiver atrás da profundidade mais distante de todos os pixels que ela cobre.
+ *
+ * O teste é conservador em relação ao buffer: caixas que cruzam o plano próximo, fora da tela ou sobre
+ * pixels sem oclusor são sempre visíveis, e o retângulo de cada caixa é aumentado em um pixel. Ele só é
+ * conservador em relação à cena se cada oclusor estiver dentro do objeto que representa; malhas
+ * simplificadas devem ser encolhidas antes (ver OCCLUDER_SHRINK).
+ */
+class OcclusionBuffer
+{
+private:
+    int width;                                ///< Largura do nível 0, em pixels.
+    int height;                               ///< Altura do nível 0, em pixels.
+    std::vector<std::vector<float>> levels;   ///< Profundidades de cada nível; o nível 0 é o rasterizado.
+    std::vector<int> levelWidths;             ///< Largura de cada nível.
+    std::vector<int> levelHeights;            ///< Altura de cada nível.
+    glm::mat4 viewProjection;                 ///< Matriz da câmera do quadro atual.
+    std::vector<OccluderTriangle> triangles;  ///< Triângulos projetados desde o último begin().
+    std::vector<glm::vec4> clipVertices;      ///< Vértices do oclusor atual no espaço de recorte.
+    ThreadPool *threadPool;                   ///< Pool usado na rasterização e nos testes (nullptr executa na thread atual).
+
+public:
+    /**
+     * @brief Construtor, cria um buffer vazio.
+     */
+    OcclusionBuffer();
+
+    /**
+     * @brief Aloca o buffer e os níveis da pirâmide.
+     * @param bufferWidth Largura em pixels.
+     * @param bufferHeight Altura em pixels.
+     * @return true se o buffer foi criado, false se o tamanho for inválido.
+     */
+    bool create(int bufferWidth = OCCLUSION_WIDTH, int bufferHeight = OCCLUSION_HEIGHT);
+
+    /**
+     * @brief Define o pool de threads usado na rasterização e nos testes.
+     * @param pool Pool de threads, que deve existir enquanto o buffer for usado (nullptr desativa).
+     */
+    void setThreadPool(ThreadPool *pool);
+
+    /**
+     * @brief Começa um quadro, descartando os oclusores do anterior.
+     * @param cameraViewProjection Matriz de projeção e visão da câmera (Camera3D::viewProjection()).
+     */
+    void begin(const glm::mat4 &cameraViewProjection);
+
+    /**
+     * @brief Projeta os triângulos de um oclusor.
+     *
+     * Triângulos que cruzam o plano próximo são ignorados: o oclusor fica menor, nunca maior.
+     *
+     * @param positions Posições no mundo (x, y, z por vértice).
+     * @param vertexCount Quantidade de vértices.
+     * @param indices Índices dos triângulos.
+     * @param indexCount Quantidade de índices (3 por triângulo).
+     */
+    void addOccluder(const float *positions, size_t vertexCount, const uint32_t *indices, size_t indexCount);
+
+    /**
+     * @brief Rasteriza os triângulos projetados desde begin() e monta a pirâmide de profundidades.
+     */
+    void finish();
+
+    /**
+     * @brief Informa se alguma parte de uma caixa pode estar à frente dos oclusores.
+     * @param minimum Canto mínimo da caixa, no mundo.
+     * @param maximum Canto máximo da caixa, no mundo.
+     */
+    bool isVisible(const glm::vec3 &minimum, const glm::vec3 &maximum) const;
+
+    /**
+     * @brief Testa um intervalo de caixas contra os oclusores, dividindo as caixas no pool de threads.
+     * @param boxes Caixas, no mundo.
+     * @param begin Primeira caixa do intervalo.
+     * @param end Caixa seguinte à última do intervalo.
+     * @param visible Resultado de cada caixa, a partir de visible[begin]; só as caixas já marcadas como
+     *                visíveis são testadas, e as ocultas passam a 0.
+     */
+    void cullOccluded(const BoundingBoxes &boxes, size_t begin, size_t end, uint8_t *visible) const;
+
+    /**
+     * @brief Quantidade de triângulos projetados desde o último begin().
+     */
+    size_t getTriangleCount() const;
+
+private:
+    /**
+     * @brief Limpa e rasteriza todos os triângulos em um intervalo de linhas do nível 0.
+     * @param rowBegin Primeira linha.
+     * @param rowEnd Linha seguinte à última.
+     */
+    void rasterizeRows(int rowBegin, int rowEnd);
+
+    /**
+     * @brief Monta os níveis da pirâmide a partir do nível 0.
+     */
+    void buildPyramid();
+};
+
+#endif
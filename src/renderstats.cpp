@@ -0,0 +1,14 @@
+#include "renderstats.hpp"
+
+RenderStats renderStats = {0, 0, 0, 0, 0, 0, 0};
+
+void RenderStats::reset()
+{
+    glCalls = 0;
+    drawCalls = 0;
+    triangles = 0;
+    fenceWaits = 0;
+    skinnedVertices = 0;
+    culledMeshlets = 0;
+    culledSubmeshes = 0;
+}
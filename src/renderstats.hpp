@@ -0,0 +1,25 @@
+#ifndef RENDERSTATS_HPP
+#define RENDERSTATS_HPP
+
+/**
+ * @brief Contadores do trabalho enviado ao driver OpenGL, acumulados até o próximo reset().
+ */
+struct RenderStats
+{
+    unsigned long glCalls;         ///< Chamadas OpenGL emitidas pelo código de renderização.
+    unsigned long drawCalls;       ///< Comandos de desenho (glDraw*).
+    unsigned long triangles;       ///< Triângulos enviados.
+    unsigned long fenceWaits;      ///< Vezes em que a CPU precisou esperar a GPU liberar uma região do anel.
+    unsigned long skinnedVertices; ///< Vértices transformados pelo skinning na CPU.
+    unsigned long culledMeshlets;  ///< Meshlets descartados antes do envio (fora do frustum ou de costas).
+    unsigned long culledSubmeshes; ///< Submeshes (de um personagem ou instância) descartados fora do frustum.
+
+    /**
+     * @brief Zera todos os contadores.
+     */
+    void reset();
+};
+
+extern RenderStats renderStats;
+
+#endif
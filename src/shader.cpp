@@ -0,0 +1,92 @@
+#include "shader.hpp"
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Compila um estágio do programa, exibindo o log em caso de erro.
+ */
+static GLuint compileStage(GLenum type, const char *source)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint status;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status)
+    {
+        GLint length;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::vector<char> log(length + 1);
+        glGetShaderInfoLog(shader, length, nullptr, log.data());
+        std::cerr << "Erro ao compilar shader: " << log.data() << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+ShaderProgram::ShaderProgram() : programID(0) {}
+
+ShaderProgram::~ShaderProgram()
+{
+    destroy();
+}
+
+bool ShaderProgram::build(const char *vertexSource, const char *fragmentSource,
+                          const std::map<GLuint, std::string> &attributeLocations)
+{
+    destroy();
+
+    GLuint vertexShader = compileStage(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = fragmentSource ? compileStage(GL_FRAGMENT_SHADER, fragmentSource) : 0;
+    if (!vertexShader || (fragmentSource && !fragmentShader))
+    {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return false;
+    }
+
+    programID = glCreateProgram();
+    glAttachShader(programID, vertexShader);
+    if (fragmentShader)
+        glAttachShader(programID, fragmentShader);
+    for (const auto &attribute : attributeLocations)
+        glBindAttribLocation(programID, attribute.first, attribute.second.c_str());
+    glLinkProgram(programID);
+
+    // Os estágios não são mais necessários depois da ligação
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint status;
+    glGetProgramiv(programID, GL_LINK_STATUS, &status);
+    if (!status)
+    {
+        GLint length;
+        glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &length);
+        std::vector<char> log(length + 1);
+        glGetProgramInfoLog(programID, length, nullptr, log.data());
+        std::cerr << "Erro ao ligar shader: " << log.data() << std::endl;
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+void ShaderProgram::destroy()
+{
+    if (programID)
+        glDeleteProgram(programID);
+    programID = 0;
+}
+
+GLuint ShaderProgram::id() const
+{
+    return programID;
+}
+
+GLint ShaderProgram::uniform(const char *name) const
+{
+    return glGetUniformLocation(programID, name);
+}
@@ -0,0 +1,61 @@
+#ifndef SHADER_HPP
+#define SHADER_HPP
+
+#include <GL/glew.h>
+#include <map>
+#include <string>
+
+/**
+ * @brief Programa GLSL compilado a partir de código-fonte embutido.
+ */
+class ShaderProgram
+{
+private:
+    GLuint programID; ///< Programa OpenGL (0 se não compilado).
+
+public:
+    /**
+     * @brief Construtor, não cria recursos OpenGL.
+     */
+    ShaderProgram();
+
+    /**
+     * @brief Destrutor, libera o programa.
+     */
+    ~ShaderProgram();
+
+    ShaderProgram(const ShaderProgram &) = delete;
+    ShaderProgram &operator=(const ShaderProgram &) = delete;
+
+    /**
+     * @brief Compila e liga o programa.
+     *
+     * Sem fragment shader, o perfil de compatibilidade usa o processamento de fragmentos fixo
+     * (texturização, neblina etc.), exatamente como no pipeline sem shaders.
+     *
+     * @param vertexSource Código do vertex shader.
+     * @param fragmentSource Código do fragment shader (nullptr para usar o pipeline fixo).
+     * @param attributeLocations Localização fixa de cada atributo, aplicada antes da ligação.
+     * @return true se o programa foi compilado e ligado, false caso contrário.
+     */
+    bool build(const char *vertexSource, const char *fragmentSource,
+               const std::map<GLuint, std::string> &attributeLocations = {});
+
+    /**
+     * @brief Libera o programa.
+     */
+    void destroy();
+
+    /**
+     * @brief Retorna o programa OpenGL.
+     */
+    GLuint id() const;
+
+    /**
+     * @brief Retorna a localização de um uniform (-1 se não existir).
+     * @param name Nome do uniform.
+     */
+    GLint uniform(const char *name) const;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "skeleton.hpp"
+
+std::vector<int> skeletonPreorder(const std::vector<BoneInfo> &bones)
+{
+    std::vector<std::vector<int>> children(bones.size());
+    std::vector<int> stack;
+    for (int i = bones.size() - 1; i >= 0; i--)
+    {
+        if (bones[i].parentIndex >= 0)
+            children[bones[i].parentIndex].push_back(i);
+        else
+            stack.push_back(i);
+    }
+
+    // Busca em profundidade sem recursão; os filhos são empilhados de trás para frente para manter a ordem dos índices
+    std::vector<int> order;
+    order.reserve(bones.size());
+    while (!stack.empty())
+    {
+        int bone = stack.back();
+        stack.pop_back();
+        order.push_back(bone);
+        for (int child : children[bone])
+            stack.push_back(child);
+    }
+    return order;
+}
+
+std::vector<int> sortBonesTopologically(std::vector<BoneInfo> &bones)
+{
+    std::vector<int> order = skeletonPreorder(bones);
+    std::vector<int> remap(bones.size());
+    for (size_t i = 0; i < order.size(); i++)
+        remap[order[i]] = i;
+
+    std::vector<BoneInfo> sorted(bones.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        sorted[i] = bones[order[i]];
+        if (sorted[i].parentIndex >= 0)
+            sorted[i].parentIndex = remap[sorted[i].parentIndex];
+    }
+    bones.swap(sorted);
+    return remap;
+}
+
+bool isTopologicallySorted(const std::vector<BoneInfo> &bones)
+{
+    for (size_t i = 0; i < bones.size(); i++)
+    {
+        if (bones[i].parentIndex < -1 || bones[i].parentIndex >= static_cast<int>(i))
+            return false;
+    }
+    return true;
+}
+
+void updateSkeleton(BoneInfo *bones, size_t count, aiMatrix4x4 *globals)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        BoneInfo &bone = bones[i];
+        globals[i] = bone.parentIndex < 0 ? bone.localTransform : globals[bone.parentIndex] * bone.localTransform;
+        bone.finalTransformation = globals[i] * bone.offsetMatrix;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef SKELETON_HPP
+#define SKELETON_HPP
+
+#include <vector>
+#include "skinnedmeshasset.hpp"
+
+/**
+ * @brief Retorna os índices dos bones em pré-ordem da hierarquia (cada pai antes dos seus filhos).
+ *
+ * Raízes e irmãos são visitados na ordem dos seus índices.
+ *
+ * @param bones Bones com parentIndex preenchido.
+ */
+std::vector<int> skeletonPreorder(const std::vector<BoneInfo> &bones);
+
+/**
+ * @brief Reordena os bones em pré-ordem, de forma que todo pai tenha índice menor que seus filhos.
+ * @param bones Bones reordenados, com parentIndex atualizado.
+ * @return Novo índice de cada bone, indexado pelo índice anterior.
+ */
+std::vector<int> sortBonesTopologically(std::vector<BoneInfo> &bones);
+
+/**
+ * @brief Informa se todo bone aparece depois do seu pai e se os pais são válidos (-1 nas raízes).
+ */
+bool isTopologicallySorted(const std::vector<BoneInfo> &bones);
+
+/**
+ * @brief Calcula as transformações globais e finais de um esqueleto ordenado em uma única passada.
+ *
+ * Como cada pai vem antes dos filhos, a transformação global do pai já está pronta quando o filho é
+ * processado: cada bone custa uma multiplicação de matrizes para a global e outra para a final.
+ *
+ * @param bones Bones ordenados topologicamente; finalTransformation é atualizada.
+ * @param count Quantidade de bones.
+ * @param globals Transformações globais resultantes (count elementos).
+ */
+void updateSkeleton(BoneInfo *bones, size_t count, aiMatrix4x4 *globals);
+
+#endif
@@ -0,0 +1,720 @@
+#include "skinnedmeshasset.hpp"
+#include "meshcache.hpp"
+#include "meshlet.hpp"
+#include "meshprocessing.hpp"
+#include "skeleton.hpp"
+#include "occlusion.hpp"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+SkinnedMeshAsset::SkinnedMeshAsset()
+{
+    vertexCount = 0;
+    vertexFormat = VertexFormat::Float;
+    boundsCenter = glm::vec3(0.0f);
+    boundsRadius = 0.0f;
+    vertexArray = 0;
+    texCoordBuffer = 0;
+    indexBuffer = 0;
+}
+
+SkinnedMeshAsset::~SkinnedMeshAsset()
+{
+    releaseBuffers();
+}
+
+bool SkinnedMeshAsset::load(const std::string &path, const std::string &textureDir, TextureLoader &textureLoader,
+                            VertexFormat format)
+{
+    vertexFormat = format;
+
+    // Tenta usar o cache binário; se estiver ausente ou desatualizado, importa o modelo e regrava o cache
+    std::string cachePath = meshCachePath(path);
+    if (loadMeshCache(cachePath, path, submeshes, boneNames, boneInfo, animations) && isTopologicallySorted(boneInfo))
+    {
+        std::cout << "Modelo carregado do cache: " << cachePath << std::endl;
+    }
+    else
+    {
+        if (!importModel(path))
+            return false;
+        if (saveMeshCache(cachePath, path, submeshes, boneNames, boneInfo, animations))
+            std::cout << "Cache de malha gravado: " << cachePath << std::endl;
+    }
+
+    // Agenda as texturas difusas referenciadas pelos submeshes, reaproveitando o cache de texturas.
+    // A decodificação acontece em paralelo e o envio ao OpenGL em TextureLoader::finish().
+    for (auto &sub : submeshes)
+    {
+        sub.textureID = 0;
+        if (sub.texturePath.empty())
+            continue;
+
+        std::string fullTexturePath = textureDir + "/" + sub.texturePath;
+        if (textureMap.find(fullTexturePath) == textureMap.end())
+            textureMap[fullTexturePath] = textureLoader.request(fullTexturePath, false);
+        sub.textureID = textureMap[fullTexturePath];
+    }
+
+    bindLocalPose(boneInfo.data(), boneInfo.size(), bindPose);
+    prepareSkinning();
+    prepareMeshlets();
+    prepareOccluder();
+    return createBuffers();
+}
+
+bool SkinnedMeshAsset::createBuffers()
+{
+    releaseBuffers();
+    if (!GLEW_VERSION_3_2 && !(GLEW_ARB_vertex_array_object && GLEW_ARB_draw_elements_base_vertex))
+    {
+        std::cerr << "OpenGL 3.2 (VAO e glDrawElementsBaseVertex) não suportado" << std::endl;
+        return false;
+    }
+
+    // Concatena UVs e índices de todos os submeshes; cada submesh guarda onde seus dados começam.
+    // No formato quantizado as UVs são enviadas em half float
+    bool quantized = vertexFormat == VertexFormat::Quantized;
+    std::vector<float> texCoords;
+    std::vector<uint16_t> halfTexCoords;
+    std::vector<unsigned char> indices;
+    GLint baseVertex = 0;
+    for (auto &sub : submeshes)
+    {
+        sub.baseVertex = baseVertex;
+        for (const auto &vert : sub.vertices)
+        {
+            if (quantized)
+            {
+                halfTexCoords.push_back(floatToHalf(vert.u));
+                halfTexCoords.push_back(floatToHalf(vert.v));
+            }
+            else
+            {
+                texCoords.push_back(vert.u);
+                texCoords.push_back(vert.v);
+            }
+        }
+        baseVertex += sub.vertices.size();
+
+        // Índices de 32 bits precisam começar em um endereço múltiplo de 4
+        indices.resize((indices.size() + 3) & ~size_t(3));
+        sub.indexByteOffset = indices.size();
+        const unsigned char *data = static_cast<const unsigned char *>(sub.indexData());
+        size_t size = sub.indexCount() * (sub.indexType() == GL_UNSIGNED_INT ? 4 : 2);
+        indices.insert(indices.end(), data, data + size);
+    }
+
+    glGenVertexArrays(1, &vertexArray);
+    glBindVertexArray(vertexArray);
+
+    // Dados estáticos: enviados uma única vez
+    glGenBuffers(1, &texCoordBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, texCoordBuffer);
+    GLenum texCoordType = quantized ? GL_HALF_FLOAT : GL_FLOAT;
+    if (quantized)
+        glBufferData(GL_ARRAY_BUFFER, halfTexCoords.size() * sizeof(uint16_t), halfTexCoords.data(), GL_STATIC_DRAW);
+    else
+        glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(float), texCoords.data(), GL_STATIC_DRAW);
+    glTexCoordPointer(2, texCoordType, 0, nullptr);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
+
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size(), indices.data(), GL_STATIC_DRAW);
+
+    // O buffer de índices fica associado ao VAO, por isso só é desvinculado depois dele
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    std::cout << "Buffers estáticos criados (" << vertexCount << " vértices)" << std::endl;
+
+    // O skinning na GPU é opcional: sem suporte os personagens continuam com o skinning na CPU
+    if (GpuSkinning::isSupported() && !gpuSkinning.create(skinningStreams, texCoordBuffer, texCoordType, indexBuffer))
+        std::cerr << "Skinning na GPU indisponível, usando a CPU" << std::endl;
+    return true;
+}
+
+void SkinnedMeshAsset::releaseBuffers()
+{
+    gpuSkinning.destroy();
+    if (indexBuffer)
+        glDeleteBuffers(1, &indexBuffer);
+    if (texCoordBuffer)
+        glDeleteBuffers(1, &texCoordBuffer);
+    if (vertexArray)
+        glDeleteVertexArrays(1, &vertexArray);
+    vertexArray = texCoordBuffer = indexBuffer = 0;
+}
+
+void SkinnedMeshAsset::prepareSkinning()
+{
+    // A identidade fica logo após o último bone na paleta; as influências usam o formato mais compacto
+    // capaz de indexá-la, o mesmo em todos os submeshes
+    InfluenceFormat format = selectInfluenceFormat(boneInfo.size());
+    skinningStreams.resize(submeshes.size());
+    for (size_t i = 0; i < submeshes.size(); i++)
+        buildSkinningStreams(submeshes[i].vertices.data(), submeshes[i].vertices.size(), boneInfo.size(), format,
+                             vertexFormat, skinningStreams[i]);
+
+    // Índice reverso: para cada bone, os intervalos de vértices que ele influencia diretamente.
+    // Os vértices são percorridos em ordem, então basta estender o último intervalo de cada bone
+    boneVertexRanges.assign(boneInfo.size(), {});
+    vertexCount = 0;
+    for (const auto &stream : skinningStreams)
+    {
+        for (size_t i = 0; i < stream.size(); i++, vertexCount++)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                int bone = stream.boneID(i, k);
+                if (stream.weight(i, k) == 0.0f || bone >= static_cast<int>(boneInfo.size()))
+                    continue;
+
+                std::vector<VertexRange> &ranges = boneVertexRanges[bone];
+                if (!ranges.empty() && ranges.back().end == vertexCount)
+                    ranges.back().end++;
+                else if (ranges.empty() || ranges.back().end < vertexCount)
+                    ranges.push_back(VertexRange{vertexCount, vertexCount + 1});
+            }
+        }
+    }
+
+    // Caixas de cada matriz por submesh, transformadas pela paleta a cada pose para descartar os submeshes
+    // fora do frustum, e as mesmas caixas unidas entre os submeshes, para a caixa do personagem inteiro
+    boneBounds.clear();
+    boneBoundsStarts.clear();
+    for (const auto &stream : skinningStreams)
+    {
+        boneBoundsStarts.push_back(boneBounds.size());
+        buildBoneBounds(stream, boneInfo.size() + 1, boneBounds);
+    }
+    boneBoundsStarts.push_back(boneBounds.size());
+    std::vector<int> modelBox(boneInfo.size() + 1, -1);
+    modelBoneBounds.clear();
+    for (const auto &box : boneBounds)
+    {
+        if (modelBox[box.matrix] < 0)
+        {
+            modelBox[box.matrix] = static_cast<int>(modelBoneBounds.size());
+            modelBoneBounds.push_back(box);
+            continue;
+        }
+        BoneBounds &merged = modelBoneBounds[modelBox[box.matrix]];
+        merged.minimum = glm::min(merged.minimum, box.minimum);
+        merged.maximum = glm::max(merged.maximum, box.maximum);
+    }
+
+    // Esfera envolvente da bind pose, usada para estimar o tamanho do personagem na tela
+    glm::vec3 minimum(0.0f), maximum(0.0f);
+    bool first = true;
+    for (const auto &sub : submeshes)
+    {
+        for (const auto &vert : sub.vertices)
+        {
+            glm::vec3 position(vert.x, vert.y, vert.z);
+            minimum = first ? position : glm::min(minimum, position);
+            maximum = first ? position : glm::max(maximum, position);
+            first = false;
+        }
+    }
+    boundsCenter = (minimum + maximum) * 0.5f;
+    boundsRadius = glm::length(maximum - minimum) * 0.5f;
+
+    // Memória estática de cada submesh: posições e influências dos streams mais as UVs
+    size_t texCoordBytes = vertexFormat == VertexFormat::Quantized ? 4 : 8;
+    for (size_t i = 0; i < skinningStreams.size(); i++)
+    {
+        const SkinningStreams &stream = skinningStreams[i];
+        std::cout << "Submesh " << i << ": " << stream.size() << " vértices, "
+                  << stream.size() * (stream.vertexBytes() + texCoordBytes) << " bytes ("
+                  << (vertexFormat == VertexFormat::Quantized ? "quantizado" : "float") << ")" << std::endl;
+    }
+}
+
+void SkinnedMeshAsset::prepareMeshlets()
+{
+    // Meshlets agrupados por LOD e, dentro de cada LOD, por submesh. Um submesh com menos níveis repete o
+    // seu LOD mais simples, para que os meshlets de cada LOD fiquem contíguos e sejam ajustados de uma vez
+    meshlets.clear();
+    meshletVertices.clear();
+    meshletTriangles.clear();
+    meshletStarts.clear();
+    std::vector<std::vector<uint32_t>> indices(submeshes.size());
+    for (size_t i = 0; i < submeshes.size(); i++)
+        indices[i] = submeshes[i].getIndices();
+    for (int lod = 0; lod < MAX_LOD_COUNT; lod++)
+    {
+        uint32_t baseVertex = 0;
+        for (size_t i = 0; i < submeshes.size(); i++)
+        {
+            const SubMesh &sub = submeshes[i];
+            size_t subLod = std::min<size_t>(lod, sub.lodCount() - 1);
+            size_t begin = sub.lodIndexOffset(subLod);
+            meshletStarts.push_back(meshlets.size());
+            buildMeshlets(indices[i], begin, begin + sub.lodIndexCount(subLod), baseVertex, sub.vertices.size(),
+                          meshlets, meshletVertices, meshletTriangles);
+            baseVertex += sub.vertices.size();
+        }
+    }
+    meshletStarts.push_back(meshlets.size());
+
+    size_t begin, end, lodVertexCount = 0, triangleCount = 0;
+    getLodMeshlets(0, begin, end);
+    for (size_t m = begin; m < end; m++)
+    {
+        lodVertexCount += meshlets[m].vertexCount;
+        triangleCount += meshlets[m].triangleCount;
+    }
+    if (end > begin)
+        std::cout << "Meshlets: " << end - begin << " no LOD 0 (média de " << lodVertexCount / (end - begin)
+                  << " vértices e " << triangleCount / (end - begin) << " triângulos)" << std::endl;
+}
+
+void SkinnedMeshAsset::prepareOccluder()
+{
+    // Só os vértices referenciados pelo LOD mais simples entram na malha, renumerados na ordem de uso; as
+    // posições ficam em float, pois a malha só é transformada na CPU
+    std::vector<Vertex> vertices;
+    occluderIndices.clear();
+    for (const auto &sub : submeshes)
+    {
+        std::vector<uint32_t> indices = sub.getIndices();
+        std::vector<int> remap(sub.vertices.size(), -1);
+        size_t begin = sub.lodIndexOffset(sub.lodCount() - 1);
+        size_t end = begin + sub.lodIndexCount(sub.lodCount() - 1);
+        for (size_t i = begin; i < end; i++)
+        {
+            uint32_t vertex = indices[i];
+            if (remap[vertex] < 0)
+            {
+                remap[vertex] = static_cast<int>(vertices.size());
+                vertices.push_back(sub.vertices[vertex]);
+            }
+            occluderIndices.push_back(remap[vertex]);
+        }
+    }
+
+    // Cada vértice é puxado para o centro da caixa, na bind pose, dos vértices do mesmo bone dominante; a
+    // malha encolhida fica dentro do corpo e se move com ele, então não descarta o que a malha real mostra
+    size_t groupCount = boneInfo.size() + 1;
+    auto dominantBone = [&](const Vertex &vertex)
+    {
+        int bone = static_cast<int>(boneInfo.size());
+        float weight = 0.0f;
+        for (int k = 0; k < 4; k++)
+        {
+            if (vertex.weights[k] > weight)
+            {
+                weight = vertex.weights[k];
+                bone = vertex.boneIDs[k];
+            }
+        }
+        return bone;
+    };
+    std::vector<glm::vec3> minimum(groupCount, glm::vec3(0.0f)), maximum(groupCount, glm::vec3(0.0f));
+    std::vector<char> used(groupCount, 0);
+    for (const auto &sub : submeshes)
+    {
+        for (const Vertex &vertex : sub.vertices)
+        {
+            int bone = dominantBone(vertex);
+            glm::vec3 position(vertex.x, vertex.y, vertex.z);
+            minimum[bone] = used[bone] ? glm::min(minimum[bone], position) : position;
+            maximum[bone] = used[bone] ? glm::max(maximum[bone], position) : position;
+            used[bone] = 1;
+        }
+    }
+    for (Vertex &vertex : vertices)
+    {
+        int bone = dominantBone(vertex);
+        glm::vec3 center = (minimum[bone] + maximum[bone]) * 0.5f;
+        glm::vec3 position = center + (glm::vec3(vertex.x, vertex.y, vertex.z) - center) * OCCLUDER_SHRINK;
+        vertex.x = position.x;
+        vertex.y = position.y;
+        vertex.z = position.z;
+    }
+    buildSkinningStreams(vertices.data(), vertices.size(), boneInfo.size(), selectInfluenceFormat(boneInfo.size()),
+                         VertexFormat::Float, occluderStreams);
+    std::cout << "Oclusor: " << vertices.size() << " vértices e " << occluderIndices.size() / 3 << " triângulos"
+              << std::endl;
+}
+
+bool SkinnedMeshAsset::importModel(const std::string &path)
+{
+    // Carrega a cena do modelo utilizando Assimp com triangulação e ajuste de UVs
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+    {
+        std::cerr << "Erro ao carregar modelo: " << importer.GetErrorString() << std::endl;
+        return false;
+    }
+
+    // Limpa os dados anteriores
+    submeshes.clear();
+    boneNames.clear();
+    boneInfo.clear();
+    animations.clear();
+
+    // Processa cada mesh presente na cena
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+    {
+        aiMesh *mesh = scene->mMeshes[i];
+        aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
+        aiString texturePath;
+
+        // Inicializa o submesh guardando o caminho da textura difusa, que é carregada depois
+        SubMesh submesh;
+        submesh.textureID = 0;
+        submesh.baseVertex = 0;
+        submesh.indexByteOffset = 0;
+        if (material->GetTexture(aiTextureType_DIFFUSE, 0, &texturePath) == AI_SUCCESS)
+            submesh.texturePath = texturePath.C_Str();
+
+        // Processa os vértices do mesh, ainda um por canto de triângulo
+        std::vector<Vertex> corners;
+        corners.reserve(mesh->mNumVertices);
+        for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+        {
+            Vertex vert;
+            vert.x = mesh->mVertices[v].x;
+            vert.y = mesh->mVertices[v].y;
+            vert.z = mesh->mVertices[v].z;
+
+            // Verifica se há coordenadas de textura; caso contrário, define como zero
+            if (mesh->mTextureCoords[0])
+            {
+                vert.u = mesh->mTextureCoords[0][v].x;
+                vert.v = mesh->mTextureCoords[0][v].y;
+            }
+            else
+            {
+                vert.u = vert.v = 0.0f;
+            }
+
+            // Inicializa os dados de skinning (bones) para o vértice
+            for (int j = 0; j < 4; j++)
+            {
+                vert.boneIDs[j] = 0;
+                vert.weights[j] = 0.0f;
+            }
+            corners.push_back(vert);
+        }
+
+        // Se o mesh contiver bones, processa os dados de cada bone
+        if (mesh->HasBones())
+        {
+            // Primeira passada: registra os bones e conta as influências de cada vértice
+            std::vector<int> meshBoneIndices(mesh->mNumBones);
+            std::vector<uint32_t> influenceOffsets(mesh->mNumVertices + 1, 0);
+            for (unsigned int b = 0; b < mesh->mNumBones; b++)
+            {
+                aiBone *bone = mesh->mBones[b];
+
+                // Registra o nome; um bone novo recebe o próximo índice e suas informações iniciais
+                int boneIndex = boneNames.insert(std::string_view(bone->mName.C_Str(), bone->mName.length));
+                if (boneIndex == static_cast<int>(boneInfo.size()))
+                {
+                    BoneInfo info;
+                    info.offsetMatrix = bone->mOffsetMatrix;
+                    info.defaultLocalTransform = aiMatrix4x4(); // identidade por padrão
+                    info.localTransform = aiMatrix4x4();        // identidade
+                    info.finalTransformation = aiMatrix4x4();   // identidade
+                    info.parentIndex = -1;
+                    boneInfo.push_back(info);
+                }
+                meshBoneIndices[b] = boneIndex;
+
+                for (unsigned int w = 0; w < bone->mNumWeights; w++)
+                    influenceOffsets[bone->mWeights[w].mVertexId + 1]++;
+            }
+
+            // Segunda passada: reúne todas as influências de cada vértice em um array contíguo
+            for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+                influenceOffsets[v + 1] += influenceOffsets[v];
+            std::vector<BoneInfluence> influences(influenceOffsets.back());
+            std::vector<uint32_t> cursor(influenceOffsets.begin(), influenceOffsets.end() - 1);
+            for (unsigned int b = 0; b < mesh->mNumBones; b++)
+            {
+                const aiBone *bone = mesh->mBones[b];
+                for (unsigned int w = 0; w < bone->mNumWeights; w++)
+                {
+                    const aiVertexWeight &weight = bone->mWeights[w];
+                    influences[cursor[weight.mVertexId]++] = BoneInfluence{meshBoneIndices[b], weight.mWeight};
+                }
+            }
+
+            // Mantém as influências mais fortes de cada vértice, com os pesos renormalizados
+            size_t droppedInfluences = 0;
+            for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+            {
+                droppedInfluences += selectInfluences(influences.data() + influenceOffsets[v],
+                                                      influenceOffsets[v + 1] - influenceOffsets[v], corners[v]);
+            }
+            if (droppedInfluences > 0)
+                std::cout << "Submesh " << i << ": " << droppedInfluences << " influências além de "
+                          << MAX_BONE_INFLUENCES << " por vértice descartadas" << std::endl;
+        }
+
+        // Coleta os cantos dos triângulos (faces que não são triângulos, como pontos e linhas, são ignoradas)
+        std::vector<uint32_t> cornerIndices;
+        cornerIndices.reserve(mesh->mNumFaces * 3);
+        for (unsigned int f = 0; f < mesh->mNumFaces; f++)
+        {
+            const aiFace &face = mesh->mFaces[f];
+            if (face.mNumIndices == 3)
+                cornerIndices.insert(cornerIndices.end(), face.mIndices, face.mIndices + 3);
+        }
+
+        // Solda os vértices idênticos, gerando a malha indexada
+        weldVertices(corners, cornerIndices, submesh);
+        std::cout << "Submesh " << i << ": " << corners.size() << " vértices, " << submesh.vertices.size()
+                  << " únicos, " << submesh.indexCount() / 3 << " triângulos" << std::endl;
+
+        // Ordena os triângulos para a cache de vértices transformados e os vértices na ordem de leitura
+        VertexCacheStats before = analyzeVertexCache(submesh);
+        optimizeVertexCache(submesh);
+        optimizeVertexFetch(submesh);
+        VertexCacheStats after = analyzeVertexCache(submesh);
+        std::cout << "Submesh " << i << ": ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr
+                  << " -> " << after.atvr << std::endl;
+
+        // Adiciona o submesh processado à lista de submeshes
+        submeshes.push_back(submesh);
+    }
+
+    // Após processar os meshes, percorre a hierarquia de nós para definir as transformações locais (bind pose) e
+    // estabelecer o relacionamento pai-filho dos bones.
+    readHierarchy(scene->mRootNode, aiMatrix4x4(), -1);
+
+    // Armazena os bones em pré-ordem (pais antes dos filhos), renumerando o mapeamento e os vértices
+    std::vector<int> remap = sortBonesTopologically(boneInfo);
+    boneNames.renumber(remap);
+    for (auto &sub : submeshes)
+    {
+        for (auto &vert : sub.vertices)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                if (vert.weights[k] > 0.0f)
+                    vert.boneIDs[k] = remap[vert.boneIDs[k]];
+            }
+        }
+
+        // Agrupa os vértices pelo bone dominante para que cada bone corresponda a poucos intervalos contíguos
+        sortVerticesByBone(sub, boneInfo.size());
+    }
+
+    // Importa as animações já com a numeração final dos bones e as compacta dentro das tolerâncias padrão
+    for (unsigned int i = 0; i < scene->mNumAnimations; i++)
+    {
+        AnimationClip clip;
+        size_t skipped = importAnimationClip(scene->mAnimations[i], boneNames, clip);
+        CompressedAnimationClip compressed;
+        compressAnimationClip(clip, DEFAULT_ANIMATION_COMPRESSION, compressed);
+        size_t rawKeys = clip.positionKeys.size() + clip.rotationKeys.size() + clip.scaleKeys.size();
+        size_t keptKeys = compressed.positionTimes.size() + compressed.rotationTimes.size() + compressed.scaleTimes.size();
+        std::cout << "Animação " << i << " (" << clip.name << "): " << clip.duration << " s, " << clip.tracks.size()
+                  << " bones, " << rawKeys << " -> " << keptKeys << " chaves, " << clip.memoryBytes() / 1024 << " -> "
+                  << compressed.memoryBytes() / 1024 << " KB";
+        if (skipped > 0)
+            std::cout << ", " << skipped << " canais de nós sem bone ignorados";
+        std::cout << std::endl;
+        animations.push_back(std::move(compressed));
+    }
+
+    // Gera os LODs sobre os vértices finais; os níveis mais simples reaproveitam os mesmos vértices
+    auto lodStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < submeshes.size(); i++)
+    {
+        buildLodChain(submeshes[i], MAX_LOD_COUNT);
+        std::cout << "Submesh " << i << ": LODs com";
+        for (size_t lod = 0; lod < submeshes[i].lodCount(); lod++)
+            std::cout << (lod == 0 ? " " : " / ") << submeshes[i].lodIndexCount(lod) / 3;
+        std::cout << " triângulos" << std::endl;
+    }
+    std::chrono::duration<double, std::milli> lodTime = std::chrono::steady_clock::now() - lodStart;
+    std::cout << "LODs gerados em " << lodTime.count() << " ms" << std::endl;
+
+    return true;
+}
+
+// ----- Funções auxiliares para hierarquia de bones -----
+
+void SkinnedMeshAsset::readHierarchy(const aiNode *node, const aiMatrix4x4 &parentTransform, int parentBoneIndex)
+{
+    // Calcula a transformação acumulada atual multiplicando a transformação do pai com a transformação do nó atual
+    aiMatrix4x4 currentTransform = parentTransform * node->mTransformation;
+    int currentBoneIndex = parentBoneIndex;
+    int nodeBoneIndex = boneNames.find(std::string_view(node->mName.C_Str(), node->mName.length));
+
+    // Se o nó corresponde a um bone, atualiza o índice do bone e salva a transformação local (bind pose)
+    if (nodeBoneIndex >= 0)
+    {
+        currentBoneIndex = nodeBoneIndex;
+        boneInfo[currentBoneIndex].parentIndex = parentBoneIndex;
+        boneInfo[currentBoneIndex].defaultLocalTransform = node->mTransformation;
+        boneInfo[currentBoneIndex].localTransform = node->mTransformation;
+    }
+
+    // Processa recursivamente os nós filhos
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+        readHierarchy(node->mChildren[i], currentTransform, currentBoneIndex);
+}
+
+BoneHandle SkinnedMeshAsset::findBone(std::string_view boneName) const
+{
+    return BoneHandle(boneNames.find(boneName));
+}
+
+BoneHandle SkinnedMeshAsset::findBone(uint32_t hash, std::string_view boneName) const
+{
+    return BoneHandle(boneNames.find(hash, boneName));
+}
+
+int SkinnedMeshAsset::getAnimationCount() const
+{
+    return animations.size();
+}
+
+const CompressedAnimationClip &SkinnedMeshAsset::getAnimation(int index) const
+{
+    return animations[index];
+}
+
+int SkinnedMeshAsset::findAnimation(std::string_view name) const
+{
+    for (size_t i = 0; i < animations.size(); i++)
+    {
+        if (animations[i].name == name)
+            return i;
+    }
+    return -1;
+}
+
+const std::vector<SubMesh> &SkinnedMeshAsset::getSubmeshes() const
+{
+    return submeshes;
+}
+
+const std::vector<BoneInfo> &SkinnedMeshAsset::getBoneInfo() const
+{
+    return boneInfo;
+}
+
+const BoneNameTable &SkinnedMeshAsset::getBoneNames() const
+{
+    return boneNames;
+}
+
+const LocalPose &SkinnedMeshAsset::getBindPose() const
+{
+    return bindPose;
+}
+
+const std::vector<SkinningStreams> &SkinnedMeshAsset::getSkinningStreams() const
+{
+    return skinningStreams;
+}
+
+const std::vector<std::vector<VertexRange>> &SkinnedMeshAsset::getBoneVertexRanges() const
+{
+    return boneVertexRanges;
+}
+
+const std::vector<BoneBounds> &SkinnedMeshAsset::getBoneBounds() const
+{
+    return boneBounds;
+}
+
+void SkinnedMeshAsset::getSubmeshBoneBounds(size_t submesh, size_t &begin, size_t &end) const
+{
+    begin = boneBoundsStarts[submesh];
+    end = boneBoundsStarts[submesh + 1];
+}
+
+const std::vector<BoneBounds> &SkinnedMeshAsset::getModelBoneBounds() const
+{
+    return modelBoneBounds;
+}
+
+size_t SkinnedMeshAsset::getVertexCount() const
+{
+    return vertexCount;
+}
+
+VertexFormat SkinnedMeshAsset::getVertexFormat() const
+{
+    return vertexFormat;
+}
+
+void SkinnedMeshAsset::getBounds(glm::vec3 &center, float &radius) const
+{
+    center = boundsCenter;
+    radius = boundsRadius;
+}
+
+const std::vector<Meshlet> &SkinnedMeshAsset::getMeshlets() const
+{
+    return meshlets;
+}
+
+const std::vector<uint32_t> &SkinnedMeshAsset::getMeshletVertices() const
+{
+    return meshletVertices;
+}
+
+const std::vector<uint8_t> &SkinnedMeshAsset::getMeshletTriangles() const
+{
+    return meshletTriangles;
+}
+
+void SkinnedMeshAsset::getLodMeshlets(int lod, size_t &begin, size_t &end) const
+{
+    begin = meshletStarts[lod * submeshes.size()];
+    end = meshletStarts[(lod + 1) * submeshes.size()];
+}
+
+void SkinnedMeshAsset::getSubmeshMeshlets(int lod, size_t submesh, size_t &begin, size_t &end) const
+{
+    size_t slot = lod * submeshes.size() + submesh;
+    begin = meshletStarts[slot];
+    end = meshletStarts[slot + 1];
+}
+
+const SkinningStreams &SkinnedMeshAsset::getOccluderStreams() const
+{
+    return occluderStreams;
+}
+
+const std::vector<uint32_t> &SkinnedMeshAsset::getOccluderIndices() const
+{
+    return occluderIndices;
+}
+
+int SkinnedMeshAsset::getLodCount() const
+{
+    size_t count = 1;
+    for (const auto &sub : submeshes)
+        count = std::max(count, sub.lodCount());
+    return count;
+}
+
+GLuint SkinnedMeshAsset::getVertexArray() const
+{
+    return vertexArray;
+}
+
+bool SkinnedMeshAsset::hasGpuSkinning() const
+{
+    return gpuSkinning.isReady();
+}
+
+const GpuSkinning &SkinnedMeshAsset::getGpuSkinning() const
+{
+    return gpuSkinning;
+}
@@ -0,0 +1,392 @@
+#ifndef SKINNEDMESHASSET_HPP
+#define SKINNEDMESHASSET_HPP
+
+#include <vector>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <GL/glu.h>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <assimp/matrix4x4.h>
+#include <assimp/vector3.h>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "textureloader.hpp"
+#include "skinning.hpp"
+#include "gpuskinning.hpp"
+#include "bonenametable.hpp"
+#include "meshlet.hpp"
+#include "bounds.hpp"
+#include "animation.hpp"
+
+struct Vertex
+{
+    float x, y, z;    ///< Posição do vértice.
+    float u, v;       ///< Coordenadas de textura.
+    int boneIDs[4];   ///< IDs dos bones que influenciam este vértice (suporta até 4).
+    float weights[4]; ///< Pesos correspondentes a cada bone.
+};
+
+struct SubMesh
+{
+    std::vector<Vertex> vertices;     ///< Lista de vértices únicos (soldados) do submesh.
+    std::vector<uint16_t> indices16;  ///< Índices dos triângulos, usados quando o submesh tem até 65536 vértices.
+    std::vector<uint32_t> indices32;  ///< Índices dos triângulos, usados nos submeshes maiores.
+    std::vector<uint32_t> lodOffsets; ///< Primeiro índice de cada LOD a partir do 1 (vazio se houver só o LOD 0).
+    std::string texturePath;          ///< Caminho da textura difusa relativo ao diretório de texturas (vazio se não houver).
+    GLuint textureID;                 ///< ID da textura associada ao submesh.
+    GLint baseVertex;                 ///< Primeiro vértice do submesh nos buffers de vértices do modelo.
+    size_t indexByteOffset;           ///< Deslocamento em bytes dos índices do submesh no buffer de índices.
+
+    /**
+     * @brief Quantidade de índices (3 por triângulo) do submesh.
+     */
+    size_t indexCount() const { return indices16.empty() ? indices32.size() : indices16.size(); }
+
+    /**
+     * @brief Quantidade de níveis de detalhe; todos compartilham os vértices e ficam concatenados nos índices.
+     */
+    size_t lodCount() const { return lodOffsets.size() + 1; }
+
+    /**
+     * @brief Primeiro índice de um LOD.
+     */
+    size_t lodIndexOffset(size_t lod) const { return lod == 0 ? 0 : lodOffsets[lod - 1]; }
+
+    /**
+     * @brief Quantidade de índices de um LOD.
+     */
+    size_t lodIndexCount(size_t lod) const
+    {
+        return (lod + 1 < lodCount() ? lodOffsets[lod] : indexCount()) - lodIndexOffset(lod);
+    }
+
+    /**
+     * @brief Tipo OpenGL dos índices armazenados (GL_UNSIGNED_SHORT ou GL_UNSIGNED_INT).
+     */
+    GLenum indexType() const { return indices32.empty() ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT; }
+
+    /**
+     * @brief Ponteiro para os índices armazenados, no tipo informado por indexType().
+     */
+    const void *indexData() const { return indices32.empty() ? static_cast<const void *>(indices16.data()) : indices32.data(); }
+
+    /**
+     * @brief Retorna os índices convertidos para 32 bits, para processamento na importação.
+     */
+    std::vector<uint32_t> getIndices() const
+    {
+        if (!indices32.empty())
+            return indices32;
+        return std::vector<uint32_t>(indices16.begin(), indices16.end());
+    }
+
+    /**
+     * @brief Armazena os índices no menor tipo capaz de endereçar todos os vértices do submesh.
+     * @param indices Índices dos triângulos em 32 bits.
+     */
+    void setIndices(const std::vector<uint32_t> &indices)
+    {
+        indices16.clear();
+        indices32.clear();
+        if (vertices.size() <= 65536)
+            indices16.assign(indices.begin(), indices.end());
+        else
+            indices32 = indices;
+    }
+};
+
+struct BoneInfo
+{
+    aiMatrix4x4 offsetMatrix;          ///< Matriz de transformação do bone para a pose inicial.
+    aiMatrix4x4 defaultLocalTransform; ///< Transformação local do bone na bind pose.
+    aiMatrix4x4 localTransform;        ///< Transformação local atual, montada a partir da pose avaliada.
+    aiMatrix4x4 finalTransformation;   ///< Transformação final aplicada aos vértices.
+    int parentIndex;                   ///< Índice do bone pai (-1 se for raiz).
+};
+
+/**
+ * @brief Referência a um bone resolvida uma única vez por SkinnedMeshAsset::findBone().
+ *
+ * Evita buscas por nome a cada quadro. Vale para todos os personagens que usam o mesmo asset.
+ */
+struct BoneHandle
+{
+    int index;                                              ///< Índice do bone (-1 se inválido).
+
+    BoneHandle() : index(-1) {}
+    explicit BoneHandle(int boneIndex) : index(boneIndex) {}
+
+    /**
+     * @brief Informa se o handle se refere a um bone existente.
+     */
+    bool isValid() const { return index >= 0; }
+};
+
+/**
+ * @brief Dados de um modelo com skinning compartilhados por todos os personagens que o usam.
+ *
+ * Malha, texturas, bones da bind pose, clips de animação, streams de skinning, meshlets e os buffers
+ * estáticos do OpenGL. Depois de load() o asset não muda mais: é compartilhado por
+ * std::shared_ptr<const SkinnedMeshAsset> e pode ser lido por várias threads ao mesmo tempo, enquanto
+ * a pose e o resultado do skinning ficam em cada CharacterInstance.
+ */
+class SkinnedMeshAsset
+{
+private:
+    std::vector<SubMesh> submeshes;                         ///< Lista de submeshes do modelo.
+    std::map<std::string, GLuint> textureMap;               ///< Cache de texturas carregadas.
+    BoneNameTable boneNames;                                ///< Mapeia o nome do bone para seu índice.
+    std::vector<BoneInfo> boneInfo;                         ///< Bones na bind pose (localTransform = defaultLocalTransform).
+    std::vector<CompressedAnimationClip> animations;        ///< Clips de animação do modelo, compactados na importação.
+    LocalPose bindPose;                                     ///< Pose local da bind pose.
+    std::vector<SkinningStreams> skinningStreams;           ///< Dados de skinning em SoA, um por submesh.
+    std::vector<std::vector<VertexRange>> boneVertexRanges; ///< Intervalos de vértices influenciados diretamente por cada bone.
+    std::vector<BoneBounds> boneBounds;                     ///< Caixas de cada matriz que influencia cada submesh.
+    std::vector<size_t> boneBoundsStarts;                   ///< Primeira caixa de cada submesh em boneBounds.
+    std::vector<BoneBounds> modelBoneBounds;                ///< Caixas de cada matriz em todos os submeshes.
+    size_t vertexCount;                                     ///< Quantidade de vértices de todos os submeshes.
+    VertexFormat vertexFormat;                              ///< Formato das posições e UVs dos buffers.
+    glm::vec3 boundsCenter;                                 ///< Centro da esfera envolvente da bind pose.
+    float boundsRadius;                                     ///< Raio da esfera envolvente da bind pose.
+    std::vector<Meshlet> meshlets;                          ///< Meshlets de todos os LODs e submeshes.
+    std::vector<uint32_t> meshletVertices;                  ///< Vértices de cada meshlet, na numeração global das posições.
+    std::vector<uint8_t> meshletTriangles;                  ///< Triângulos de cada meshlet, em índices locais.
+    std::vector<size_t> meshletStarts;                      ///< Primeiro meshlet de cada LOD e submesh (lod * submeshes + i).
+    SkinningStreams occluderStreams;                        ///< Vértices do LOD mais simples de todos os submeshes.
+    std::vector<uint32_t> occluderIndices;                  ///< Triângulos do LOD mais simples, nos vértices de occluderStreams.
+    GLuint vertexArray;                                     ///< VAO com as UVs e o buffer de índices (skinning na CPU).
+    GLuint texCoordBuffer;                                  ///< VBO estático com as coordenadas de textura.
+    GLuint indexBuffer;                                     ///< Buffer de índices de todos os submeshes.
+    GpuSkinning gpuSkinning;                                ///< Programa e atributos do skinning no vertex shader.
+
+public:
+    /**
+     * @brief Construtor, cria um asset vazio.
+     */
+    SkinnedMeshAsset();
+
+    /**
+     * @brief Destrutor, libera os buffers OpenGL do modelo.
+     */
+    ~SkinnedMeshAsset();
+
+    SkinnedMeshAsset(const SkinnedMeshAsset &) = delete;
+    SkinnedMeshAsset &operator=(const SkinnedMeshAsset &) = delete;
+
+    /**
+     * @brief Carrega um modelo 3D e suas texturas associadas, além de dados de bones.
+     *
+     * Na primeira carga o modelo é importado pelo Assimp e um cache binário é gravado ao lado do arquivo
+     * original. Nas cargas seguintes o cache é usado diretamente, enquanto o modelo não for alterado.
+     *
+     * As texturas são apenas agendadas no textureLoader; ficam disponíveis após TextureLoader::finish().
+     *
+     * @param path Caminho do modelo 3D.
+     * @param textureDir Diretório onde as texturas estão armazenadas.
+     * @param textureLoader Carregador responsável por decodificar as texturas em paralelo.
+     * @param format Formato das posições e UVs enviadas aos kernels de skinning e ao OpenGL.
+     * @return true se o modelo for carregado com sucesso, false caso contrário.
+     */
+    bool load(const std::string &path, const std::string &textureDir, TextureLoader &textureLoader,
+              VertexFormat format = VertexFormat::Float);
+
+    /**
+     * @brief Procura um bone pelo nome.
+     * @param boneName Nome do bone.
+     * @return Handle do bone, inválido se não existir.
+     */
+    BoneHandle findBone(std::string_view boneName) const;
+
+    /**
+     * @brief Procura um bone pelo nome com o hash já calculado por boneNameHash() (ex.: em tempo de compilação).
+     * @param hash Hash do nome.
+     * @param boneName Nome do bone.
+     * @return Handle do bone, inválido se não existir.
+     */
+    BoneHandle findBone(uint32_t hash, std::string_view boneName) const;
+
+    /**
+     * @brief Retorna a quantidade de clips de animação do modelo.
+     */
+    int getAnimationCount() const;
+
+    /**
+     * @brief Retorna um clip de animação.
+     * @param index Índice do clip, entre 0 e getAnimationCount() - 1.
+     */
+    const CompressedAnimationClip &getAnimation(int index) const;
+
+    /**
+     * @brief Procura um clip de animação pelo nome.
+     * @return Índice do clip, ou -1 se não existir.
+     */
+    int findAnimation(std::string_view name) const;
+
+    /**
+     * @brief Retorna os submeshes carregados.
+     */
+    const std::vector<SubMesh> &getSubmeshes() const;
+
+    /**
+     * @brief Retorna os bones na bind pose.
+     */
+    const std::vector<BoneInfo> &getBoneInfo() const;
+
+    /**
+     * @brief Retorna a tabela com o nome de cada bone.
+     */
+    const BoneNameTable &getBoneNames() const;
+
+    /**
+     * @brief Retorna a pose local da bind pose, sobre a qual os clips são amostrados.
+     */
+    const LocalPose &getBindPose() const;
+
+    /**
+     * @brief Retorna os streams de skinning de cada submesh.
+     */
+    const std::vector<SkinningStreams> &getSkinningStreams() const;
+
+    /**
+     * @brief Retorna os intervalos de vértices influenciados diretamente por cada bone.
+     */
+    const std::vector<std::vector<VertexRange>> &getBoneVertexRanges() const;
+
+    /**
+     * @brief Retorna as caixas da bind pose de cada matriz da paleta, agrupadas por submesh.
+     */
+    const std::vector<BoneBounds> &getBoneBounds() const;
+
+    /**
+     * @brief Retorna o intervalo [begin, end) de getBoneBounds() com as caixas de um submesh.
+     */
+    void getSubmeshBoneBounds(size_t submesh, size_t &begin, size_t &end) const;
+
+    /**
+     * @brief Retorna as caixas da bind pose de cada matriz da paleta, unidas entre todos os submeshes.
+     */
+    const std::vector<BoneBounds> &getModelBoneBounds() const;
+
+    /**
+     * @brief Retorna a quantidade de vértices de todos os submeshes.
+     */
+    size_t getVertexCount() const;
+
+    /**
+     * @brief Retorna o formato de vértices escolhido em load().
+     */
+    VertexFormat getVertexFormat() const;
+
+    /**
+     * @brief Retorna a esfera envolvente da bind pose.
+     */
+    void getBounds(glm::vec3 &center, float &radius) const;
+
+    /**
+     * @brief Retorna os meshlets de todos os LODs e submeshes.
+     */
+    const std::vector<Meshlet> &getMeshlets() const;
+
+    /**
+     * @brief Retorna a lista de vértices dos meshlets.
+     */
+    const std::vector<uint32_t> &getMeshletVertices() const;
+
+    /**
+     * @brief Retorna a lista de triângulos dos meshlets, em índices locais.
+     */
+    const std::vector<uint8_t> &getMeshletTriangles() const;
+
+    /**
+     * @brief Retorna o intervalo [begin, end) de getMeshlets() com os meshlets de um LOD.
+     */
+    void getLodMeshlets(int lod, size_t &begin, size_t &end) const;
+
+    /**
+     * @brief Retorna o intervalo [begin, end) de getMeshlets() com os meshlets de um submesh em um LOD.
+     */
+    void getSubmeshMeshlets(int lod, size_t submesh, size_t &begin, size_t &end) const;
+
+    /**
+     * @brief Retorna os streams de skinning da malha usada como oclusor: só os vértices do LOD mais simples
+     * de cada submesh, concatenados e encolhidos em direção aos bones.
+     */
+    const SkinningStreams &getOccluderStreams() const;
+
+    /**
+     * @brief Retorna os triângulos da malha usada como oclusor, nos vértices de getOccluderStreams().
+     */
+    const std::vector<uint32_t> &getOccluderIndices() const;
+
+    /**
+     * @brief Retorna a maior quantidade de LODs entre os submeshes.
+     */
+    int getLodCount() const;
+
+    /**
+     * @brief Retorna o VAO com as UVs e os índices, usado com as posições do skinning na CPU.
+     */
+    GLuint getVertexArray() const;
+
+    /**
+     * @brief Informa se o skinning na GPU está disponível para o modelo.
+     */
+    bool hasGpuSkinning() const;
+
+    /**
+     * @brief Retorna o programa de skinning na GPU, compartilhado por todos os personagens do modelo.
+     *
+     * Só deve ser usado na thread do contexto OpenGL, como os demais recursos OpenGL.
+     */
+    const GpuSkinning &getGpuSkinning() const;
+
+private:
+    /**
+     * @brief Importa o modelo utilizando o Assimp, preenchendo submeshes e bones.
+     * @param path Caminho do modelo 3D.
+     * @return true se o modelo for importado com sucesso, false caso contrário.
+     */
+    bool importModel(const std::string &path);
+
+    /**
+     * @brief Lê a hierarquia de bones do modelo e armazena suas transformações.
+     * @param node Nó da cena do Assimp a ser processado.
+     * @param parentTransform Transformação do nó pai.
+     * @param parentBoneIndex Índice do bone pai (-1 se não houver).
+     */
+    void readHierarchy(const aiNode *node, const aiMatrix4x4 &parentTransform, int parentBoneIndex);
+
+    /**
+     * @brief Converte os vértices de cada submesh para os streams SoA usados pelo kernel de skinning.
+     */
+    void prepareSkinning();
+
+    /**
+     * @brief Divide os índices de cada LOD dos submeshes em meshlets.
+     */
+    void prepareMeshlets();
+
+    /**
+     * @brief Reúne o LOD mais simples de todos os submeshes em uma única malha com skinning, usada como oclusor,
+     * encolhida para dentro do corpo por OCCLUDER_SHRINK.
+     */
+    void prepareOccluder();
+
+    /**
+     * @brief Cria o VAO, envia os dados estáticos (UVs e índices) e os atributos do skinning na GPU.
+     * @return true se os buffers foram criados, false caso contrário.
+     */
+    bool createBuffers();
+
+    /**
+     * @brief Libera os buffers OpenGL do modelo.
+     */
+    void releaseBuffers();
+};
+
+#endif
@@ -0,0 +1,472 @@
+#include "skinning.hpp"
+#include "skinnedmeshasset.hpp"
+#include "threadpool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKINNING_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(SKINNING_HAS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SKINNING_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+
+InfluenceFormat selectInfluenceFormat(size_t boneCount)
+{
+    // A identidade ocupa o índice boneCount da paleta
+    return boneCount < 256 ? InfluenceFormat::Unorm8 : InfluenceFormat::Unorm16;
+}
+
+/**
+ * @brief Quantiza os 4 pesos de um vértice para unorm, com soma exatamente igual a maxValue.
+ *
+ * O arredondamento de cada peso é corrigido no peso de maior valor, para que a matriz combinada
+ * continue sendo uma média ponderada (sem escala residual).
+ *
+ * @return false se o vértice não possuir nenhum peso positivo.
+ */
+static bool quantizeWeights(const float weights[4], uint32_t maxValue, uint32_t quantized[4])
+{
+    float total = 0.0f;
+    int largest = 0;
+    for (int k = 0; k < 4; k++)
+    {
+        total += weights[k] > 0.0f ? weights[k] : 0.0f;
+        if (weights[k] > weights[largest])
+            largest = k;
+    }
+    if (total <= 0.0f)
+        return false;
+
+    int64_t remainder = maxValue;
+    for (int k = 0; k < 4; k++)
+    {
+        float normalized = weights[k] > 0.0f ? weights[k] / total : 0.0f;
+        quantized[k] = static_cast<uint32_t>(normalized * maxValue + 0.5f);
+        remainder -= quantized[k];
+    }
+    quantized[largest] = static_cast<uint32_t>(quantized[largest] + remainder);
+    return true;
+}
+
+/**
+ * @brief Grava as influências de um vértice no formato compactado de T (uint8_t ou uint16_t).
+ */
+template <typename T>
+static void packInfluences(const Vertex &vert, int identityBone, T *dst)
+{
+    uint32_t quantized[4];
+    if (!quantizeWeights(vert.weights, std::numeric_limits<T>::max(), quantized))
+    {
+        // Sem influências o vértice mantém a posição original, através da identidade da paleta
+        dst[0] = static_cast<T>(identityBone);
+        dst[1] = dst[2] = dst[3] = 0;
+        dst[4] = std::numeric_limits<T>::max();
+        dst[5] = dst[6] = dst[7] = 0;
+        return;
+    }
+
+    // Influências sem peso apontam para o bone 0, que é lido mas não contribui
+    for (int k = 0; k < 4; k++)
+    {
+        dst[k] = static_cast<T>(quantized[k] > 0 ? vert.boneIDs[k] : 0);
+        dst[4 + k] = static_cast<T>(quantized[k]);
+    }
+}
+
+void buildSkinningStreams(const Vertex *vertices, size_t count, int identityBone, InfluenceFormat format,
+                          VertexFormat vertexFormat, SkinningStreams &streams)
+{
+    streams.vertexFormat = vertexFormat;
+    streams.influenceFormat = format;
+    streams.influences.resize(count * streams.influenceStride());
+
+    // AABB do submesh, base da quantização das posições
+    float minimum[3] = {0.0f, 0.0f, 0.0f}, maximum[3] = {0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < count; i++)
+    {
+        const float p[3] = {vertices[i].x, vertices[i].y, vertices[i].z};
+        for (int axis = 0; axis < 3; axis++)
+        {
+            minimum[axis] = i == 0 ? p[axis] : std::min(minimum[axis], p[axis]);
+            maximum[axis] = i == 0 ? p[axis] : std::max(maximum[axis], p[axis]);
+        }
+    }
+    for (int axis = 0; axis < 3; axis++)
+    {
+        streams.positionOffset[axis] = vertexFormat == VertexFormat::Quantized ? minimum[axis] : 0.0f;
+        streams.positionScale[axis] = vertexFormat == VertexFormat::Quantized ? (maximum[axis] - minimum[axis]) / 65535.0f : 1.0f;
+    }
+
+    std::vector<float> *floatStreams[3] = {&streams.x, &streams.y, &streams.z};
+    std::vector<uint16_t> *quantizedStreams[3] = {&streams.qx, &streams.qy, &streams.qz};
+    for (int axis = 0; axis < 3; axis++)
+    {
+        floatStreams[axis]->assign(vertexFormat == VertexFormat::Float ? count : 0, 0.0f);
+        quantizedStreams[axis]->assign(vertexFormat == VertexFormat::Quantized ? count : 0, 0);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const Vertex &vert = vertices[i];
+        const float p[3] = {vert.x, vert.y, vert.z};
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (vertexFormat == VertexFormat::Float)
+            {
+                (*floatStreams[axis])[i] = p[axis];
+                continue;
+            }
+            float scale = streams.positionScale[axis];
+            float q = scale > 0.0f ? (p[axis] - streams.positionOffset[axis]) / scale + 0.5f : 0.0f;
+            (*quantizedStreams[axis])[i] = static_cast<uint16_t>(std::min(q, 65535.0f));
+        }
+
+        if (format == InfluenceFormat::Unorm8)
+            packInfluences(vert, identityBone, streams.influences.data() + i * 8);
+        else
+            packInfluences(vert, identityBone, reinterpret_cast<uint16_t *>(streams.influences.data()) + i * 8);
+    }
+}
+
+uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    // NaN e infinito
+    if (((bits >> 23) & 0xff) == 0xff)
+        return static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+
+    // Grande demais: satura em infinito
+    if (exponent >= 31)
+        return static_cast<uint16_t>(sign | 0x7c00);
+
+    // Subnormal (ou zero) em half float
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+            return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t midpoint = 1u << (shift - 1);
+        if (rest > midpoint || (rest == midpoint && (half & 1)))
+            half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // Normal: arredonda os 13 bits descartados (o carry pode incrementar o expoente, o que é correto)
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++;
+    return static_cast<uint16_t>(sign | half);
+}
+
+/**
+ * @brief Armazena uma matriz por colunas: (a1, b1, c1, 0), (a2, b2, c2, 0), (a3, b3, c3, 0), (a4, b4, c4, 0).
+ */
+static inline void storePaletteMatrix(const aiMatrix4x4 &m, float *dst)
+{
+    dst[0] = m.a1;  dst[1] = m.b1;  dst[2] = m.c1;  dst[3] = 0.0f;
+    dst[4] = m.a2;  dst[5] = m.b2;  dst[6] = m.c2;  dst[7] = 0.0f;
+    dst[8] = m.a3;  dst[9] = m.b3;  dst[10] = m.c3; dst[11] = 0.0f;
+    dst[12] = m.a4; dst[13] = m.b4; dst[14] = m.c4; dst[15] = 0.0f;
+}
+
+void buildSkinningPalette(const BoneInfo *bones, size_t count, std::vector<float> &palette)
+{
+    palette.resize((count + 1) * SKINNING_PALETTE_STRIDE);
+    for (size_t i = 0; i < count; i++)
+        storePaletteMatrix(bones[i].finalTransformation, &palette[i * SKINNING_PALETTE_STRIDE]);
+    storePaletteMatrix(aiMatrix4x4(), &palette[count * SKINNING_PALETTE_STRIDE]);
+}
+
+void buildSkinningPalette(const BoneInfo *bones, size_t count, const aiMatrix4x4 &world, float *palette)
+{
+    for (size_t i = 0; i < count; i++)
+        storePaletteMatrix(world * bones[i].finalTransformation, palette + i * SKINNING_PALETTE_STRIDE);
+    storePaletteMatrix(world, palette + count * SKINNING_PALETTE_STRIDE);
+}
+
+SkinningKernel detectSkinningKernel()
+{
+#ifdef SKINNING_HAS_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SkinningKernel::AVX2;
+#endif
+#ifdef SKINNING_HAS_SSE2
+    return SkinningKernel::SSE2;
+#else
+    return SkinningKernel::Scalar;
+#endif
+}
+
+const char *skinningKernelName(SkinningKernel kernel)
+{
+    switch (kernel)
+    {
+    case SkinningKernel::SSE2:
+        return "SSE2";
+    case SkinningKernel::AVX2:
+        return "AVX2";
+    default:
+        return "escalar";
+    }
+}
+
+// ----- Kernels -----
+//
+// Os kernels são instanciados para os dois formatos de influência, T é uint8_t (unorm8) ou uint16_t (unorm16),
+// e para os dois formatos de posição (Quantized).
+
+/**
+ * @brief Posição do vértice i na bind pose; Quantized decodifica as coordenadas de 16 bits.
+ */
+template <bool Quantized>
+static inline void loadPosition(const SkinningStreams &s, size_t i, float &x, float &y, float &z)
+{
+    if constexpr (Quantized)
+    {
+        x = s.positionOffset[0] + s.qx[i] * s.positionScale[0];
+        y = s.positionOffset[1] + s.qy[i] * s.positionScale[1];
+        z = s.positionOffset[2] + s.qz[i] * s.positionScale[2];
+    }
+    else
+    {
+        x = s.x[i];
+        y = s.y[i];
+        z = s.z[i];
+    }
+}
+
+/**
+ * @brief Influências compactadas do vértice i: 4 índices seguidos de 4 pesos.
+ */
+template <typename T>
+static inline const T *influencesOf(const SkinningStreams &s, size_t i)
+{
+    return reinterpret_cast<const T *>(s.influences.data()) + i * 8;
+}
+
+template <typename T, bool Quantized>
+static void skinScalar(const SkinningStreams &s, const float *palette, size_t begin, size_t end, float *out)
+{
+    const float scale = 1.0f / std::numeric_limits<T>::max();
+    for (size_t i = begin; i < end; i++)
+    {
+        // Combina as matrizes das 4 influências e transforma a posição uma única vez
+        const T *inf = influencesOf<T>(s, i);
+        float m[12] = {0.0f};
+        for (int k = 0; k < 4; k++)
+        {
+            const float *bone = palette + inf[k] * SKINNING_PALETTE_STRIDE;
+            float w = inf[4 + k] * scale;
+            for (int c = 0; c < 4; c++)
+            {
+                m[c * 3 + 0] += w * bone[c * 4 + 0];
+                m[c * 3 + 1] += w * bone[c * 4 + 1];
+                m[c * 3 + 2] += w * bone[c * 4 + 2];
+            }
+        }
+
+        float x, y, z;
+        loadPosition<Quantized>(s, i, x, y, z);
+        out[i * 3 + 0] = m[0] * x + m[3] * y + m[6] * z + m[9];
+        out[i * 3 + 1] = m[1] * x + m[4] * y + m[7] * z + m[10];
+        out[i * 3 + 2] = m[2] * x + m[5] * y + m[8] * z + m[11];
+    }
+}
+
+#ifdef SKINNING_HAS_SSE2
+/**
+ * @brief Grava x, y, z de um registrador sem tocar no float seguinte, que pertence a outro vértice.
+ */
+static inline void storeXYZ(float *dst, __m128 v)
+{
+    _mm_storel_pi(reinterpret_cast<__m64 *>(dst), v);
+    _mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+}
+
+template <typename T, bool Quantized>
+static void skinSSE2(const SkinningStreams &s, const float *palette, size_t begin, size_t end, float *out)
+{
+    // Cada registrador guarda uma coluna da matriz 3x4; o SSE2 não possui gather, então os streams SoA
+    // são lidos por vértice e o paralelismo fica nas linhas da matriz
+    const float scale = 1.0f / std::numeric_limits<T>::max();
+    for (size_t i = begin; i < end; i++)
+    {
+        const T *inf = influencesOf<T>(s, i);
+        __m128 c0 = _mm_setzero_ps(), c1 = _mm_setzero_ps(), c2 = _mm_setzero_ps(), c3 = _mm_setzero_ps();
+        for (int k = 0; k < 4; k++)
+        {
+            const float *bone = palette + inf[k] * SKINNING_PALETTE_STRIDE;
+            __m128 w = _mm_set1_ps(inf[4 + k] * scale);
+            c0 = _mm_add_ps(c0, _mm_mul_ps(w, _mm_loadu_ps(bone + 0)));
+            c1 = _mm_add_ps(c1, _mm_mul_ps(w, _mm_loadu_ps(bone + 4)));
+            c2 = _mm_add_ps(c2, _mm_mul_ps(w, _mm_loadu_ps(bone + 8)));
+            c3 = _mm_add_ps(c3, _mm_mul_ps(w, _mm_loadu_ps(bone + 12)));
+        }
+
+        float x, y, z;
+        loadPosition<Quantized>(s, i, x, y, z);
+        __m128 pos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(x)), _mm_mul_ps(c1, _mm_set1_ps(y))),
+                                _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(z)), c3));
+        storeXYZ(out + i * 3, pos);
+    }
+}
+#endif
+
+#ifdef SKINNING_HAS_AVX2
+__attribute__((target("avx2,fma"))) static inline __m256 load2(const float *lo, const float *hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 broadcast2(float lo, float hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(lo)), _mm_set1_ps(hi), 1);
+}
+
+template <typename T, bool Quantized>
+__attribute__((target("avx2,fma"))) static void skinAVX2(const SkinningStreams &s, const float *palette, size_t begin,
+                                                         size_t end, float *out)
+{
+    // Dois vértices por iteração: a metade inferior do registrador é o vértice i e a superior o i + 1
+    const float scale = 1.0f / std::numeric_limits<T>::max();
+    size_t i = begin;
+    for (; i + 1 < end; i += 2)
+    {
+        const T *infA = influencesOf<T>(s, i);
+        const T *infB = influencesOf<T>(s, i + 1);
+        __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps(), c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+        for (int k = 0; k < 4; k++)
+        {
+            const float *boneA = palette + infA[k] * SKINNING_PALETTE_STRIDE;
+            const float *boneB = palette + infB[k] * SKINNING_PALETTE_STRIDE;
+            __m256 w = broadcast2(infA[4 + k] * scale, infB[4 + k] * scale);
+            c0 = _mm256_fmadd_ps(w, load2(boneA + 0, boneB + 0), c0);
+            c1 = _mm256_fmadd_ps(w, load2(boneA + 4, boneB + 4), c1);
+            c2 = _mm256_fmadd_ps(w, load2(boneA + 8, boneB + 8), c2);
+            c3 = _mm256_fmadd_ps(w, load2(boneA + 12, boneB + 12), c3);
+        }
+
+        float xA, yA, zA, xB, yB, zB;
+        loadPosition<Quantized>(s, i, xA, yA, zA);
+        loadPosition<Quantized>(s, i + 1, xB, yB, zB);
+        __m256 pos = _mm256_fmadd_ps(c0, broadcast2(xA, xB),
+                                     _mm256_fmadd_ps(c1, broadcast2(yA, yB), _mm256_fmadd_ps(c2, broadcast2(zA, zB), c3)));
+        storeXYZ(out + i * 3, _mm256_castps256_ps128(pos));
+        storeXYZ(out + i * 3 + 3, _mm256_extractf128_ps(pos, 1));
+    }
+
+    // Vértice restante quando o intervalo é ímpar
+    if (i < end)
+        skinSSE2<T, Quantized>(s, palette, i, end, out);
+}
+#endif
+
+/**
+ * @brief Executa o kernel escolhido para o formato de influência T e de posição Quantized.
+ */
+template <typename T, bool Quantized>
+static void skinWithKernel(const SkinningStreams &streams, const float *palette, size_t begin, size_t end, float *out,
+                           SkinningKernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef SKINNING_HAS_AVX2
+    case SkinningKernel::AVX2:
+        skinAVX2<T, Quantized>(streams, palette, begin, end, out);
+        break;
+#endif
+#ifdef SKINNING_HAS_SSE2
+    case SkinningKernel::SSE2:
+        skinSSE2<T, Quantized>(streams, palette, begin, end, out);
+        break;
+#endif
+    default:
+        skinScalar<T, Quantized>(streams, palette, begin, end, out);
+        break;
+    }
+}
+
+void skinPositions(const SkinningStreams &streams, const float *palette, size_t begin, size_t end, float *out,
+                   SkinningKernel kernel)
+{
+    static const SkinningKernel supported = detectSkinningKernel();
+    if (static_cast<int>(kernel) > static_cast<int>(supported))
+        kernel = supported;
+
+    bool quantized = streams.vertexFormat == VertexFormat::Quantized;
+    if (streams.influenceFormat == InfluenceFormat::Unorm8)
+    {
+        if (quantized)
+            skinWithKernel<uint8_t, true>(streams, palette, begin, end, out, kernel);
+        else
+            skinWithKernel<uint8_t, false>(streams, palette, begin, end, out, kernel);
+    }
+    else
+    {
+        if (quantized)
+            skinWithKernel<uint16_t, true>(streams, palette, begin, end, out, kernel);
+        else
+            skinWithKernel<uint16_t, false>(streams, palette, begin, end, out, kernel);
+    }
+}
+
+void skinAll(ThreadPool *pool, const std::vector<SkinningStreams> &streams, const float *palette, float *out,
+             SkinningKernel kernel)
+{
+    size_t total = 0;
+    for (const auto &stream : streams)
+        total += stream.size();
+    skinRanges(pool, streams, palette, {VertexRange{0, total}}, out, kernel);
+}
+
+void skinRanges(ThreadPool *pool, const std::vector<SkinningStreams> &streams, const float *palette,
+                const std::vector<VertexRange> &ranges, float *out, SkinningKernel kernel)
+{
+    // Primeiro vértice global de cada submesh e posição de cada intervalo no espaço compacto
+    std::vector<size_t> streamBase(streams.size() + 1, 0);
+    for (size_t i = 0; i < streams.size(); i++)
+        streamBase[i + 1] = streamBase[i] + streams[i].size();
+    std::vector<size_t> rangeBase(ranges.size() + 1, 0);
+    for (size_t i = 0; i < ranges.size(); i++)
+        rangeBase[i + 1] = rangeBase[i] + ranges[i].end - ranges[i].begin;
+
+    // Cada tarefa recebe um intervalo do espaço compacto e o converte nos trechos de submesh que ele cobre
+    std::function<void(size_t, size_t)> task = [&](size_t begin, size_t end)
+    {
+        size_t r = std::upper_bound(rangeBase.begin(), rangeBase.end(), begin) - rangeBase.begin() - 1;
+        for (; r < ranges.size() && rangeBase[r] < end; r++)
+        {
+            size_t first = ranges[r].begin + (std::max(begin, rangeBase[r]) - rangeBase[r]);
+            size_t last = ranges[r].begin + (std::min(end, rangeBase[r + 1]) - rangeBase[r]);
+            size_t s = std::upper_bound(streamBase.begin(), streamBase.end(), first) - streamBase.begin() - 1;
+            for (; s < streams.size() && streamBase[s] < last; s++)
+            {
+                size_t from = std::max(first, streamBase[s]), to = std::min(last, streamBase[s + 1]);
+                if (from < to)
+                    skinPositions(streams[s], palette, from - streamBase[s], to - streamBase[s],
+                                  out + streamBase[s] * 3, kernel);
+            }
+        }
+    };
+
+    if (pool)
+        pool->parallelFor(0, rangeBase.back(), SKINNING_TASK_SIZE, task);
+    else
+        task(0, rangeBase.back());
+}
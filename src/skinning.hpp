@@ -0,0 +1,246 @@
+#ifndef SKINNING_HPP
+#define SKINNING_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <assimp/matrix4x4.h>
+
+struct Vertex;
+struct BoneInfo;
+class ThreadPool;
+
+/**
+ * @brief Quantidade máxima de vértices em cada tarefa de skinning paralelo.
+ */
+const size_t SKINNING_TASK_SIZE = 4096;
+
+/**
+ * @brief Quantidade de floats de cada matriz da paleta de skinning.
+ *
+ * Cada bone ocupa 4 colunas de 4 floats (x, y, z, 0) da matriz 3x4 final, o que permite
+ * carregar uma coluna inteira em um registrador SIMD.
+ */
+const size_t SKINNING_PALETTE_STRIDE = 16;
+
+/**
+ * @brief Kernels de skinning disponíveis.
+ */
+enum class SkinningKernel
+{
+    Scalar, ///< Implementação escalar portátil.
+    SSE2,   ///< Vetorizado com SSE2 (4 floats por registrador).
+    AVX2    ///< Vetorizado com AVX2 + FMA (2 vértices por iteração).
+};
+
+/**
+ * @brief Onde o skinning é executado.
+ */
+enum class SkinningMode
+{
+    CPU, ///< Kernels SoA na CPU, com as posições enviadas ao anel de buffers a cada quadro.
+    GPU  ///< Vertex shader com a paleta de matrizes em um texture buffer.
+};
+
+/**
+ * @brief Formatos das influências compactadas nos streams de skinning.
+ */
+enum class InfluenceFormat
+{
+    Unorm8, ///< Índices uint8 e pesos unorm8 (até 255 bones), 8 bytes por vértice.
+    Unorm16 ///< Índices uint16 e pesos unorm16, 16 bytes por vértice.
+};
+
+/**
+ * @brief Formatos das posições da bind pose nos streams de skinning e das UVs nos buffers de vértices.
+ */
+enum class VertexFormat
+{
+    Float,    ///< Posições e UVs em float (12 + 8 bytes por vértice).
+    Quantized ///< Posições em 16 bits relativas à AABB do submesh e UVs em half float (6 + 4 bytes por vértice).
+};
+
+/**
+ * @brief Dados de skinning de um submesh em estrutura de arrays (SoA).
+ *
+ * No formato quantizado cada coordenada é decodificada como positionOffset + q * positionScale.
+ *
+ * As influências de cada vértice ficam compactadas em 4 índices seguidos de 4 pesos normalizados
+ * (unorm), cuja soma é exatamente o valor máximo do tipo. Influências não usadas possuem peso 0.
+ * Vértices sem nenhuma influência apontam para a matriz identidade no fim da paleta com peso 1, de
+ * forma que o kernel não precisa de desvios por vértice.
+ */
+struct SkinningStreams
+{
+    VertexFormat vertexFormat;        ///< Formato das posições.
+    std::vector<float> x, y, z;       ///< Posições na bind pose (formato Float).
+    std::vector<uint16_t> qx, qy, qz; ///< Posições na bind pose quantizadas na AABB (formato Quantized).
+    float positionOffset[3];          ///< Canto mínimo da AABB do submesh.
+    float positionScale[3];           ///< Tamanho da AABB dividido por 65535.
+    InfluenceFormat influenceFormat;  ///< Tamanho dos índices e pesos em influences.
+    std::vector<uint8_t> influences;  ///< Índices e pesos de cada vértice, no formato influenceFormat.
+
+    /**
+     * @brief Quantidade de vértices nos streams.
+     */
+    size_t size() const { return vertexFormat == VertexFormat::Float ? x.size() : qx.size(); }
+
+    /**
+     * @brief Bytes ocupados por vértice (posição e influências).
+     */
+    size_t vertexBytes() const { return (vertexFormat == VertexFormat::Float ? 12 : 6) + influenceStride(); }
+
+    /**
+     * @brief Posição decodificada de um vértice na bind pose.
+     */
+    void position(size_t vertex, float &px, float &py, float &pz) const
+    {
+        if (vertexFormat == VertexFormat::Float)
+        {
+            px = x[vertex];
+            py = y[vertex];
+            pz = z[vertex];
+            return;
+        }
+        px = positionOffset[0] + qx[vertex] * positionScale[0];
+        py = positionOffset[1] + qy[vertex] * positionScale[1];
+        pz = positionOffset[2] + qz[vertex] * positionScale[2];
+    }
+
+    /**
+     * @brief Bytes de influências por vértice.
+     */
+    size_t influenceStride() const { return influenceFormat == InfluenceFormat::Unorm8 ? 8 : 16; }
+
+    /**
+     * @brief Índice na paleta da influência k de um vértice.
+     */
+    int boneID(size_t vertex, int k) const
+    {
+        if (influenceFormat == InfluenceFormat::Unorm8)
+            return influences[vertex * 8 + k];
+        return reinterpret_cast<const uint16_t *>(influences.data())[vertex * 8 + k];
+    }
+
+    /**
+     * @brief Peso, entre 0 e 1, da influência k de um vértice.
+     */
+    float weight(size_t vertex, int k) const
+    {
+        if (influenceFormat == InfluenceFormat::Unorm8)
+            return influences[vertex * 8 + 4 + k] / 255.0f;
+        return reinterpret_cast<const uint16_t *>(influences.data())[vertex * 8 + 4 + k] / 65535.0f;
+    }
+};
+
+/**
+ * @brief Intervalo [begin, end) de vértices, numerados na ordem concatenada dos submeshes.
+ */
+struct VertexRange
+{
+    size_t begin; ///< Primeiro vértice do intervalo.
+    size_t end;   ///< Vértice seguinte ao último do intervalo.
+};
+
+/**
+ * @brief Escolhe o formato de influências mais compacto capaz de indexar a paleta.
+ * @param boneCount Quantidade de bones (a paleta possui boneCount + 1 matrizes).
+ */
+InfluenceFormat selectInfluenceFormat(size_t boneCount);
+
+/**
+ * @brief Converte vértices do formato intercalado (Vertex) para os streams de skinning.
+ *
+ * Os pesos de cada vértice são normalizados e quantizados de forma que somem exatamente 1. No
+ * formato quantizado, as posições são quantizadas na AABB dos vértices informados.
+ *
+ * @param vertices Vértices de origem.
+ * @param count Quantidade de vértices.
+ * @param identityBone Índice da matriz identidade na paleta (igual ao número de bones).
+ * @param format Formato das influências compactadas.
+ * @param vertexFormat Formato das posições.
+ * @param streams Streams preenchidos.
+ */
+void buildSkinningStreams(const Vertex *vertices, size_t count, int identityBone, InfluenceFormat format,
+                          VertexFormat vertexFormat, SkinningStreams &streams);
+
+/**
+ * @brief Converte um float para half float (IEEE 754 binário de 16 bits), com arredondamento para o mais próximo.
+ */
+uint16_t floatToHalf(float value);
+
+/**
+ * @brief Monta a paleta de skinning a partir das transformações finais dos bones.
+ * @param bones Bones com finalTransformation já atualizada.
+ * @param count Quantidade de bones.
+ * @param palette Paleta resultante, com uma identidade extra no índice count.
+ */
+void buildSkinningPalette(const BoneInfo *bones, size_t count, std::vector<float> &palette);
+
+/**
+ * @brief Monta a paleta de uma instância posicionada no mundo, com a transformação já aplicada a cada matriz.
+ * @param bones Bones com finalTransformation já atualizada.
+ * @param count Quantidade de bones.
+ * @param world Transformação da instância.
+ * @param palette Destino com espaço para (count + 1) * SKINNING_PALETTE_STRIDE floats; a última matriz é world.
+ */
+void buildSkinningPalette(const BoneInfo *bones, size_t count, const aiMatrix4x4 &world, float *palette);
+
+/**
+ * @brief Retorna o melhor kernel suportado pela CPU em execução.
+ */
+SkinningKernel detectSkinningKernel();
+
+/**
+ * @brief Retorna o nome legível de um kernel.
+ */
+const char *skinningKernelName(SkinningKernel kernel);
+
+/**
+ * @brief Aplica o skinning a um intervalo de vértices.
+ *
+ * Um kernel não suportado pela CPU em execução é substituído pelo melhor disponível.
+ *
+ * @param streams Streams de skinning do submesh.
+ * @param palette Paleta montada por buildSkinningPalette().
+ * @param begin Primeiro vértice do intervalo.
+ * @param end Vértice seguinte ao último do intervalo.
+ * @param out Posições resultantes (x, y, z por vértice), indexadas a partir do vértice 0.
+ * @param kernel Kernel a ser utilizado.
+ */
+void skinPositions(const SkinningStreams &streams, const float *palette, size_t begin, size_t end, float *out,
+                   SkinningKernel kernel);
+
+/**
+ * @brief Aplica o skinning a vários submeshes, dividindo os vértices em tarefas no pool de threads.
+ *
+ * Os vértices de todos os submeshes são tratados como um único intervalo, de forma que as tarefas
+ * tenham tamanho uniforme mesmo quando os submeshes são muito diferentes. A função só retorna
+ * depois que todas as tarefas terminam.
+ *
+ * @param pool Pool de threads (nullptr executa tudo na thread atual).
+ * @param streams Streams de cada submesh.
+ * @param palette Paleta montada por buildSkinningPalette().
+ * @param out Posições de todos os submeshes concatenados, na ordem de streams (x, y, z por vértice).
+ * @param kernel Kernel a ser utilizado.
+ */
+void skinAll(ThreadPool *pool, const std::vector<SkinningStreams> &streams, const float *palette, float *out,
+             SkinningKernel kernel);
+
+/**
+ * @brief Aplica o skinning somente aos intervalos informados, mantendo as demais posições de out.
+ *
+ * Os intervalos são tratados como um único espaço contínuo e divididos em tarefas de tamanho
+ * uniforme, da mesma forma que em skinAll().
+ *
+ * @param pool Pool de threads (nullptr executa tudo na thread atual).
+ * @param streams Streams de cada submesh.
+ * @param palette Paleta montada por buildSkinningPalette().
+ * @param ranges Intervalos ordenados e disjuntos, em vértices globais.
+ * @param out Posições de todos os submeshes concatenados, na ordem de streams (x, y, z por vértice).
+ * @param kernel Kernel a ser utilizado.
+ */
+void skinRanges(ThreadPool *pool, const std::vector<SkinningStreams> &streams, const float *palette,
+                const std::vector<VertexRange> &ranges, float *out, SkinningKernel kernel);
+
+#endif
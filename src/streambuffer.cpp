@@ -0,0 +1,147 @@
+#include "streambuffer.hpp"
+#include "renderstats.hpp"
+#include <iostream>
+
+StreamBuffer::StreamBuffer() : bufferID(0), regionSize(0), currentRegion(0), mapped(nullptr)
+{
+    for (int i = 0; i < REGION_COUNT; i++)
+        fences[i] = nullptr;
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    destroy();
+}
+
+bool StreamBuffer::create(size_t size)
+{
+    destroy();
+    regionSize = size;
+    currentRegion = REGION_COUNT - 1;
+    if (size == 0)
+        return true;
+
+    glGenBuffers(1, &bufferID);
+    glBindBuffer(GL_ARRAY_BUFFER, bufferID);
+
+    if (GLEW_ARB_buffer_storage)
+    {
+        // Armazenamento imutável mapeado uma única vez, durante toda a vida do buffer
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size * REGION_COUNT, nullptr, flags);
+        mapped = static_cast<unsigned char *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size * REGION_COUNT, flags));
+        if (!mapped)
+        {
+            std::cerr << "Erro ao mapear buffer de vértices persistente" << std::endl;
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            destroy();
+            return false;
+        }
+    }
+    else
+    {
+        // Sem buffer storage o buffer possui uma única região, renovada a cada quadro
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        staging.resize(size);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void StreamBuffer::destroy()
+{
+    for (int i = 0; i < REGION_COUNT; i++)
+    {
+        if (fences[i])
+            glDeleteSync(fences[i]);
+        fences[i] = nullptr;
+    }
+
+    if (bufferID)
+    {
+        if (mapped)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, bufferID);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &bufferID);
+    }
+
+    bufferID = 0;
+    mapped = nullptr;
+    staging.clear();
+}
+
+void *StreamBuffer::beginWrite()
+{
+    if (!mapped)
+        return staging.data();
+
+    currentRegion = (currentRegion + 1) % REGION_COUNT;
+
+    // Aguarda a GPU terminar de ler a região antes de sobrescrevê-la
+    GLsync &regionFence = fences[currentRegion];
+    if (regionFence)
+    {
+        GLenum result;
+        do
+        {
+            result = glClientWaitSync(regionFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            renderStats.glCalls++;
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        if (result != GL_ALREADY_SIGNALED)
+            renderStats.fenceWaits++;
+        glDeleteSync(regionFence);
+        regionFence = nullptr;
+        renderStats.glCalls++;
+    }
+
+    return mapped + currentRegion * regionSize;
+}
+
+void StreamBuffer::endWrite()
+{
+    if (mapped)
+        return;
+
+    // Orphaning: o driver fornece memória nova se a anterior ainda estiver em uso
+    glBindBuffer(GL_ARRAY_BUFFER, bufferID);
+    glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, regionSize, staging.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    renderStats.glCalls += 4;
+}
+
+void StreamBuffer::fence()
+{
+    if (!mapped)
+        return;
+
+    // A região pode ser desenhada de novo sem ser reescrita; vale apenas o fence mais recente
+    GLsync &regionFence = fences[currentRegion];
+    if (regionFence)
+    {
+        glDeleteSync(regionFence);
+        renderStats.glCalls++;
+    }
+    regionFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    renderStats.glCalls++;
+}
+
+GLuint StreamBuffer::buffer() const
+{
+    return bufferID;
+}
+
+size_t StreamBuffer::currentOffset() const
+{
+    return mapped ? currentRegion * regionSize : 0;
+}
+
+bool StreamBuffer::isPersistent() const
+{
+    return mapped != nullptr;
+}
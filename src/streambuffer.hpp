@@ -0,0 +1,91 @@
+#ifndef STREAMBUFFER_HPP
+#define STREAMBUFFER_HPP
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Buffer de vértices para dados reescritos a cada quadro, dividido em um anel de regiões.
+ *
+ * Com GL_ARB_buffer_storage o buffer é mapeado de forma persistente e coerente: a CPU escreve
+ * diretamente em uma região enquanto a GPU ainda lê as outras, e um fence por região garante que
+ * uma região só é reescrita depois que a GPU terminou de usá-la. Sem a extensão, os dados são
+ * preparados em memória comum e enviados com glBufferSubData após descartar o armazenamento anterior
+ * do buffer (orphaning).
+ *
+ * Os dados da última região escrita continuam válidos até o próximo beginWrite(), então a mesma
+ * região pode ser desenhada em vários quadros seguidos sem ser reescrita.
+ */
+class StreamBuffer
+{
+public:
+    static const int REGION_COUNT = 3; ///< Quantidade de regiões do anel (triple buffering).
+
+private:
+    GLuint bufferID;                    ///< Buffer OpenGL.
+    size_t regionSize;                  ///< Tamanho de cada região em bytes.
+    int currentRegion;                  ///< Região escrita no quadro atual.
+    unsigned char *mapped;              ///< Ponteiro persistente para o buffer (nullptr no modo de fallback).
+    GLsync fences[REGION_COUNT];        ///< Fence da última leitura de cada região pela GPU.
+    std::vector<unsigned char> staging; ///< Memória intermediária do modo de fallback.
+
+public:
+    /**
+     * @brief Construtor, não cria recursos OpenGL.
+     */
+    StreamBuffer();
+
+    /**
+     * @brief Destrutor, libera o buffer e os fences.
+     */
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    /**
+     * @brief Cria o buffer com REGION_COUNT regiões.
+     * @param size Tamanho de cada região em bytes.
+     * @return true se o buffer foi criado, false caso contrário.
+     */
+    bool create(size_t size);
+
+    /**
+     * @brief Libera o buffer e os fences.
+     */
+    void destroy();
+
+    /**
+     * @brief Avança para a próxima região, aguardando a GPU liberá-la, e retorna a memória para escrita.
+     * @return Ponteiro para regionSize bytes graváveis.
+     */
+    void *beginWrite();
+
+    /**
+     * @brief Conclui a escrita da região atual, enviando os dados no modo de fallback.
+     */
+    void endWrite();
+
+    /**
+     * @brief Registra um fence após os comandos de desenho que leem a região atual.
+     */
+    void fence();
+
+    /**
+     * @brief Retorna o buffer OpenGL.
+     */
+    GLuint buffer() const;
+
+    /**
+     * @brief Retorna o deslocamento em bytes da região atual dentro do buffer.
+     */
+    size_t currentOffset() const;
+
+    /**
+     * @brief Informa se o buffer usa mapeamento persistente.
+     */
+    bool isPersistent() const;
+};
+
+#endif
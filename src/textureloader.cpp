@@ -0,0 +1,130 @@
+#include "textureloader.hpp"
+#include "stb_image.h"
+#include <iostream>
+
+TextureLoader::TextureLoader(unsigned int workerCount)
+{
+    if (workerCount == 0)
+        workerCount = std::thread::hardware_concurrency();
+    if (workerCount == 0)
+        workerCount = 4;
+
+    for (unsigned int i = 0; i < workerCount; i++)
+        workers.emplace_back(&TextureLoader::workerLoop, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    pendingReady.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+
+    // Descarta imagens que nunca foram enviadas
+    for (Job *job : jobs)
+    {
+        stbi_image_free(job->data);
+        delete job;
+    }
+}
+
+GLuint TextureLoader::request(const std::string &path, bool flipVertically)
+{
+    // O nome da textura é reservado já na thread do contexto, para que possa ser associado aos objetos
+    Job *job = new Job{path, flipVertically, 0, nullptr, 0, 0};
+    glGenTextures(1, &job->textureID);
+    jobs.push_back(job);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(job);
+    }
+    pendingReady.notify_one();
+    return job->textureID;
+}
+
+void TextureLoader::workerLoop()
+{
+    for (;;)
+    {
+        Job *job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            pendingReady.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty())
+                return;
+            job = pending.front();
+            pending.pop_front();
+        }
+
+        // A orientação é definida por thread, sem interferir nas demais decodificações
+        int channels;
+        stbi_set_flip_vertically_on_load_thread(job->flipVertically);
+        job->data = stbi_load(job->path.c_str(), &job->width, &job->height, &channels, 4);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            decoded.push_back(job);
+        }
+        decodedReady.notify_one();
+    }
+}
+
+bool TextureLoader::upload(Job *job)
+{
+    if (!job->data)
+    {
+        std::cerr << "Erro ao carregar textura: " << job->path << std::endl;
+        return false;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, job->textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, job->width, job->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, job->data);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    stbi_image_free(job->data);
+    job->data = nullptr;
+    std::cout << "Textura carregada: " << job->path << std::endl;
+    return true;
+}
+
+bool TextureLoader::finish()
+{
+    bool success = true;
+    size_t remaining = jobs.size();
+
+    // Envia cada imagem assim que fica pronta, na ordem em que a decodificação termina
+    while (remaining > 0)
+    {
+        Job *job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            decodedReady.wait(lock, [this] { return !decoded.empty(); });
+            job = decoded.front();
+            decoded.pop_front();
+        }
+
+        bool ok = upload(job);
+        loaded[job->textureID] = ok;
+        success = success && ok;
+        remaining--;
+    }
+
+    for (Job *job : jobs)
+        delete job;
+    jobs.clear();
+    return success;
+}
+
+bool TextureLoader::isLoaded(GLuint textureID) const
+{
+    auto it = loaded.find(textureID);
+    return it != loaded.end() && it->second;
+}
@@ -0,0 +1,91 @@
+#ifndef TEXTURELOADER_HPP
+#define TEXTURELOADER_HPP
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Decodifica texturas em paralelo em um conjunto de threads de trabalho.
+ *
+ * As imagens são decodificadas pelas threads de trabalho, enquanto o envio para o OpenGL
+ * (glTexImage2D) acontece somente na thread que possui o contexto, dentro de finish().
+ */
+class TextureLoader
+{
+private:
+    struct Job
+    {
+        std::string path;           ///< Caminho da imagem.
+        bool flipVertically;        ///< Inverte a imagem verticalmente ao decodificar.
+        GLuint textureID;           ///< Nome da textura reservado no OpenGL.
+        unsigned char *data;        ///< Pixels RGBA decodificados (nullptr em caso de erro).
+        int width, height;          ///< Dimensões da imagem decodificada.
+    };
+
+    std::vector<std::thread> workers;       ///< Threads que decodificam as imagens.
+    std::deque<Job *> pending;              ///< Imagens aguardando decodificação.
+    std::deque<Job *> decoded;              ///< Imagens decodificadas aguardando envio ao OpenGL.
+    std::vector<Job *> jobs;                ///< Todas as imagens solicitadas e ainda não enviadas.
+    std::map<GLuint, bool> loaded;          ///< Resultado do envio de cada textura.
+    std::mutex mutex;                       ///< Protege as filas.
+    std::condition_variable pendingReady;   ///< Sinaliza novas imagens a decodificar.
+    std::condition_variable decodedReady;   ///< Sinaliza imagens prontas para envio.
+    bool stopping = false;                  ///< Indica que as threads devem terminar.
+
+public:
+    /**
+     * @brief Construtor, inicia as threads de trabalho.
+     * @param workerCount Número de threads (0 usa o número de núcleos disponíveis).
+     */
+    explicit TextureLoader(unsigned int workerCount = 0);
+
+    /**
+     * @brief Destrutor, encerra as threads e descarta imagens não enviadas.
+     */
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader &) = delete;
+    TextureLoader &operator=(const TextureLoader &) = delete;
+
+    /**
+     * @brief Agenda a decodificação de uma textura. Deve ser chamado na thread do contexto OpenGL.
+     * @param path Caminho da imagem.
+     * @param flipVertically true para inverter a imagem verticalmente.
+     * @return GLuint Nome da textura reservado, válido para uso após finish().
+     */
+    GLuint request(const std::string &path, bool flipVertically);
+
+    /**
+     * @brief Envia as texturas ao OpenGL à medida que são decodificadas, até que todas estejam prontas.
+     * @return true se todas as texturas foram carregadas, false se alguma falhou.
+     */
+    bool finish();
+
+    /**
+     * @brief Informa se uma textura solicitada foi decodificada e enviada com sucesso.
+     * @param textureID Nome retornado por request().
+     * @return true se a textura foi carregada, false caso contrário.
+     */
+    bool isLoaded(GLuint textureID) const;
+
+private:
+    /**
+     * @brief Laço das threads de trabalho: decodifica as imagens pendentes.
+     */
+    void workerLoop();
+
+    /**
+     * @brief Envia uma imagem decodificada para a textura reservada e libera os pixels.
+     * @param job Imagem a ser enviada.
+     * @return true se a imagem foi enviada, false se a decodificação falhou.
+     */
+    bool upload(Job *job);
+};
+
+#endif
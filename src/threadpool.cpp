@@ -0,0 +1,132 @@
+#include "threadpool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount) : queuedTasks(0), unfinishedTasks(0), stopping(false)
+{
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0)
+        threadCount = 1;
+
+    // A fila 0 pertence à thread que chama parallelFor()
+    for (unsigned int i = 0; i < threadCount; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (unsigned int i = 1; i < threadCount; i++)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+unsigned int ThreadPool::size() const
+{
+    return queues.size();
+}
+
+bool ThreadPool::takeTask(size_t index, Task &task)
+{
+    // Primeiro a própria fila, pelo fim (tarefas mais recentes)
+    {
+        Queue &own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            queuedTasks--;
+            return true;
+        }
+    }
+
+    // Depois rouba do início das filas das outras threads
+    for (size_t i = 1; i < queues.size(); i++)
+    {
+        Queue &victim = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            queuedTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(const Task &task)
+{
+    (*task.fn)(task.begin, task.end);
+    unfinishedTasks--;
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    for (;;)
+    {
+        Task task;
+        if (takeTask(index, task))
+        {
+            runTask(task);
+            continue;
+        }
+
+        // Sem tarefas disponíveis: dorme até um novo parallelFor ou o encerramento
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping)
+            return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &fn)
+{
+    if (begin >= end)
+        return;
+    if (grain == 0)
+        grain = 1;
+
+    // Sem threads de trabalho ou com uma única tarefa, executa diretamente
+    size_t taskCount = (end - begin + grain - 1) / grain;
+    if (workers.empty() || taskCount == 1)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    // Distribui as tarefas em blocos contíguos entre as filas, para que cada thread comece
+    // com uma região própria e só roube quando terminar a sua
+    unfinishedTasks = taskCount;
+    {
+        // O contador é atualizado antes das filas para nunca ficar abaixo das tarefas realmente enfileiradas
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedTasks += taskCount;
+    }
+    size_t perQueue = (taskCount + queues.size() - 1) / queues.size();
+    for (size_t t = 0; t < taskCount; t++)
+    {
+        Task task{&fn, begin + t * grain, std::min(end, begin + (t + 1) * grain)};
+        Queue &queue = *queues[t / perQueue];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+    wake.notify_all();
+
+    // A thread chamadora também trabalha e só retorna quando todas as tarefas terminarem
+    Task task;
+    while (unfinishedTasks > 0)
+    {
+        if (takeTask(0, task))
+            runTask(task);
+        else
+            std::this_thread::yield();
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pool persistente de threads com roubo de tarefas (work stealing).
+ *
+ * Cada thread possui sua própria fila: consome as tarefas do fim da sua fila e, quando ela
+ * esvazia, rouba do início das filas das outras threads. A thread que chama parallelFor()
+ * também executa tarefas até que todas terminem.
+ */
+class ThreadPool
+{
+private:
+    struct Task
+    {
+        const std::function<void(size_t, size_t)> *fn; ///< Função a ser executada.
+        size_t begin, end;                             ///< Intervalo processado pela tarefa.
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;       ///< Protege a fila.
+        std::deque<Task> tasks; ///< Tarefas pendentes desta thread.
+    };
+
+    std::vector<std::thread> workers;           ///< Threads de trabalho (a thread chamadora é a fila 0).
+    std::vector<std::unique_ptr<Queue>> queues; ///< Uma fila por thread participante.
+    std::atomic<size_t> queuedTasks;            ///< Tarefas ainda nas filas.
+    std::atomic<size_t> unfinishedTasks;        ///< Tarefas do parallelFor atual ainda não concluídas.
+    std::mutex sleepMutex;                      ///< Protege a espera das threads ociosas.
+    std::condition_variable wake;               ///< Acorda as threads quando há tarefas.
+    bool stopping;                              ///< Indica que as threads devem terminar.
+
+public:
+    /**
+     * @brief Construtor, inicia as threads de trabalho.
+     * @param threadCount Número total de threads, incluindo a chamadora (0 usa o número de núcleos).
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+
+    /**
+     * @brief Destrutor, encerra as threads de trabalho.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Número total de threads que executam tarefas, incluindo a chamadora.
+     */
+    unsigned int size() const;
+
+    /**
+     * @brief Divide um intervalo em tarefas, executa-as no pool e aguarda todas terminarem.
+     *
+     * Deve ser chamado por uma única thread por vez e não pode ser aninhado.
+     *
+     * @param begin Início do intervalo.
+     * @param end Fim do intervalo (exclusivo).
+     * @param grain Tamanho máximo de cada tarefa.
+     * @param fn Função chamada com o subintervalo [início, fim) de cada tarefa.
+     */
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &fn);
+
+private:
+    /**
+     * @brief Laço das threads de trabalho.
+     * @param index Índice da fila da thread.
+     */
+    void workerLoop(size_t index);
+
+    /**
+     * @brief Obtém uma tarefa da própria fila ou, se estiver vazia, rouba de outra.
+     * @param index Índice da fila da thread.
+     * @param task Tarefa obtida.
+     * @return true se alguma tarefa foi obtida.
+     */
+    bool takeTask(size_t index, Task &task);
+
+    /**
+     * @brief Executa uma tarefa e registra sua conclusão.
+     */
+    void runTask(const Task &task);
+};
+
+#endif